@@ -165,6 +165,7 @@ cdef extern from "mata/nfa.hh" namespace "Mata::Nfa":
         void defragment()
         void add(CTrans) except +
         void add(State, Symbol, State) except +
+        void add_bulk(vector[CTrans]) except +
         void remove(CTrans) except +
         void remove(State, Symbol, State) except +
         bool contains(State, Symbol, State)
@@ -193,16 +194,30 @@ cdef extern from "mata/nfa.hh" namespace "Mata::Nfa":
 
     ctypedef vector[CTrans] TransitionSequence
 
+    cdef cppclass TargetSet "Mata::Nfa::TargetSet":
+        TargetSet() except+
+        TargetSet(vector[State]) except+
+        size_t size()
+        bool empty()
+
+        cppclass const_iterator:
+            const State operator *()
+            const_iterator operator++()
+            bint operator ==(const_iterator)
+            bint operator !=(const_iterator)
+        const_iterator cbegin()
+        const_iterator cend()
+
     cdef cppclass CMove "Mata::Nfa::Move":
         # Public Attributes
         Symbol symbol
-        StateSet targets
+        TargetSet targets
 
         # Constructors
         CMove() except +
         CMove(Symbol) except +
         CMove(Symbol, State) except +
-        CMove(Symbol, StateSet) except +
+        CMove(Symbol, TargetSet) except +
 
         bool operator<(CMove)
         bool operator<=(CMove)
@@ -323,7 +338,7 @@ cdef extern from "mata/nfa-plumbing.hh" namespace "Mata::Nfa::Plumbing":
     cdef void make_complete(CNfa*, CAlphabet&, State) except +
     cdef void revert(CNfa*, CNfa&)
     cdef void remove_epsilon(CNfa*, CNfa&, Symbol) except +
-    cdef void minimize(CNfa*, CNfa&)
+    cdef void minimize(CNfa*, CNfa&, StringMap&) except +
     cdef void reduce(CNfa*, CNfa&, StateToStateMap*, StringMap&)
 
 
@@ -347,6 +362,17 @@ cdef extern from "mata/nfa-strings.hh" namespace "Mata::Strings::SegNfa":
     cdef NoodleSequence noodlify_for_equation(const AutPtrSequence&, CNfa&, bool, StringMap&)
 
 
+cdef extern from "mata/nfa-bit-parallel.hh" namespace "Mata::Nfa":
+    cdef cppclass CBitParallelMatcher "Mata::Nfa::BitParallelMatcher":
+        CBitParallelMatcher(CNfa&) except +
+
+        bool is_in_lang(CRun&)
+        bool is_prfx_in_lang(CRun&)
+        size_t num_of_states()
+        size_t num_of_symbol_classes()
+        bool is_shift_and()
+
+
 cdef extern from "mata/re2parser.hh" namespace "Mata::RE2Parser":
     cdef void create_nfa(CNfa*, string) except +
     cdef void create_nfa(CNfa*, string, bool) except +
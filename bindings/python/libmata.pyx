@@ -134,16 +134,15 @@ cdef class Move:
 
     @property
     def targets(self):
-        cdef vector[State] states_as_vector = self.thisptr.targets.ToVector()
-        return [s for s in states_as_vector]
+        return target_set_to_vector(self.thisptr.targets)
 
     @targets.setter
     def targets(self, value):
-        cdef StateSet targets = StateSet(value)
+        cdef TargetSet targets = TargetSet(<vector[State]> value)
         self.thisptr.targets = targets
 
     def __cinit__(self, Symbol symbol, vector[State] states):
-        cdef StateSet targets = StateSet(states)
+        cdef TargetSet targets = TargetSet(states)
         self.thisptr = new mata.CMove(symbol, targets)
 
     def __dealloc__(self):
@@ -351,6 +350,26 @@ cdef class Nfa:
         else:
             self.thisptr.get().delta.add(src, symb, tgt)
 
+    def add_transitions(self, transitions, Alphabet alphabet = None):
+        """Adds transitions to automaton at once, which is much faster than adding them one by one
+
+        :param transitions: iterable of transitions given as Trans objects or triples (source, symbol, target)
+        :param Alphabet alphabet: alphabet of the transitions with string symbols
+        """
+        cdef vector[mata.CTrans] c_transitions
+        for transition in transitions:
+            if isinstance(transition, Trans):
+                c_transitions.push_back(dereference((<Trans>transition).thisptr))
+                continue
+            src, symb, tgt = transition
+            if isinstance(symb, str):
+                alphabet = alphabet or store().get('alphabet')
+                if not alphabet:
+                    raise Exception(f"Cannot translate symbol '{symb}' without specified alphabet")
+                symb = alphabet.translate_symbol(symb)
+            c_transitions.push_back(mata.CTrans(src, symb, tgt))
+        self.thisptr.get().delta.add_bulk(c_transitions)
+
     def remove_trans(self, Trans tr):
         """Removes transition from the automaton.
 
@@ -440,7 +459,7 @@ cdef class Nfa:
         while it != end:
             t = Move(
                 dereference(it).symbol,
-                dereference(it).targets.ToVector()
+                target_set_to_vector(dereference(it).targets)
             )
             postinc(it)
             transsymbols.append(t)
@@ -972,18 +991,27 @@ cdef class Nfa:
             return None
 
         cdef CMove epsilon_transitions = dereference(c_epsilon_transitions_iter)
-        return Move(epsilon_transitions.symbol, epsilon_transitions.targets.ToVector())
+        return Move(epsilon_transitions.symbol, target_set_to_vector(epsilon_transitions.targets))
 
 
     @classmethod
-    def minimize(cls, Nfa lhs):
+    def minimize(cls, Nfa lhs, params = None):
         """Minimizes the automaton lhs
 
         :param Nfa lhs: automaton to be minimized
+        :param dict params: additional params ('algo': 'brzozowski' or 'hopcroft'; chosen automatically if unset)
         :return: minimized automaton
         """
         result = Nfa()
-        mata.minimize(result.thisptr.get(), dereference(lhs.thisptr.get()))
+        params = params or {}
+        mata.minimize(
+            result.thisptr.get(),
+            dereference(lhs.thisptr.get()),
+            {
+                k.encode('utf-8'): v.encode('utf-8') if isinstance(v, str) else v
+                for k, v in params.items()
+            }
+        )
         return result
 
     @classmethod
@@ -1557,6 +1585,21 @@ cdef class BinaryRelation:
         return str(tabulate.tabulate(self.to_matrix()))
 
 
+cdef vector[State] target_set_to_vector(const TargetSet& targets):
+    """Helper function that translates the set of targets of a move to a vector
+
+    :param TargetSet targets: targets of a move
+    :return: targets as vector
+    """
+    cdef vector[State] result
+    result.reserve(targets.size())
+    cdef TargetSet.const_iterator it = targets.cbegin()
+    while it != targets.cend():
+        result.push_back(dereference(it))
+        preinc(it)
+    return result
+
+
 cdef subset_map_to_dictionary(umap[StateSet, State] subset_map):
     """Helper function that translates the unordered map to dictionary
 
@@ -1715,6 +1758,48 @@ cdef class Segmentation:
         return segments
 
 
+cdef class BitParallelMatcher:
+    """Wrapper over BitParallelMatcher, matching words with automata of at most 512 states."""
+    cdef mata.CBitParallelMatcher* thisptr
+
+    def __cinit__(self, Nfa aut):
+        """Compile the matcher.
+
+        :param Nfa aut: automaton to match words with
+        """
+        self.thisptr = new mata.CBitParallelMatcher(dereference(aut.thisptr.get()))
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def is_in_lang(self, vector[Symbol] word):
+        """Tests if word is in language
+
+        :param vector[Symbol] word: tested word (e.g., bytes)
+        :return: true if word is in language of the automaton
+        """
+        run = Run()
+        run.thisptr.word = word
+        return self.thisptr.is_in_lang(dereference(run.thisptr))
+
+    def is_prefix_in_lang(self, vector[Symbol] word):
+        """Test if any prefix of the word is in the language
+
+        :param vector[Symbol] word: tested word (e.g., bytes)
+        :return: true if any prefix of word is in language of the automaton
+        """
+        run = Run()
+        run.thisptr.word = word
+        return self.thisptr.is_prfx_in_lang(dereference(run.thisptr))
+
+    def get_num_of_states(self):
+        return self.thisptr.num_of_states()
+
+    def is_shift_and(self):
+        """Is the automaton simulated as in Shift-And?"""
+        return self.thisptr.is_shift_and()
+
+
 def plot(
         *automata: Nfa,
         with_scc: bool = False,
@@ -187,6 +187,17 @@ def test_transitions():
     assert [t for t in lhs.iterate()] == [t1, t2, t3, t4]
 
 
+def test_add_transitions():
+    """Test adding transitions to automaton at once"""
+    lhs = mata.Nfa(3)
+    lhs.add_transition(0, 1, 0)
+    lhs.add_transitions([(2, 2, 2), mata.Trans(0, 0, 0), (0, 1, 1), (0, 0, 0)])
+
+    assert [t for t in lhs.iterate()] == [
+        mata.Trans(0, 0, 0), mata.Trans(0, 1, 0), mata.Trans(0, 1, 1), mata.Trans(2, 2, 2)
+    ]
+
+
 def test_post(binary_alphabet):
     """Test various cases of getting post of the states
     :return:
@@ -921,6 +932,27 @@ def test_segmentation(prepare_automaton_a):
     assert mata.Trans(7, epsilon, 8) in epsilon_depths[2]
 
 
+def test_bit_parallel_matcher():
+    nfa = mata.Nfa(4)
+    nfa.make_initial_state(0)
+    nfa.make_final_state(3)
+    nfa.add_transition(0, ord('a'), 1)
+    nfa.add_transition(1, ord('b'), 2)
+    nfa.add_transition(2, ord('b'), 2)
+    nfa.add_transition(2, ord('c'), 3)
+
+    matcher = mata.BitParallelMatcher(nfa)
+    assert matcher.get_num_of_states() == 4
+    assert matcher.is_shift_and()
+    assert matcher.is_in_lang(b"abbc")
+    assert not matcher.is_in_lang(b"abbcx")
+    assert matcher.is_prefix_in_lang(b"abbcx")
+    assert not matcher.is_prefix_in_lang(b"ac")
+
+    with pytest.raises(Exception):
+        mata.BitParallelMatcher(mata.Nfa(513))
+
+
 def test_reduce():
     """Test reducing the automaton."""
     nfa = mata.Nfa()
@@ -0,0 +1,276 @@
+/* antichain.hh -- indexed antichain of (key, set) pairs
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_ANTICHAIN_HH_
+#define MATA_ANTICHAIN_HH_
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <mata/flat-hash-map.hh>
+#include <mata/set-kernels.hh>
+
+namespace Mata {
+namespace Util {
+
+/// Subset order on sets, the default order of an @c Antichain.
+struct SubsetOrder {
+    /// Sets are compared only by the subset relation, so smaller sets have smaller or equal cardinalities.
+    static constexpr bool IS_SUBSET{ true };
+
+    /// Check whether the set [@p lhs, @p lhs + @p lhs_size) is a subset of the set [@p rhs, @p rhs + @p rhs_size).
+    template<typename Number>
+    bool operator()(const Number* lhs, size_t lhs_size, const Number* rhs, size_t rhs_size) const {
+        return SetKernels::is_subset(lhs, lhs_size, rhs, rhs_size);
+    }
+}; // struct SubsetOrder.
+
+/**
+ * @brief Order on sets lifting a preorder @p Relation on numbers: S <= T iff every number of S is related to some
+ *  number of T.
+ *
+ * For a simulation relation on states, S <= T implies that the language of the macrostate S is included in the
+ *  language of the macrostate T.
+ * @tparam Relation Reflexive binary predicate on numbers.
+ */
+template<typename Relation>
+class ForallExistsOrder {
+public:
+    static constexpr bool IS_SUBSET{ false };
+
+    explicit ForallExistsOrder(Relation relation) : relation_{ std::move(relation) } {}
+
+    template<typename Number>
+    bool operator()(const Number* lhs, size_t lhs_size, const Number* rhs, size_t rhs_size) const {
+        return std::all_of(lhs, lhs + lhs_size, [&](const Number lhs_number) {
+            return std::any_of(rhs, rhs + rhs_size, [&](const Number rhs_number) {
+                return relation_(lhs_number, rhs_number);
+            });
+        });
+    }
+
+private:
+    Relation relation_;
+}; // class ForallExistsOrder.
+
+/**
+ * @brief Antichain of pairs (key, set) ordered by (k1, s1) <= (k2, s2) iff k1 == k2 and s1 <= s2 in the order of sets
+ *  (the subset relation by default).
+ *
+ * Elements are bucketed by keys and, inside a bucket, by cardinalities of their sets, so that subsumption queries
+ *  only visit elements with the same key and a compatible cardinality. Each element carries a 64-bit Bloom
+ *  signature of its set which rejects most of the non-subsets without looking at the sets themselves. Sets are
+ *  interned in a @c MacrostateTable, so a set shared by elements with different keys (e.g., the same macrostate of
+ *  the bigger automaton paired with several states of the smaller one) is stored only once.
+ *
+ * Sets can be ordered by a coarser preorder than the subset relation (@p Order), e.g., by @c ForallExistsOrder
+ *  lifting a simulation. Cardinalities and signatures then only serve to accept subsets quickly, all elements with
+ *  the same key are compared by the order otherwise.
+ *
+ * Elements are identified by ids which stay valid after the element is removed from the antichain (the element is
+ *  only marked as dead). Algorithms can therefore keep ids in their worklists and skip dead ones lazily, and
+ *  reconstruct counterexamples through ids of removed elements.
+ *
+ * @tparam Key Hashable key of elements (e.g., a state of the smaller automaton in inclusion checking).
+ * @tparam Set @c OrdVector of numbers (e.g., @c StateSet).
+ * @tparam Order Preorder on sets containing the subset relation (see @c SubsetOrder).
+ */
+template<typename Key, typename Set, typename Order = SubsetOrder>
+class Antichain {
+public:
+    using ElementId = size_t;
+    using Number = typename Set::value_type;
+    using SetTable = MacrostateTable<Number>;
+
+    explicit Antichain(Order order = Order{}) : order_{ std::move(order) } {}
+
+    /**
+     * Check whether an element (@p key, S) with S smaller than or equal to the set [@p first, @p last) is stored in the
+     *  antichain.
+     *
+     * Functions taking a set as a sorted range of distinct numbers allow to query and insert sets (e.g., images of
+     *  macrostates computed into a buffer) without constructing a @c Set.
+     */
+    bool is_subsumed(const Key& key, const Number* first, const Number* last) const {
+        const auto bucket_it{ buckets_.find(key) };
+        if (bucket_it == buckets_.end()) { return false; }
+        const Bucket& bucket{ bucket_it->second };
+        const size_t size{ static_cast<size_t>(last - first) };
+        const uint64_t signature{ compute_signature(first, last) };
+        for (auto group{ bucket.begin() }; group != bucket.end(); ++group) {
+            if (Order::IS_SUBSET && group->card > size) { break; }
+            for (const ElementId id: group->ids) {
+                const Element& elem{ elements_[id] };
+                if (((elem.signature & ~signature) == 0
+                     && SetKernels::is_subset(elem.data, group->card, first, size))
+                    || (!Order::IS_SUBSET && order_(elem.data, group->card, first, size))) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool is_subsumed(const Key& key, const Set& set) const {
+        const std::vector<Number>& vec{ set.ToVector() };
+        return is_subsumed(key, vec.data(), vec.data() + vec.size());
+    }
+
+    /**
+     * Remove all elements (@p key, S) with S greater than or equal to the set [@p first, @p last) from the antichain.
+     * @return Number of removed elements.
+     */
+    size_t remove_subsumed(const Key& key, const Number* first, const Number* last) {
+        const auto bucket_it{ buckets_.find(key) };
+        if (bucket_it == buckets_.end()) { return 0; }
+        Bucket& bucket{ bucket_it->second };
+        const size_t size{ static_cast<size_t>(last - first) };
+        const uint64_t signature{ compute_signature(first, last) };
+        size_t removed{ 0 };
+        for (auto group{ Order::IS_SUBSET ? find_group(bucket, size) : bucket.begin() }; group != bucket.end();
+             ++group) {
+            std::vector<ElementId>& ids{ group->ids };
+            const auto new_end{ std::remove_if(ids.begin(), ids.end(), [&](ElementId id) {
+                Element& elem{ elements_[id] };
+                if (((signature & ~elem.signature) == 0
+                     && SetKernels::is_subset(first, size, elem.data, group->card))
+                    || (!Order::IS_SUBSET && order_(first, size, elem.data, group->card))) {
+                    elem.alive = false;
+                    return true;
+                }
+                return false;
+            }) };
+            removed += static_cast<size_t>(ids.end() - new_end);
+            ids.erase(new_end, ids.end());
+        }
+        size_ -= removed;
+        return removed;
+    }
+
+    size_t remove_subsumed(const Key& key, const Set& set) {
+        const std::vector<Number>& vec{ set.ToVector() };
+        return remove_subsumed(key, vec.data(), vec.data() + vec.size());
+    }
+
+    /**
+     * Insert element (@p key, [@p first, @p last)) without checking subsumption.
+     * @return Id of the new element.
+     */
+    ElementId insert(const Key& key, const Number* first, const Number* last) {
+        const ElementId id{ elements_.size() };
+        const typename SetTable::Id set_id{ sets_.intern(first, last).first };
+        elements_.push_back({ compute_signature(first, last), sets_.begin(set_id), set_id, true, key });
+        const size_t size{ static_cast<size_t>(last - first) };
+        Bucket& bucket{ buckets_[key] };
+        auto group{ find_group(bucket, size) };
+        if (group == bucket.end() || group->card != size) {
+            group = bucket.insert(group, { size, {} });
+        }
+        group->ids.push_back(id);
+        ++size_;
+        return id;
+    }
+
+    ElementId insert(const Key& key, const Set& set) {
+        const std::vector<Number>& vec{ set.ToVector() };
+        return insert(key, vec.data(), vec.data() + vec.size());
+    }
+
+    /**
+     * Insert element (@p key, [@p first, @p last)) unless it is subsumed by an element of the antichain. Elements
+     *  subsumed by the new element are removed.
+     * @return Pair of the id of the new element and whether the element was inserted.
+     */
+    std::pair<ElementId, bool> insert_if_not_subsumed(const Key& key, const Number* first, const Number* last) {
+        if (is_subsumed(key, first, last)) { return { elements_.size(), false }; }
+        remove_subsumed(key, first, last);
+        return { insert(key, first, last), true };
+    }
+
+    std::pair<ElementId, bool> insert_if_not_subsumed(const Key& key, const Set& set) {
+        const std::vector<Number>& vec{ set.ToVector() };
+        return insert_if_not_subsumed(key, vec.data(), vec.data() + vec.size());
+    }
+
+    /// Check whether element @p id is still in the antichain.
+    bool is_alive(ElementId id) const { return elements_[id].alive; }
+    const Key& get_key(ElementId id) const { return elements_[id].key; }
+    Set get_set(ElementId id) const { return sets_.get_set(elements_[id].set); }
+    /// Numbers of the set of element @p id. The pointers stay valid until the antichain is cleared.
+    const Number* set_begin(ElementId id) const { return elements_[id].data; }
+    const Number* set_end(ElementId id) const { return sets_.end(elements_[id].set); }
+
+    /// Number of elements in the antichain.
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    void clear() {
+        elements_.clear();
+        sets_.clear();
+        buckets_.clear();
+        size_ = 0;
+    }
+
+private:
+    /// Members are ordered so that the 32-bit id of the set, the flag and small keys share a word.
+    struct Element {
+        uint64_t signature; ///< Bloom signature of the set.
+        const Number* data; ///< Numbers of the set in the table, kept here to save a lookup in subsumption checks.
+        typename SetTable::Id set; ///< Id of the set in the table of sets.
+        bool alive;
+        Key key;
+    };
+
+    /// Ids of elements with the same key whose sets have the cardinality @c card.
+    struct CardinalityGroup {
+        size_t card;
+        std::vector<ElementId> ids;
+    };
+
+    /// Groups of elements with the same key sorted by cardinalities. Only cardinalities of inserted sets have a
+    ///  group, so that a key with a few large sets (common in inclusion checking) does not pay for empty groups.
+    using Bucket = std::vector<CardinalityGroup>;
+
+    Order order_;
+    std::vector<Element> elements_{};
+    SetTable sets_{};
+    std::unordered_map<Key, Bucket> buckets_{};
+    size_t size_{ 0 };
+
+    /// First group of @p bucket with cardinality at least @p card.
+    static typename Bucket::iterator find_group(Bucket& bucket, size_t card) {
+        return std::lower_bound(bucket.begin(), bucket.end(), card,
+                                [](const CardinalityGroup& group, size_t value) { return group.card < value; });
+    }
+
+    static uint64_t compute_signature(const Number* first, const Number* last) {
+        uint64_t signature{ 0 };
+        for (; first != last; ++first) {
+            // Fibonacci hashing to spread consecutive numbers over the signature.
+            signature |= uint64_t{ 1 } << ((static_cast<uint64_t>(*first) * 0x9E3779B97F4A7C15ULL) >> 58);
+        }
+        return signature;
+    }
+}; // class Antichain.
+
+} // namespace Util.
+} // namespace Mata.
+
+#endif // MATA_ANTICHAIN_HH_
@@ -0,0 +1,52 @@
+/* bits.hh -- operations on bits of 64-bit words used by bitsets
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_BITS_HH_
+#define MATA_BITS_HH_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Mata {
+namespace Util {
+
+/// Number of set bits of @p word.
+inline size_t count_bits(uint64_t word) {
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_popcountll(word));
+#else
+    size_t count = 0;
+    for (; word != 0; word &= word - 1) { ++count; }
+    return count;
+#endif
+}
+
+/// Index of the lowest set bit of @p word, which must not be zero.
+inline size_t lowest_bit(uint64_t word) {
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_ctzll(word));
+#else
+    size_t index = 0;
+    for (; (word & 1) == 0; word >>= 1) { ++index; }
+    return index;
+#endif
+}
+
+} // namespace Util.
+} // namespace Mata.
+
+#endif // MATA_BITS_HH_
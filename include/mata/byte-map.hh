@@ -0,0 +1,42 @@
+/* byte-map.hh -- translation of bytes of inputs to symbols for matchers of byte strings
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_BYTE_MAP_HH_
+#define MATA_BYTE_MAP_HH_
+
+#include <array>
+#include <cstddef>
+
+#include <mata/nfa.hh>
+
+namespace Mata {
+namespace Nfa {
+
+/// Symbols of bytes of inputs given as bytes (e.g., @c std::string_view).
+using ByteMap = std::array<Symbol, 256>;
+
+/// Byte map translating every byte to the symbol of the same value.
+inline ByteMap identity_byte_map() {
+    ByteMap byte_map{};
+    for (size_t byte{ 0 }; byte < byte_map.size(); ++byte) { byte_map[byte] = static_cast<Symbol>(byte); }
+    return byte_map;
+}
+
+} // namespace Nfa.
+} // namespace Mata.
+
+#endif // MATA_BYTE_MAP_HH_
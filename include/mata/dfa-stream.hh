@@ -0,0 +1,130 @@
+/* dfa-stream.hh -- resumable matching of byte streams arriving in chunks
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_DFA_STREAM_HH_
+#define MATA_DFA_STREAM_HH_
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <mata/nfa.hh>
+#include <mata/byte-map.hh>
+#include <mata/dfa.hh>
+
+namespace Mata {
+namespace Dfa {
+
+using ByteMap = Mata::Nfa::ByteMap;
+using Mata::Nfa::identity_byte_map;
+
+/**
+ * State of a stream matched by a @c StreamAutomaton: a state of its DFA. It is a plain 32-bit integer, so that it
+ *  can be stored in a flow table of many concurrent streams, copied, and serialized as it is. It stays valid as long
+ *  as the automaton it was obtained from.
+ */
+using StreamState = uint32_t;
+
+/**
+ * @brief Automaton matching byte streams chunk by chunk, shared by all streams.
+ *
+ * The automaton is a DFA over byte classes (bytes of the same class of symbols of the DFA), stored in a dense table.
+ *  Feeding a chunk of a stream costs two array reads per byte and needs only the state the previous chunk ended
+ *  in. States from which no final state is reachable over bytes are precomputed, so that streams which can no longer
+ *  be accepted can be rejected (and dropped from a flow table) early.
+ */
+class StreamAutomaton {
+public:
+    /**
+     * Compile @p aut, determinizing it first if it is not deterministic.
+     * @param byte_map Symbols of bytes of streams.
+     */
+    explicit StreamAutomaton(const Mata::Nfa::Nfa& aut, const ByteMap& byte_map = identity_byte_map());
+    /**
+     * Compile @p dfa.
+     * @param byte_map Symbols of bytes of streams.
+     * @throws std::length_error if @p dfa has more states than @c StreamState can hold.
+     */
+    explicit StreamAutomaton(const Dfa& dfa, const ByteMap& byte_map = identity_byte_map());
+
+    /// State of a stream before its first chunk.
+    StreamState start() const { return initial_; }
+
+    /// Feed the next chunk @p chunk of a stream in the state @p state.
+    /// @return State of the stream after the chunk.
+    StreamState feed(StreamState state, std::string_view chunk) const {
+        for (const char byte: chunk) {
+            state = table_[state * num_of_byte_classes_ + byte_classes_[static_cast<unsigned char>(byte)]];
+        }
+        return state;
+    }
+
+    /// Is the stream read so far (all chunks fed up to @p state) in the language of the automaton?
+    bool is_accepting(StreamState state) const { return (flags_[state] & ACCEPTING) != 0; }
+    /// Can the stream read so far be extended to a stream in the language of the automaton?
+    bool can_still_accept(StreamState state) const { return (flags_[state] & LIVE) != 0; }
+
+    size_t num_of_states() const { return flags_.size(); }
+    size_t num_of_byte_classes() const { return num_of_byte_classes_; }
+    /// Is @p state a state of this automaton, e.g., after deserialization?
+    bool is_valid(StreamState state) const { return state < flags_.size(); }
+
+private:
+    static constexpr uint8_t ACCEPTING{ 1 };
+    static constexpr uint8_t LIVE{ 2 };
+
+    StreamState initial_;
+    size_t num_of_byte_classes_;
+    std::array<uint16_t, 256> byte_classes_; ///< Class of every byte.
+    /// Successor of the state q under the byte class c on the index q * num_of_byte_classes_ + c.
+    std::vector<StreamState> table_;
+    std::vector<uint8_t> flags_; ///< Flags @c ACCEPTING and @c LIVE of every state.
+}; // class StreamAutomaton.
+
+/**
+ * @brief Matcher of a single stream: a @c StreamAutomaton and the state of the stream.
+ *
+ * The matcher is a light handle (a pointer and the state); streams kept in bulk should rather store only their
+ *  @c StreamState and build a matcher from it when their next chunk arrives.
+ */
+class StreamMatcher {
+public:
+    /// Matcher of a new stream.
+    explicit StreamMatcher(const StreamAutomaton& aut) : aut_{ &aut }, state_{ aut.start() } {}
+    /// Matcher resuming a stream in the state @p state.
+    StreamMatcher(const StreamAutomaton& aut, StreamState state) : aut_{ &aut }, state_{ state } {}
+
+    /// Feed the next chunk of the stream.
+    void feed(std::string_view chunk) { state_ = aut_->feed(state_, chunk); }
+    bool is_accepting() const { return aut_->is_accepting(state_); }
+    bool can_still_accept() const { return aut_->can_still_accept(state_); }
+
+    /// State of the stream, to store the stream and resume it later.
+    StreamState get_state() const { return state_; }
+    /// Start the stream again.
+    void reset() { state_ = aut_->start(); }
+
+private:
+    const StreamAutomaton* aut_;
+    StreamState state_;
+}; // class StreamMatcher.
+
+} // namespace Dfa.
+} // namespace Mata.
+
+#endif // MATA_DFA_STREAM_HH_
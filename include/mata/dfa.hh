@@ -0,0 +1,133 @@
+/* dfa.hh -- deterministic finite automaton with a dense transition table
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_DFA_HH_
+#define MATA_DFA_HH_
+
+#include <cstdint>
+#include <vector>
+
+#include <mata/nfa.hh>
+
+namespace Mata {
+namespace Dfa {
+
+using State = Mata::Nfa::State;
+using Symbol = Mata::Nfa::Symbol;
+using Run = Mata::Nfa::Run;
+
+/**
+ * @brief Complete deterministic automaton compiled into a dense transition table.
+ *
+ * Symbols are grouped into symbol classes: two symbols are in the same class when every state has the same successor
+ *  under both of them. The class 0 holds all symbols which do not appear in the automaton the DFA was built from;
+ *  they lead to a sink state. The successor of a state q under a symbol of the class c is stored in the table on the
+ *  index q * num_of_symbol_classes() + c, and final states are stored in a bitmap, so that a step of a run is two
+ *  array reads (the class of the symbol, and the successor).
+ *
+ * The DFA is complete over all symbols: its language is a language over all values of @c Symbol.
+ */
+class Dfa {
+public:
+    /// Largest symbol for which the class of symbols is looked up in a dense array instead of a binary search.
+    static constexpr Symbol DENSE_SYMBOL_LIMIT{ 1 << 16 };
+
+    /// DFA with the empty language (a single non-final state).
+    Dfa();
+
+    /**
+     * Compile a deterministic NFA (with at most one initial state and one target of every transition), e.g., a
+     *  result of @c Nfa::determinize(). Missing transitions lead to a new sink state.
+     * @throws std::runtime_error if @p aut is not deterministic.
+     */
+    explicit Dfa(const Mata::Nfa::Nfa& aut);
+
+    size_t num_of_states() const { return num_of_states_; }
+    size_t num_of_symbol_classes() const { return num_of_classes_; }
+    State initial() const { return initial_; }
+    bool is_final(State state) const { return (final_[state / 64] >> (state % 64) & 1) != 0; }
+
+    /// Class of @p symbol.
+    size_t symbol_class(Symbol symbol) const {
+        if (symbol < dense_classes_.size()) { return dense_classes_[symbol]; }
+        return symbols_are_dense_ ? 0 : find_symbol_class(symbol);
+    }
+    /// Symbol of the class @p symbol_class, e.g., for building words.
+    Symbol representative(size_t symbol_class) const { return representatives_[symbol_class]; }
+
+    State successor(State state, Symbol symbol) const { return table_[state * num_of_classes_ + symbol_class(symbol)]; }
+
+    /// Run the DFA on the word [@p first, @p last) from the initial state.
+    /// @return True if the word is accepted.
+    bool run(const Symbol* first, const Symbol* last) const {
+        State state{ initial_ };
+        for (; first != last; ++first) { state = table_[state * num_of_classes_ + symbol_class(*first)]; }
+        return is_final(state);
+    }
+    bool run(const Run& word) const { return run(word.word.data(), word.word.data() + word.word.size()); }
+
+    /// Convert the DFA to a complete NFA over the symbols of all classes but the class 0.
+    Mata::Nfa::Nfa to_nfa() const;
+
+    friend Dfa complement(const Dfa& aut);
+    friend Dfa product(const Dfa& lhs, const Dfa& rhs, bool (*is_final)(bool, bool));
+
+private:
+    size_t num_of_states_;
+    size_t num_of_classes_;
+    State initial_;
+    std::vector<State> table_; ///< Successor of every state under every class of symbols.
+    std::vector<uint64_t> final_; ///< Bitmap of final states.
+    std::vector<Symbol> symbols_; ///< Sorted symbols of all classes but the class 0.
+    std::vector<uint32_t> symbol_classes_; ///< Class of the symbol on the same index in @c symbols_.
+    std::vector<uint32_t> dense_classes_; ///< Class of every symbol up to the largest one in @c symbols_, if small.
+    bool symbols_are_dense_; ///< Does @c dense_classes_ cover all symbols in @c symbols_?
+    std::vector<Symbol> representatives_; ///< A symbol of every class.
+
+    size_t find_symbol_class(Symbol symbol) const;
+    void set_final(State state) { final_[state / 64] |= uint64_t{ 1 } << (state % 64); }
+    /// Set @c symbols_ and @c symbol_classes_ to the given sorted symbols and their classes and build the lookups.
+    void set_symbol_classes(std::vector<Symbol> symbols, std::vector<uint32_t> symbol_classes, size_t num_of_classes);
+}; // class Dfa.
+
+/// Complement of @p aut (over all symbols), flipping its final states.
+Dfa complement(const Dfa& aut);
+
+/**
+ * Product of @p lhs and @p rhs restricted to reachable pairs of states. Symbol classes of the product refine classes
+ *  of both DFAs.
+ * @param is_final Decides whether a pair of states is final, given whether the states of the pair are final.
+ */
+Dfa product(const Dfa& lhs, const Dfa& rhs, bool (*is_final)(bool, bool));
+/// DFA accepting words accepted by both @p lhs and @p rhs.
+Dfa intersection(const Dfa& lhs, const Dfa& rhs);
+/// DFA accepting words accepted by @p lhs or @p rhs.
+Dfa uni(const Dfa& lhs, const Dfa& rhs);
+
+/**
+ * Check whether the language of @p aut is empty.
+ * @param[out] cex Shortest word accepted by @p aut if the language is not empty (only the word is set).
+ */
+bool is_lang_empty(const Dfa& aut, Run* cex = nullptr);
+
+/// Compile @p aut, determinizing it first if it is not deterministic.
+Dfa compile(const Mata::Nfa::Nfa& aut);
+
+} // namespace Dfa.
+} // namespace Mata.
+
+#endif // MATA_DFA_HH_
@@ -0,0 +1,483 @@
+/* flat-hash-map.hh -- open-addressing hash maps with flat storage
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_FLAT_HASH_MAP_HH_
+#define MATA_FLAT_HASH_MAP_HH_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <mata/ord-vector.hh>
+
+namespace Mata {
+namespace Util {
+
+namespace FlatHash {
+    /// Index of an empty slot of the table.
+    constexpr size_t EMPTY{ std::numeric_limits<size_t>::max() };
+    constexpr size_t INITIAL_CAPACITY{ 16 };
+
+    /// Slot of an open-addressing table: a cached hash and an index into the flat storage of entries.
+    struct Slot {
+        size_t hash{ 0 };
+        size_t index{ EMPTY };
+    };
+
+    /// Finalize @p hash so that its low bits, which index the table, depend on all bits of the hash.
+    inline size_t mix(size_t hash) {
+        uint64_t mixed{ static_cast<uint64_t>(hash) };
+        mixed ^= mixed >> 33;
+        mixed *= 0xff51afd7ed558ccdULL;
+        mixed ^= mixed >> 33;
+        return static_cast<size_t>(mixed);
+    }
+} // namespace FlatHash.
+
+/**
+ * @brief Hash map with open addressing (linear probing) and entries stored in a single vector.
+ *
+ * Entries are kept in the order of insertion in a vector, the table only holds their indices together with cached
+ *  hashes, so that an insertion does not allocate a node and a probe compares keys only on matching hashes. Entries
+ *  cannot be erased.
+ *
+ * Iterators and references to entries are invalidated by insertions.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap {
+public:
+    using value_type = std::pair<Key, Value>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    FlatHashMap() : entries_{}, slots_(FlatHash::INITIAL_CAPACITY) {}
+
+    /**
+     * Insert (@p key, @p value) unless @p key is already in the map.
+     * @return Pair of an iterator to the entry with @p key and whether the entry was inserted.
+     */
+    std::pair<iterator, bool> emplace(const Key& key, const Value& value) {
+        if ((entries_.size() + 1) * 4 > slots_.size() * 3) { rehash(slots_.size() * 2); }
+        const size_t hash{ FlatHash::mix(Hash{}(key)) };
+        FlatHash::Slot& slot{ slots_[find_slot(key, hash)] };
+        if (slot.index != FlatHash::EMPTY) { return { entries_.begin() + slot.index, false }; }
+        slot = { hash, entries_.size() };
+        entries_.emplace_back(key, value);
+        return { entries_.end() - 1, true };
+    }
+
+    iterator find(const Key& key) {
+        const size_t index{ slots_[find_slot(key, FlatHash::mix(Hash{}(key)))].index };
+        return index == FlatHash::EMPTY ? entries_.end() : entries_.begin() + index;
+    }
+
+    const_iterator find(const Key& key) const {
+        const size_t index{ slots_[find_slot(key, FlatHash::mix(Hash{}(key)))].index };
+        return index == FlatHash::EMPTY ? entries_.cend() : entries_.cbegin() + index;
+    }
+
+    /// Get the value of @p key, inserting a default constructed value if @p key is not in the map.
+    Value& operator[](const Key& key) { return emplace(key, Value{}).first->second; }
+
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+    /// Reserve space for @p num_of_entries entries.
+    void reserve(size_t num_of_entries) {
+        entries_.reserve(num_of_entries);
+        size_t capacity{ slots_.size() };
+        while (num_of_entries * 4 > capacity * 3) { capacity *= 2; }
+        if (capacity > slots_.size()) { rehash(capacity); }
+    }
+
+    void clear() {
+        entries_.clear();
+        std::fill(slots_.begin(), slots_.end(), FlatHash::Slot{});
+    }
+
+    iterator begin() { return entries_.begin(); }
+    iterator end() { return entries_.end(); }
+    const_iterator begin() const { return entries_.cbegin(); }
+    const_iterator end() const { return entries_.cend(); }
+
+    /// Copy the entries into a standard map @p map (e.g., an out-parameter of the public interface).
+    template<typename Map>
+    void copy_to(Map& map) const {
+        map.clear();
+        map.reserve(entries_.size());
+        map.insert(entries_.begin(), entries_.end());
+    }
+
+    /**
+     * Move the entries into a standard map @p map and clear this map. The table is released before the entries are
+     *  moved, so that the peak memory is lower than with @c copy_to().
+     */
+    template<typename Map>
+    void move_to(Map& map) {
+        std::vector<FlatHash::Slot>().swap(slots_);
+        map.clear();
+        map.reserve(entries_.size());
+        for (value_type& entry: entries_) { map.emplace(std::move(entry.first), std::move(entry.second)); }
+        std::vector<value_type>().swap(entries_);
+        slots_.resize(FlatHash::INITIAL_CAPACITY);
+    }
+
+private:
+    std::vector<value_type> entries_;
+    std::vector<FlatHash::Slot> slots_; ///< Table of a power-of-two size.
+
+    /// Find the slot holding @p key or the empty slot where @p key belongs.
+    size_t find_slot(const Key& key, size_t hash) const {
+        const size_t mask{ slots_.size() - 1 };
+        for (size_t slot{ hash & mask }; ; slot = (slot + 1) & mask) {
+            const FlatHash::Slot& current{ slots_[slot] };
+            if (current.index == FlatHash::EMPTY
+                || (current.hash == hash && entries_[current.index].first == key)) {
+                return slot;
+            }
+        }
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<FlatHash::Slot> slots(capacity);
+        const size_t mask{ capacity - 1 };
+        for (const FlatHash::Slot& old_slot: slots_) {
+            if (old_slot.index == FlatHash::EMPTY) { continue; }
+            size_t slot{ old_slot.hash & mask };
+            while (slots[slot].index != FlatHash::EMPTY) { slot = (slot + 1) & mask; }
+            slots[slot] = old_slot;
+        }
+        slots_ = std::move(slots);
+    }
+}; // class FlatHashMap.
+
+/**
+ * @brief Table of interned sorted sets of numbers (e.g., macrostates of subset-based algorithms).
+ *
+ * Each distinct set is stored exactly once and is identified by a 32-bit id given in the order of interning, so that
+ *  worklists, parent maps and subset maps of an algorithm hold ids instead of copies of the sets. Sets are packed one
+ *  after another into large chunks of memory which are never moved, so a set costs no allocation of its own and
+ *  pointers to its numbers stay valid until the table is cleared. The hash of each set is computed once when it is
+ *  interned and kept with the set, so the table of slots only holds ids and a probe compares sets only on matching
+ *  hashes. A lookup can be made directly with a range of numbers (e.g., a buffer with a freshly computed macrostate)
+ *  without constructing an @c OrdVector. Sets cannot be removed.
+ *
+ * @tparam Number Type of elements of the sets.
+ */
+template<typename Number>
+class MacrostateTable {
+public:
+    using Id = uint32_t;
+    using Set = OrdVector<Number>;
+
+    /// Id returned by lookups of sets which are not in the table.
+    static constexpr Id NONE{ std::numeric_limits<Id>::max() };
+    /// Numbers in the first and the largest chunk of memory shared by several sets; chunks grow geometrically.
+    static constexpr size_t MIN_CHUNK_SIZE{ 256 };
+    static constexpr size_t MAX_CHUNK_SIZE{ 8192 };
+
+    MacrostateTable() : chunks_{}, chunk_last_ids_{}, chunk_size_{ MIN_CHUNK_SIZE }, shared_chunk_{ 0 },
+                        free_{ nullptr }, free_end_{ nullptr }, entries_{}, slots_(FlatHash::INITIAL_CAPACITY, NONE) {}
+
+    MacrostateTable(const MacrostateTable& other) : MacrostateTable() { *this = other; }
+    MacrostateTable(MacrostateTable&& other) = default;
+
+    MacrostateTable& operator=(const MacrostateTable& other) {
+        if (this != &other) {
+            clear();
+            for (Id id{ 0 }; id < other.size(); ++id) { intern(other.begin(id), other.end(id)); }
+        }
+        return *this;
+    }
+    MacrostateTable& operator=(MacrostateTable&& other) = default;
+
+    /**
+     * Intern a set given by a sorted range [@p first, @p last) of distinct numbers.
+     * @return Pair of the id of the set and whether the set was not in the table before.
+     */
+    std::pair<Id, bool> intern(const Number* first, const Number* last) {
+        if ((entries_.size() + 1) * 4 > slots_.size() * 3) {
+            rehash(std::max(slots_.size() * 2, FlatHash::INITIAL_CAPACITY));
+        }
+        const uint32_t hash{ hash_range(first, last) };
+        Id& slot{ slots_[find_slot(first, last, hash)] };
+        if (slot != NONE) { return { slot, false }; }
+        if (entries_.size() >= NONE) {
+            throw std::length_error(std::string(__func__) + ": too many sets for 32-bit ids");
+        }
+        slot = static_cast<Id>(entries_.size());
+        entries_.push_back({ store(first, last, slot), static_cast<uint32_t>(last - first), hash });
+        return { slot, true };
+    }
+
+    std::pair<Id, bool> intern(const Set& set) {
+        const std::vector<Number>& vec{ set.ToVector() };
+        return intern(vec.data(), vec.data() + vec.size());
+    }
+
+    /// Find the id of the set given by a sorted range [@p first, @p last), or @c NONE if it is not in the table.
+    Id find(const Number* first, const Number* last) const {
+        if (slots_.empty()) { return NONE; } // Moved-from table.
+        return slots_[find_slot(first, last, hash_range(first, last))];
+    }
+
+    Id find(const Set& set) const {
+        const std::vector<Number>& vec{ set.ToVector() };
+        return find(vec.data(), vec.data() + vec.size());
+    }
+
+    /// Numbers of the set @p id. The pointers stay valid until the table is cleared.
+    const Number* begin(Id id) const { return entries_[id].data; }
+    const Number* end(Id id) const { return entries_[id].data + entries_[id].size; }
+    /// Number of elements of the set @p id.
+    size_t set_size(Id id) const { return entries_[id].size; }
+    /// Hash of the set @p id computed when the set was interned.
+    uint32_t hash(Id id) const { return entries_[id].hash; }
+    Set get_set(Id id) const {
+        Set set{ Set::with_reserved(set_size(id)) };
+        for (const Number* it{ begin(id) }; it != end(id); ++it) { set.push_back(*it); }
+        return set;
+    }
+
+    /// Number of interned sets.
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+    /**
+     * Call @p process(id, first, last) on all sets in the order of their ids and clear the table. Each chunk is
+     *  released right after its last set is processed, so that sets can be moved to another container without
+     *  keeping all of them twice in memory. The table must not be accessed from @p process.
+     */
+    template<typename Process>
+    void drain(const Process& process) {
+        std::vector<Id>().swap(slots_);
+        std::vector<size_t> chunks_by_last_id(chunks_.size());
+        for (size_t chunk{ 0 }; chunk < chunks_.size(); ++chunk) { chunks_by_last_id[chunk] = chunk; }
+        std::sort(chunks_by_last_id.begin(), chunks_by_last_id.end(),
+                  [&](size_t lhs, size_t rhs) { return chunk_last_ids_[lhs] < chunk_last_ids_[rhs]; });
+        auto next_chunk{ chunks_by_last_id.cbegin() };
+        for (Id id{ 0 }; id < entries_.size(); ++id) {
+            process(id, begin(id), end(id));
+            for (; next_chunk != chunks_by_last_id.cend() && chunk_last_ids_[*next_chunk] == id; ++next_chunk) {
+                chunks_[*next_chunk].reset();
+            }
+        }
+        std::vector<Entry>().swap(entries_);
+        slots_.assign(FlatHash::INITIAL_CAPACITY, NONE);
+        clear();
+    }
+
+    void clear() {
+        chunks_.clear();
+        chunk_last_ids_.clear();
+        chunk_size_ = MIN_CHUNK_SIZE;
+        shared_chunk_ = 0;
+        free_ = nullptr;
+        free_end_ = nullptr;
+        entries_.clear();
+        std::fill(slots_.begin(), slots_.end(), NONE);
+    }
+
+private:
+    struct Entry {
+        const Number* data; ///< Numbers of the set inside a chunk.
+        uint32_t size;
+        uint32_t hash;
+    };
+
+    std::vector<std::unique_ptr<Number[]>> chunks_; ///< Memory holding numbers of all sets.
+    std::vector<Id> chunk_last_ids_; ///< Id of the last set stored in each chunk.
+    size_t chunk_size_; ///< Size of the next chunk shared by several sets.
+    size_t shared_chunk_; ///< Index of the last chunk shared by several sets.
+    Number* free_; ///< Free part [free_, free_end_) of the last chunk shared by several sets.
+    Number* free_end_;
+    std::vector<Entry> entries_; ///< Entry 'i' describes the set with id 'i'.
+    std::vector<Id> slots_; ///< Table of ids of a power-of-two size.
+
+    /**
+     * Copy the set [@p first, @p last) with @p id into a chunk. Sets large compared to a chunk get a chunk of their
+     *  own.
+     */
+    const Number* store(const Number* first, const Number* last, Id id) {
+        const size_t size{ static_cast<size_t>(last - first) };
+        if (size == 0) { return free_; }
+        if (size > static_cast<size_t>(free_end_ - free_)) {
+            if (size > chunk_size_ / 4) {
+                chunks_.emplace_back(new Number[size]);
+                chunk_last_ids_.push_back(id);
+                return std::copy(first, last, chunks_.back().get()) - size;
+            }
+            chunks_.emplace_back(new Number[chunk_size_]);
+            chunk_last_ids_.push_back(id);
+            shared_chunk_ = chunks_.size() - 1;
+            free_ = chunks_.back().get();
+            free_end_ = free_ + chunk_size_;
+            chunk_size_ = std::min(chunk_size_ * 2, MAX_CHUNK_SIZE);
+        }
+        chunk_last_ids_[shared_chunk_] = id;
+        Number* data{ free_ };
+        free_ = std::copy(first, last, free_);
+        return data;
+    }
+
+    static uint32_t hash_range(const Number* first, const Number* last) {
+        size_t hash{ static_cast<size_t>(last - first) };
+        for (; first != last; ++first) {
+            hash ^= static_cast<size_t>(*first) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        }
+        return static_cast<uint32_t>(FlatHash::mix(hash));
+    }
+
+    /// Find the slot holding the set [@p first, @p last) or the empty slot where the set belongs.
+    size_t find_slot(const Number* first, const Number* last, uint32_t hash) const {
+        const size_t mask{ slots_.size() - 1 };
+        for (size_t slot{ hash & mask }; ; slot = (slot + 1) & mask) {
+            const Id id{ slots_[slot] };
+            if (id == NONE || (entries_[id].hash == hash && std::equal(first, last, begin(id), end(id)))) {
+                return slot;
+            }
+        }
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Id> slots(capacity, NONE);
+        const size_t mask{ capacity - 1 };
+        for (const Id id: slots_) {
+            if (id == NONE) { continue; }
+            size_t slot{ entries_[id].hash & mask };
+            while (slots[slot] != NONE) { slot = (slot + 1) & mask; }
+            slots[slot] = id;
+        }
+        slots_ = std::move(slots);
+    }
+}; // class MacrostateTable.
+
+template<typename Number>
+constexpr typename MacrostateTable<Number>::Id MacrostateTable<Number>::NONE;
+template<typename Number>
+constexpr size_t MacrostateTable<Number>::MIN_CHUNK_SIZE;
+template<typename Number>
+constexpr size_t MacrostateTable<Number>::MAX_CHUNK_SIZE;
+
+/**
+ * @brief Hash map from sorted sets of numbers (e.g., macrostates) to values.
+ *
+ * Keys are interned in a @c MacrostateTable, so that a key costs no allocation of its own and a lookup can be made
+ *  directly with a range of numbers without constructing an @c OrdVector. Entries are numbered by ids of their keys
+ *  in the table and cannot be erased.
+ *
+ * @tparam Number Type of elements of the sets.
+ * @tparam Value Type of values.
+ */
+template<typename Number, typename Value>
+class FlatSetMap {
+public:
+    using Set = OrdVector<Number>;
+
+    /**
+     * Insert a set given by a sorted range [@p first, @p last) of distinct numbers with @p value unless the set is
+     *  already in the map.
+     * @return Pair of the id of the entry with the set and whether the entry was inserted.
+     */
+    std::pair<size_t, bool> emplace(const Number* first, const Number* last, const Value& value) {
+        const auto interned{ keys_.intern(first, last) };
+        if (interned.second) { values_.push_back(value); }
+        return { interned.first, interned.second };
+    }
+
+    std::pair<size_t, bool> emplace(const Set& set, const Value& value) {
+        const std::vector<Number>& vec{ set.ToVector() };
+        return emplace(vec.data(), vec.data() + vec.size(), value);
+    }
+
+    /// Find the value of the set given by a sorted range [@p first, @p last), or @c nullptr if it is not in the map.
+    Value* find(const Number* first, const Number* last) {
+        const auto id{ keys_.find(first, last) };
+        return id == Keys::NONE ? nullptr : &values_[id];
+    }
+
+    const Value* find(const Number* first, const Number* last) const {
+        const auto id{ keys_.find(first, last) };
+        return id == Keys::NONE ? nullptr : &values_[id];
+    }
+
+    Value* find(const Set& set) {
+        const std::vector<Number>& vec{ set.ToVector() };
+        return find(vec.data(), vec.data() + vec.size());
+    }
+
+    const Value* find(const Set& set) const {
+        const std::vector<Number>& vec{ set.ToVector() };
+        return find(vec.data(), vec.data() + vec.size());
+    }
+
+    /// Numbers of the set of the entry @p id. The pointers stay valid until the map is cleared.
+    const Number* key_begin(size_t id) const { return keys_.begin(static_cast<typename Keys::Id>(id)); }
+    const Number* key_end(size_t id) const { return keys_.end(static_cast<typename Keys::Id>(id)); }
+    Set get_key(size_t id) const { return keys_.get_set(static_cast<typename Keys::Id>(id)); }
+
+    Value& get_value(size_t id) { return values_[id]; }
+    const Value& get_value(size_t id) const { return values_[id]; }
+
+    size_t size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+
+    void clear() {
+        keys_.clear();
+        values_.clear();
+    }
+
+    /// Copy the entries into a standard map @p map (e.g., an out-parameter of the public interface).
+    void copy_to(std::unordered_map<Set, Value>& map) const {
+        map.clear();
+        map.reserve(values_.size());
+        for (size_t id{ 0 }; id < values_.size(); ++id) { map.emplace(get_key(id), values_[id]); }
+    }
+
+    /**
+     * Move the entries into a standard map @p map and clear this map. Keys are released while they are moved, so
+     *  that the peak memory is lower than with @c copy_to().
+     */
+    void move_to(std::unordered_map<Set, Value>& map) {
+        map.clear();
+        map.reserve(values_.size());
+        keys_.drain([&](size_t id, const Number* first, const Number* last) {
+            Set set{ Set::with_reserved(static_cast<size_t>(last - first)) };
+            for (; first != last; ++first) { set.push_back(*first); }
+            map.emplace(std::move(set), std::move(values_[id]));
+        });
+        std::vector<Value>().swap(values_);
+    }
+
+private:
+    using Keys = MacrostateTable<Number>;
+
+    Keys keys_{};
+    std::vector<Value> values_{}; ///< Value of the entry 'i' is the value of the key with id 'i'.
+}; // class FlatSetMap.
+
+} // namespace Util.
+} // namespace Mata.
+
+#endif // MATA_FLAT_HASH_MAP_HH_
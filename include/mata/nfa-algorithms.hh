@@ -19,6 +19,7 @@
 #define MATA_NFA_INTERNALS_HH_
 
 #include <mata/nfa.hh>
+#include <mata/flat-hash-map.hh>
 #include <mata/simlib/util/binary_relation.hh>
 
 namespace Mata {
@@ -67,7 +68,8 @@ namespace Algorithms {
      * @param smaller Automaton which language should be included in the bigger one
      * @param bigger Automaton which language should include the smaller one
      * @param alphabet Alphabet of the both automaton
-     * @param cex A potential counterexample word which breaks inclusion
+     * @param cex A potential counterexample word which breaks inclusion, with the path of states of @p smaller over
+     *  the word
      * @return True if smaller language is included,
      * i.e., if the final intersection of smaller complement of bigger is empty.
      */
@@ -95,11 +97,82 @@ namespace Algorithms {
             Run*                   cex,
             const StringMap&      params);
 
+    /**
+     * Inclusion implemented by antichains up to simulation (Abdulla et al., 'When simulation meets antichains').
+     * Forward simulation is computed once on the disjoint union of both automata. Macrostates are reduced to their
+     *  simulation-maximal states, a product state (p, P) is pruned when p is simulated by some state of P, and it is
+     *  subsumed by a processed (r, R) when r simulates p and every state of R is simulated by some state of P.
+     * @param smaller Automaton which language should be included in the bigger one
+     * @param bigger Automaton which language should include the smaller one
+     * @param alphabet Alphabet of the both automaton (not used)
+     * @param cex A potential counterexample word which breaks inclusion
+     * @return True if smaller language is included in the bigger one.
+     */
+    bool is_included_antichains_sim(
+            const Nfa&             smaller,
+            const Nfa&             bigger,
+            const Alphabet* const  alphabet,
+            Run*                   cex,
+            const StringMap&       /* params */);
+
+    /**
+     * Inclusion implemented by bisimulation up to congruence (HKC) of Bonchi and Pous: checks that L(smaller) +
+     *  L(bigger) == L(bigger) over on-the-fly determinized macrostates.
+     * @param smaller Automaton which language should be included in the bigger one
+     * @param bigger Automaton which language should include the smaller one
+     * @param alphabet Alphabet of the both automaton (not used)
+     * @param cex A potential counterexample word which breaks inclusion (the shortest one)
+     * @return True if smaller language is included in the bigger one.
+     */
+    bool is_included_hkc(
+            const Nfa&             smaller,
+            const Nfa&             bigger,
+            const Alphabet* const  alphabet,
+            Run*                   cex,
+            const StringMap&       /* params */);
+
+    /**
+     * Equivalence implemented by bisimulation up to congruence (HKC) of Bonchi and Pous in a single pass.
+     * @param lhs First automaton to compare
+     * @param rhs Second automaton to compare
+     * @param cex A potential counterexample word accepted by exactly one of the automata (the shortest one)
+     * @return True if the languages of the automata are equal.
+     */
+    bool are_equivalent_hkc(const Nfa& lhs, const Nfa& rhs, Run* cex = nullptr);
+
+    /**
+     * @brief Congruence closure of a relation on macrostates: the smallest equivalence containing the relation which
+     *  is compatible with the union of macrostates. Used by HKC to skip pairs of macrostates.
+     *
+     * Pairs of the relation are kept in a union-find structure over macrostates, which answers queries up to
+     *  equivalence in nearly constant time. Remaining queries are answered by comparing normal forms of macrostates,
+     *  i.e., macrostates saturated by the pairs (U, V) used as rewriting rules: whenever U or V is included in a
+     *  macrostate, the other one is added.
+     */
+    class CongruenceClosure {
+    public:
+        /// Check whether macrostates @p lhs and @p rhs are related by the congruence closure.
+        bool are_congruent(const StateSet& lhs, const StateSet& rhs);
+        /// Add pair (@p lhs, @p rhs) to the relation.
+        void add(const StateSet& lhs, const StateSet& rhs);
+
+    private:
+        std::unordered_map<StateSet, size_t> ids_{};
+        std::vector<size_t> parents_{};
+        std::vector<std::pair<StateSet, StateSet>> rules_{};
+
+        size_t intern(const StateSet& macrostate);
+        size_t find(size_t id);
+        /// Saturate @p macrostate with all rules.
+        StateSet normal_form(StateSet macrostate) const;
+    }; // class CongruenceClosure.
+
     /**
      * Universality check implemented by checking emptiness of complemented automaton
      * @param aut Automaton which universality is checked
      * @param alphabet Alphabet of the automaton
-     * @param cex Counterexample word which eventually breaks the universality
+     * @param cex Counterexample word which eventually breaks the universality, with the path of states of the
+     *  determinized automaton over the word (see @c is_universal(LazyDfa&, const Alphabet&, Run*))
      * @return True if the complemented automaton has non empty language, i.e., the original one is not universal
      */
     bool is_universal_naive(
@@ -122,6 +195,95 @@ namespace Algorithms {
             Run*              cex,
             const StringMap&  params);
 
+    /**
+     * Brzozowski minimization of automata (revert -> determinize -> revert -> determinize).
+     * @param[in] aut Automaton to be minimized.
+     * @return Minimized automaton.
+     */
+    Nfa minimize_brzozowski(const Nfa& aut);
+
+    /**
+     * Minimization of deterministic automata by partition refinement (Hopcroft's algorithm in the variant of
+     *  Valmari and Lehtinen for partial transition functions) running in O(m log n). A nondeterministic @p aut is
+     *  determinized first.
+     * @param[in] aut Automaton to be minimized.
+     * @return Minimized automaton without useless states.
+     */
+    Nfa minimize_hopcroft(const Nfa& aut);
+
+    /**
+     * Minimization of a deterministic automaton by partition refinement which never merges states with different
+     *  labels, e.g., final states accepting different patterns.
+     * @param[in] aut Deterministic automaton to be minimized.
+     * @param[in] state_labels Label of each state of @p aut (states out of range have the label 0).
+     * @param[out] result_labels Label of each state of the result.
+     * @return Minimized automaton without useless states.
+     * @throws std::runtime_error if @p aut is not deterministic.
+     */
+    Nfa minimize_hopcroft_labelled(const Nfa& aut, const std::vector<size_t>& state_labels,
+                                   std::vector<size_t>& result_labels);
+
+    /**
+     * Compute the coarsest partition of states of a trimmed deterministic automaton which refines the initial
+     *  partition given by @p state_labels and is compatible with the transitions.
+     * @param[in] state_labels Initial label of each state; states with different labels end up in different blocks.
+     * @param[in] tails Sources of transitions.
+     * @param[in] symbols Symbols of transitions.
+     * @param[in] heads Targets of transitions.
+     * @return Block index of each state.
+     */
+    std::vector<size_t> refine_dfa_partition(
+            const std::vector<size_t>& state_labels,
+            const std::vector<size_t>& tails,
+            const std::vector<Symbol>& symbols,
+            const std::vector<size_t>& heads);
+
+    /**
+     * Universality checking based on subset construction with antichains up to simulation: macrostates are reduced
+     *  to their simulation-maximal states and a macrostate P is subsumed by a processed R if every state of R is
+     *  simulated by some state of P.
+     * @param aut Automaton which universality is checked
+     * @param alphabet Alphabet of the automaton
+     * @param cex Counterexample word which eventually breaks the universality
+     * @return True if the automaton is universal, otherwise false.
+     */
+    bool is_universal_antichains_sim(
+            const Nfa&         aut,
+            const Alphabet&    alphabet,
+            Run*               cex,
+            const StringMap&  /* params */);
+
+    /// Map of macrostates to states of a determinized automaton with keys stored in a flat arena.
+    using SubsetMap = Mata::Util::FlatSetMap<State, State>;
+
+    /**
+     * Classical subset construction.
+     *
+     * Macrostates are numbered in the order of their discovery, hence ids of macrostates in @p subset_map are the
+     *  states of the result.
+     * @param[in] aut Automaton to determinize
+     * @param[out] subset_map Maps macrostates to states of the result (cleared first)
+     * @return Determinized automaton
+     */
+    Nfa determinize_classical(const Nfa& aut, SubsetMap& subset_map);
+
+    /**
+     * Subset construction processing the frontier of macrostates level by level on multiple threads. Threads claim
+     *  chunks of the frontier from a shared counter and buffer created transitions locally; the buffers are merged
+     *  at the end.
+     * @param aut Automaton to determinize
+     * @param num_of_threads Number of threads to use (0 for the number of hardware threads)
+     * @param deterministic_numbering Number new macrostates sequentially in the breadth-first order (reproducible),
+     *  otherwise they are numbered concurrently in a sharded subset map
+     * @param subset_map Maps macrostates to states of the result
+     * @return Determinized automaton
+     */
+    Nfa determinize_parallel(
+            const Nfa&  aut,
+            size_t      num_of_threads,
+            bool        deterministic_numbering,
+            std::unordered_map<StateSet, State>* subset_map);
+
     Simlib::Util::BinaryRelation compute_relation(
             const Nfa& aut,
             const StringMap&  params = {{"relation", "simulation"}, {"direction", "forward"}});
@@ -139,6 +301,19 @@ namespace Algorithms {
         Nfa intersection_eps(const Nfa& lhs, const Nfa& rhs, bool preserve_epsilon, const std::set<Symbol>& epsilons,
                         std::unordered_map<std::pair<State,State>, State> *prod_map = nullptr);
 
+        /**
+         * @brief Compute intersection of a sequence of NFAs with a possibility of using multiple epsilons.
+         *
+         * @param[in] automata Non-empty sequence of NFAs to compute intersection for.
+         * @param[in] preserve_epsilon Whether to compute intersection preserving epsilon transitions.
+         * @param[in] epsilons Set of symbols to be considered as epsilons
+         * @param[out] prod_map Mapping of tuples of the original states to new product states.
+         * @return NFA as a product of @p automata with ε-transitions preserved.
+         */
+        Nfa intersection_eps(const ConstAutRefSequence& automata, bool preserve_epsilon,
+                             const std::set<Symbol>& epsilons,
+                             std::unordered_map<std::vector<State>, State>* prod_map = nullptr);
+
         /**
          * @brief Concatenate two NFAs.
          *
@@ -153,6 +328,24 @@ namespace Algorithms {
          */
         Nfa concatenate_eps(const Nfa& lhs, const Nfa& rhs, const Symbol& epsilon, bool use_epsilon = false,
                         StateToStateMap* lhs_result_states_map = nullptr, StateToStateMap* rhs_result_states_map = nullptr);
+
+    /// Symbols of an automaton grouped into classes of symbols with the same targets from every state.
+    struct SymbolClasses {
+        std::vector<Symbol> symbols{}; ///< Sorted symbols of all moves.
+        std::vector<uint32_t> symbol_classes{}; ///< Class of the symbol on the same index, from 1.
+        std::vector<bool> is_first_of_class{}; ///< Is the symbol on the same index the smallest one of its class?
+        size_t num_of_classes{ 1 }; ///< Number of classes including the class 0 of symbols without moves.
+    };
+
+    /**
+     * @brief Group symbols of moves of @p aut into classes, numbered by their smallest symbols from 1.
+     *
+     * Moves over every symbol are collected into a list of pairs (source, targets) ordered by sources, and symbols
+     *  with equal lists form a class, so that the memory used is linear in the number of moves rather than in the
+     *  number of symbols times the number of states. Moves without targets are not collected. Tables of compiled
+     *  automata are then filled from the moves over the first symbols of classes only.
+     */
+    SymbolClasses compute_symbol_classes(const Nfa& aut);
 } // Algorithms
 } // Nfa
 }
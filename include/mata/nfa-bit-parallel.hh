@@ -0,0 +1,109 @@
+/* nfa-bit-parallel.hh -- matching words with small NFAs by bit-parallel simulation
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_NFA_BIT_PARALLEL_HH_
+#define MATA_NFA_BIT_PARALLEL_HH_
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <mata/nfa.hh>
+#include <mata/byte-map.hh>
+
+namespace Mata {
+namespace Nfa {
+
+/**
+ * @brief Matcher of words simulating a small NFA on sets of states stored as bitmasks.
+ *
+ * Symbols are grouped into classes of symbols with the same transitions; the class 0 holds symbols without any
+ *  transition. For every class and every state, the set of successors is precomputed as a bitmask, so that a step of
+ *  the simulation ORs the successor masks of the current states and never allocates.
+ *
+ * Automata with at most 64 states whose every state is entered over a single class of symbols (e.g., Glushkov
+ *  automata of regular expressions, or the Shift-And automata of strings) are simulated as in Shift-And: the
+ *  successors of the current set under any symbol are looked up byte by byte in a table independent of symbols and
+ *  intersected with the mask of the states entered over the class of the current symbol.
+ *
+ * Input can be given as a range of symbols, or as a sequence of bytes (@c std::string_view) translated to symbols by
+ *  the byte map given at the construction (by default, a byte is the symbol of the same value).
+ */
+class BitParallelMatcher {
+public:
+    /// Largest number of states of an automaton the matcher can be compiled from.
+    static constexpr size_t MAX_STATES{ 512 };
+
+    /**
+     * Compile @p aut.
+     * @param byte_map Symbols of bytes of @c std::string_view inputs.
+     * @throws std::length_error if @p aut has more than @c MAX_STATES states.
+     */
+    explicit BitParallelMatcher(const Nfa& aut, const ByteMap& byte_map = identity_byte_map());
+
+    /// Is the word [@p first, @p last) in the language of the automaton?
+    bool is_in_lang(const Symbol* first, const Symbol* last) const;
+    /// Is some prefix of the word [@p first, @p last) in the language of the automaton?
+    bool is_prfx_in_lang(const Symbol* first, const Symbol* last) const;
+    bool is_in_lang(const Run& word) const {
+        return is_in_lang(word.word.data(), word.word.data() + word.word.size());
+    }
+    bool is_prfx_in_lang(const Run& word) const {
+        return is_prfx_in_lang(word.word.data(), word.word.data() + word.word.size());
+    }
+    /// Is the word of symbols of bytes of @p input in the language of the automaton?
+    bool is_in_lang(std::string_view input) const;
+    /// Is some prefix of the word of symbols of bytes of @p input in the language of the automaton?
+    bool is_prfx_in_lang(std::string_view input) const;
+
+    size_t num_of_states() const { return num_of_states_; }
+    size_t num_of_symbol_classes() const { return num_of_classes_; }
+    /// Is the automaton simulated as in Shift-And?
+    bool is_shift_and() const { return !follow_bytes_.empty(); }
+
+private:
+    /// Dense lookup of classes of symbols up to this limit.
+    static constexpr Symbol DENSE_SYMBOL_LIMIT{ 1 << 16 };
+    static constexpr size_t MAX_WORDS{ MAX_STATES / 64 };
+
+    size_t num_of_states_;
+    size_t num_of_words_; ///< Words of a bitmask of states.
+    size_t num_of_classes_;
+    std::vector<uint64_t> initial_; ///< Mask of initial states.
+    std::vector<uint64_t> final_; ///< Mask of final states.
+    /// Mask of successors of the state q under the class c on the index (c * num_of_states_ + q) * num_of_words_.
+    std::vector<uint64_t> successors_;
+    std::vector<Symbol> symbols_; ///< Sorted symbols with transitions.
+    std::vector<uint32_t> symbol_classes_; ///< Class of the symbol on the same index in @c symbols_.
+    std::vector<uint32_t> dense_classes_; ///< Class of every symbol below @c DENSE_SYMBOL_LIMIT up to the largest one.
+    std::array<uint32_t, 256> byte_classes_; ///< Class of the symbol of every byte.
+    /// Shift-And simulation: successors of the states of the value b of the i-th byte of a mask on the index
+    ///  (256 * i + b), and masks of states entered over each class.
+    std::vector<uint64_t> follow_bytes_;
+    std::vector<uint64_t> entered_;
+
+    uint32_t symbol_class(Symbol symbol) const;
+    template<class ClassOf> bool run(size_t length, ClassOf class_of, bool prefix) const;
+    /// Compile the Shift-And tables if the automaton allows it.
+    void compile_shift_and();
+}; // class BitParallelMatcher.
+
+} // namespace Nfa.
+} // namespace Mata.
+
+#endif // MATA_NFA_BIT_PARALLEL_HH_
@@ -0,0 +1,152 @@
+/* nfa-frozen.hh -- immutable (frozen) NFA with a compressed-sparse-row transition relation
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_NFA_FROZEN_HH_
+#define MATA_NFA_FROZEN_HH_
+
+#include <mata/nfa.hh>
+
+namespace Mata {
+namespace Nfa {
+
+/**
+ * A contiguous range of states stored inside a frozen transition relation.
+ */
+struct StateRange {
+    const State* first;
+    const State* last;
+
+    const State* begin() const { return first; }
+    const State* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
+/**
+ * @brief Immutable transition relation stored in the compressed sparse row (CSR) format.
+ *
+ * Moves (symbols) leading from a state q are stored in @c symbols on indices
+ *  [state_offsets[q], state_offsets[q+1]), ordered by symbols. Targets of a move with the index m are stored in
+ *  @c targets on indices [move_offsets[m], move_offsets[m+1]), ordered by states.
+ * The whole relation thus lives in four flat arrays which are traversed without any pointer chasing.
+ */
+struct FrozenDelta {
+    std::vector<size_t> state_offsets{ 0 }; ///< Offsets of the first move of each state (size: states + 1).
+    std::vector<Symbol> symbols{}; ///< Symbols of all moves.
+    std::vector<size_t> move_offsets{ 0 }; ///< Offsets of the first target of each move (size: moves + 1).
+    std::vector<State> targets{}; ///< Targets of all moves.
+
+    FrozenDelta() = default;
+    /**
+     * Build frozen transition relation from @p delta in a single pass.
+     * @param[in] delta Transition relation to freeze.
+     * @param[in] num_of_states Number of states to reserve room for (at least the size of @p delta).
+     */
+    explicit FrozenDelta(const Delta& delta, size_t num_of_states = 0);
+
+    size_t num_of_states() const { return state_offsets.size() - 1; }
+    size_t num_of_moves() const { return symbols.size(); }
+    size_t num_of_trans() const { return targets.size(); }
+
+    /// Index of the first move leading from @p state.
+    size_t moves_begin(State state) const { return state < num_of_states() ? state_offsets[state] : 0; }
+    /// Index one past the last move leading from @p state.
+    size_t moves_end(State state) const { return state < num_of_states() ? state_offsets[state + 1] : 0; }
+
+    Symbol symbol(size_t move) const { return symbols[move]; }
+    StateRange targets_of(size_t move) const {
+        return { targets.data() + move_offsets[move], targets.data() + move_offsets[move + 1] };
+    }
+
+    /**
+     * Find a move leading from @p state over @p symbol.
+     * @return Index of the move, or @c npos when there is no such move.
+     */
+    size_t find_move(State state, Symbol symbol) const;
+
+    /**
+     * Get targets of transitions leading from @p state over @p symbol.
+     * @return Range of target states (empty when there is no such transition).
+     */
+    StateRange post(State state, Symbol symbol) const {
+        const size_t move{ find_move(state, symbol) };
+        if (move == npos) { return { nullptr, nullptr }; }
+        return targets_of(move);
+    }
+
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+}; // struct FrozenDelta.
+
+/**
+ * @brief Read-only NFA built from @c Nfa, with the transition relation stored as @c FrozenDelta.
+ *
+ * Intended for repeated read-only queries (emptiness, products, subset constructions, inclusion) over large
+ *  automata. The frozen automaton does not reflect later changes of the original automaton.
+ */
+struct FrozenNfa {
+    FrozenDelta delta;
+    Util::NumberPredicate<State> initial = {};
+    Util::NumberPredicate<State> final = {};
+
+    FrozenNfa() = default;
+    explicit FrozenNfa(const Nfa& aut);
+
+    size_t num_of_states() const { return delta.num_of_states(); }
+    size_t get_num_of_trans() const { return delta.num_of_trans(); }
+
+    /// Compute successors of @p states over @p symbol.
+    StateSet post(const StateSet& states, Symbol symbol) const;
+}; // struct FrozenNfa.
+
+/**
+ * Check whether is the language of the frozen automaton empty.
+ * @param[in] aut Automaton to check.
+ * @param[out] cex Counter-example path for a case the language is not empty.
+ * @return True if the language is empty, false otherwise.
+ */
+bool is_lang_empty(const FrozenNfa& aut, Run* cex = nullptr);
+
+/**
+ * @brief Compute intersection of two frozen NFAs.
+ *
+ * Epsilon transitions are handled as transitions over an ordinary symbol.
+ * @param[in] lhs First NFA to compute intersection for.
+ * @param[in] rhs Second NFA to compute intersection for.
+ * @param[out] prod_map Mapping of pairs of the original states (lhs_state, rhs_state) to new product states.
+ * @return NFA as a product of NFAs @p lhs and @p rhs.
+ */
+Nfa intersection(const FrozenNfa& lhs, const FrozenNfa& rhs,
+                 std::unordered_map<std::pair<State, State>, State>* prod_map = nullptr);
+
+/// Determinize a frozen automaton.
+Nfa determinize(const FrozenNfa& aut, std::unordered_map<StateSet, State>* subset_map = nullptr);
+
+/**
+ * @brief Checks inclusion of languages of two frozen NFAs: @p smaller and @p bigger (smaller <= bigger).
+ *
+ * Uses the antichain-based algorithm.
+ * @param smaller[in] Automaton which language should be included in the bigger one.
+ * @param bigger[in] Automaton which language should include the smaller one.
+ * @param cex[out] Counterexample for the inclusion.
+ * @return True if @p smaller is included in @p bigger, false otherwise.
+ */
+bool is_included(const FrozenNfa& smaller, const FrozenNfa& bigger, Run* cex = nullptr);
+
+} // Nfa
+} // Mata
+
+#endif // MATA_NFA_FROZEN_HH_
@@ -0,0 +1,125 @@
+/* nfa-lazy-dfa-matcher.hh -- matching byte strings with a lazily built DFA cache
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_NFA_LAZY_DFA_MATCHER_HH_
+#define MATA_NFA_LAZY_DFA_MATCHER_HH_
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include <mata/nfa.hh>
+#include <mata/byte-map.hh>
+#include <mata/nfa-lazy-dfa.hh>
+
+namespace Mata {
+namespace Nfa {
+
+/**
+ * @brief Matcher of byte strings running a lazy DFA of an NFA with a bounded cache, in the manner of RE2.
+ *
+ * Bytes are translated to symbols by a byte map and grouped into byte classes (bytes of the same symbol, and all
+ *  bytes of symbols without transitions). States of the DFA are built by a @c LazyDfa on their first visit, and
+ *  transitions already taken are cached in a table indexed by states and byte classes, so that a step of a match
+ *  over known transitions is a single table lookup.
+ *
+ * When the DFA and the table grow over the cache budget, the cache is flushed and the match continues from the
+ *  current state. When the cache thrashes (fewer than @c MIN_BYTES_PER_STATE bytes were matched per state built
+ *  since the previous flush), the rest of the input is matched by simulating the NFA on sets of states instead.
+ *
+ * The NFA must outlive the matcher and must not change while the matcher is used.
+ */
+class LazyDfaMatcher {
+public:
+    /// Cache budget in bytes used by default.
+    static constexpr size_t DEFAULT_CACHE_BUDGET{ 8 << 20 };
+    /// Bytes which have to be matched per state built between two flushes for the DFA to be used further.
+    static constexpr size_t MIN_BYTES_PER_STATE{ 10 };
+    /// Result of @c longest_match() when no prefix matches.
+    static constexpr size_t NO_MATCH{ std::string_view::npos };
+
+    /**
+     * @param aut NFA to match with.
+     * @param cache_budget Approximate number of bytes the states and transitions of the DFA may take.
+     * @param byte_map Symbols of bytes of inputs.
+     */
+    explicit LazyDfaMatcher(const Nfa& aut, size_t cache_budget = DEFAULT_CACHE_BUDGET,
+                            const ByteMap& byte_map = identity_byte_map());
+    LazyDfaMatcher(const LazyDfaMatcher&) = delete;
+    LazyDfaMatcher& operator=(const LazyDfaMatcher&) = delete;
+
+    /// Is the word of symbols of bytes of @p input in the language of the automaton?
+    bool is_in_lang(std::string_view input) { return match(input, MatchKind::FULL) != NO_MATCH; }
+    /// Is some prefix of the word of symbols of bytes of @p input in the language of the automaton?
+    bool is_prfx_in_lang(std::string_view input) { return match(input, MatchKind::SHORTEST) != NO_MATCH; }
+    /// Length of the longest prefix of @p input in the language of the automaton, or @c NO_MATCH.
+    size_t longest_match(std::string_view input) { return match(input, MatchKind::LONGEST); }
+
+    size_t cache_budget() const { return cache_budget_; }
+    /// Approximate number of bytes taken by the cache.
+    size_t cache_usage() const { return dfa_.memory_usage() + transitions_.size() * sizeof(State); }
+    /// Number of flushes of the cache since the construction.
+    size_t num_of_flushes() const { return dfa_.num_of_flushes(); }
+    /// Number of matches finished by simulating the NFA since the construction.
+    size_t num_of_fallbacks() const { return num_of_fallbacks_; }
+
+private:
+    enum class MatchKind { FULL, SHORTEST, LONGEST };
+
+    /// Transition of the table which has not been taken yet.
+    static constexpr State UNKNOWN{ std::numeric_limits<State>::max() };
+    static constexpr uint8_t FINAL{ 1 };
+    static constexpr uint8_t DEAD{ 2 };
+
+    const Nfa& aut_;
+    size_t cache_budget_;
+    LazyDfa dfa_;
+    ByteMap byte_map_;
+    std::array<uint16_t, 256> byte_classes_{}; ///< Class of every byte.
+    size_t num_of_byte_classes_{ 0 };
+    std::vector<Symbol> class_symbols_{}; ///< Symbol of the bytes of every class.
+    /// Target of the state q under the byte class c on the index q * num_of_byte_classes_ + c, or @c UNKNOWN.
+    std::vector<State> transitions_{};
+    std::vector<uint8_t> flags_{}; ///< Flags @c FINAL and @c DEAD of every state with a row in the table.
+    size_t bytes_since_flush_{ 0 };
+    size_t num_of_fallbacks_{ 0 };
+    /// NFA simulation: current and next sets of states, and marks of states in the next set.
+    std::vector<State> current_{};
+    std::vector<State> next_{};
+    std::vector<bool> in_next_{};
+
+    /**
+     * Match a prefix of @p input of the given kind.
+     * @return Length of the matched prefix (for FULL, the whole input), or @c NO_MATCH.
+     */
+    size_t match(std::string_view input, MatchKind kind);
+    /// Take the transition of @p state under the byte class @p byte_class missing in the table.
+    /// @param[out] thrashing Set if the cache was flushed too early after the previous flush.
+    State step(State state, size_t byte_class, bool& thrashing);
+    /// Add rows of the table for states of the DFA built since the last call.
+    void add_rows();
+    /// Finish the match of @p input from its position @p position by simulating the NFA from the macrostate of the
+    ///  DFA state @p state. @p last_match is the length of the longest matched prefix so far.
+    size_t simulate(std::string_view input, size_t position, State state, size_t last_match, MatchKind kind);
+}; // class LazyDfaMatcher.
+
+} // namespace Nfa.
+} // namespace Mata.
+
+#endif // MATA_NFA_LAZY_DFA_MATCHER_HH_
@@ -0,0 +1,172 @@
+/* nfa-lazy-dfa.hh -- deterministic view of an NFA with macrostates built on demand
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_NFA_LAZY_DFA_HH_
+#define MATA_NFA_LAZY_DFA_HH_
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <mata/nfa.hh>
+#include <mata/flat-hash-map.hh>
+#include <mata/nfa-post-image.hh>
+
+namespace Mata {
+namespace Nfa {
+
+/**
+ * @brief Deterministic automaton of an NFA given by the subset construction, computed lazily.
+ *
+ * States of the lazy DFA are macrostates (sets of states) of the NFA interned in a @c MacrostateTable. A macrostate
+ *  is created when it is first reached, and its successors under all symbols are computed in a single sweep when
+ *  the successors of the macrostate are first needed. Only the part of the DFA which is actually explored is thus
+ *  ever built. Missing transitions lead to the dead state (the empty macrostate).
+ *
+ * The memory used by the DFA can be bounded by a budget in bytes (unbounded by default). When @c successor() finds
+ *  the cache over the budget, it flushes all macrostates except the one it returns, like the DFA cache of RE2; all
+ *  other states returned before the flush are invalidated. A run which only holds its current state (matching of a
+ *  word) thus works with any budget. @c successors() never flushes, so explorations of the DFA which hold many
+ *  states keep every state they reach.
+ *
+ * The NFA must outlive the lazy DFA and must not change while the lazy DFA is used.
+ */
+class LazyDfa {
+public:
+    /// Transition of the lazy DFA from an expanded state.
+    struct Successor {
+        Symbol symbol;
+        State target;
+    };
+
+    /// Successors of an expanded state, ordered by symbols.
+    struct SuccessorRange {
+        const Successor* first;
+        const Successor* last;
+
+        const Successor* begin() const { return first; }
+        const Successor* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    static constexpr size_t UNBOUNDED{ std::numeric_limits<size_t>::max() };
+
+    /**
+     * @param aut NFA to determinize.
+     * @param memory_budget Approximate number of bytes the macrostates and transitions of the DFA may take.
+     */
+    explicit LazyDfa(const Nfa& aut, size_t memory_budget = UNBOUNDED);
+    LazyDfa(const LazyDfa&) = delete;
+    LazyDfa& operator=(const LazyDfa&) = delete;
+
+    /// Initial state: the macrostate of all initial states of the NFA.
+    State initial();
+    /**
+     * Successor of @p state under @p symbol (the dead state when there is no transition). Flushes the cache when
+     *  it is over the memory budget, invalidating all states but the returned one.
+     */
+    State successor(State state, Symbol symbol);
+    /**
+     * All successors of @p state (transitions to the dead state are left out). The range is valid until the next
+     *  call of a non-const method.
+     */
+    SuccessorRange successors(State state);
+
+    /**
+     * Clear the cache, keeping only the macrostate of @p state, e.g., when a user of the DFA keeps its own tables
+     *  counted against its own budget. All other states are invalidated.
+     * @return The new id of @p state.
+     */
+    State flush(State state);
+
+    bool is_final(State state) const { return states_[state].is_final; }
+    /// Is @p state the empty macrostate, from which no final state is reachable?
+    bool is_dead(State state) const { return macrostates_.set_size(static_cast<Id>(state)) == 0; }
+
+    /// States of the NFA in the macrostate @p state, sorted. The range is valid until the cache is flushed.
+    const State* macrostate_begin(State state) const { return macrostates_.begin(static_cast<Id>(state)); }
+    const State* macrostate_end(State state) const { return macrostates_.end(static_cast<Id>(state)); }
+    StateSet get_macrostate(State state) const { return macrostates_.get_set(static_cast<Id>(state)); }
+
+    /// Number of states built since the last flush.
+    size_t num_of_states() const { return states_.size(); }
+    /// Approximate number of bytes taken by the states and transitions built since the last flush.
+    size_t memory_usage() const { return memory_usage_; }
+    size_t memory_budget() const { return memory_budget_; }
+    /// Number of flushes of the cache since the construction.
+    size_t num_of_flushes() const { return num_of_flushes_; }
+
+private:
+    using Id = Util::MacrostateTable<State>::Id;
+
+    /// Offset of successors of a state which has not been expanded yet.
+    static constexpr size_t NOT_EXPANDED{ std::numeric_limits<size_t>::max() };
+    static constexpr State NO_STATE{ std::numeric_limits<State>::max() };
+
+    struct StateInfo {
+        size_t first_successor; ///< Index of the first successor in @c successors_, or @c NOT_EXPANDED.
+        size_t num_of_successors;
+        bool is_final;
+    };
+
+    const Nfa& aut_;
+    size_t memory_budget_;
+    size_t memory_usage_{ 0 };
+    size_t num_of_flushes_{ 0 };
+    Util::MacrostateTable<State> macrostates_{};
+    std::vector<StateInfo> states_{}; ///< Entry 'i' describes the state (macrostate) with id 'i'.
+    std::vector<Successor> successors_{}; ///< Successors of all expanded states, grouped by states.
+    State initial_{ NO_STATE };
+    PostImageEngine post_image_{};
+    std::vector<State> buffer_{};
+
+    /// Intern the macrostate [@p first, @p last), creating a new state if the macrostate is new.
+    State add_state(const State* first, const State* last);
+    /// Compute all successors of @p state unless they are known.
+    void expand(State state);
+}; // class LazyDfa.
+
+/**
+ * Check whether @p word is in the language of the lazy DFA (of its NFA), building only the states on its run.
+ * @param[in] dfa Lazy DFA to run.
+ * @param[in] word Word to check.
+ */
+bool is_in_lang(LazyDfa& dfa, const Run& word);
+
+/**
+ * Check whether the language of the lazy DFA is empty, exploring its states until a final one is found.
+ * @param[in] dfa Lazy DFA to explore.
+ * @param[out] cex Shortest word accepted by the DFA if the language is not empty, with the path of states of the DFA
+ *  over the word.
+ */
+bool is_lang_empty(LazyDfa& dfa, Run* cex = nullptr);
+
+/**
+ * Check whether the lazy DFA accepts all words over @p alphabet, exploring its states until a non-final one is
+ *  found.
+ * @param[in] dfa Lazy DFA to explore.
+ * @param[in] alphabet Alphabet of the words.
+ * @param[out] cex Shortest word over @p alphabet rejected by the DFA if the DFA is not universal, with the path of
+ *  states of the DFA over the word (ending in the dead state if the word leaves the explored states).
+ */
+bool is_universal(LazyDfa& dfa, const Alphabet& alphabet, Run* cex = nullptr);
+
+} // namespace Nfa.
+} // namespace Mata.
+
+#endif // MATA_NFA_LAZY_DFA_HH_
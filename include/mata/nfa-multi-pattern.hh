@@ -0,0 +1,123 @@
+/* nfa-multi-pattern.hh -- automata of many patterns with final states tagged by pattern ids
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_NFA_MULTI_PATTERN_HH_
+#define MATA_NFA_MULTI_PATTERN_HH_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <mata/nfa.hh>
+#include <mata/dfa.hh>
+#include <mata/dfa-stream.hh>
+
+namespace Mata {
+namespace Nfa {
+
+/// Index of a pattern in the sequence of patterns a tagged automaton was built from.
+using PatternId = uint32_t;
+using PatternSet = Util::OrdVector<PatternId>;
+
+/**
+ * @brief Automaton of many patterns whose states are tagged with the ids of the patterns they accept.
+ *
+ * A word is in the language of the pattern i iff a run over the word ends in a state tagged with i. Tags are the
+ *  accepting labels of the automaton: final states are exactly the states with non-empty tags.
+ */
+struct TaggedNfa {
+    Nfa aut{};
+    std::vector<PatternSet> tags{}; ///< Tags of states of @c aut; states out of range have no tags.
+    size_t num_of_patterns{ 0 };
+
+    /// Tags of @p state.
+    const PatternSet& get_tags(State state) const;
+};
+
+/// Tagged disjoint union of @p patterns, the pattern @c patterns[i] having the id i.
+TaggedNfa tagged_union(const std::vector<Nfa>& patterns);
+
+/**
+ * Tagged disjoint union of automata of regular expressions @p regexes (parsed by @c RE2Parser), the expression
+ *  @c regexes[i] having the id i.
+ */
+TaggedNfa tagged_union_of_regexes(const std::vector<std::string>& regexes);
+
+/// Determinize @p aut; a macrostate is tagged with the tags of all its states.
+TaggedNfa determinize(const TaggedNfa& aut);
+
+/**
+ * Compute the minimal deterministic automaton of @p aut in which states with different tags are never merged,
+ *  determinizing @p aut first if it is not deterministic. The result accepts the same words with the same tags.
+ */
+TaggedNfa minimize(const TaggedNfa& aut);
+
+/// Ids of all patterns of @p aut which accept @p word.
+PatternSet get_matching_patterns(const TaggedNfa& aut, const Run& word);
+
+/**
+ * @brief Matcher reporting all patterns of a tagged automaton which match the input, in a single pass.
+ *
+ * The automaton is determinized, minimized with its tags and compiled into a @c Dfa::StreamAutomaton; tags of every
+ *  state are stored with the state. Matching is thus a single DFA run for any number of patterns. Inputs can also be
+ *  matched chunk by chunk as streams (@c start(), @c feed()).
+ */
+class MultiPatternMatcher {
+public:
+    explicit MultiPatternMatcher(const TaggedNfa& aut, const ByteMap& byte_map = identity_byte_map());
+
+    /// Ids of all patterns whose languages contain the word of symbols of bytes of @p input.
+    const PatternSet& match(std::string_view input) const { return get_matches(feed(start(), input)); }
+
+    /**
+     * Report every pattern matching every prefix of @p input, calling @p on_match(id, length) for each pattern id
+     *  accepting the prefix of the length @c length, in the order of lengths.
+     */
+    template<class OnMatch>
+    void scan(std::string_view input, OnMatch on_match) const {
+        Dfa::StreamState state{ start() };
+        for (size_t length{ 0 };; ++length) {
+            for (const PatternId id: get_matches(state)) { on_match(id, length); }
+            if (length == input.size() || !automaton_.can_still_accept(state)) { return; }
+            state = automaton_.feed(state, input.substr(length, 1));
+        }
+    }
+
+    Dfa::StreamState start() const { return automaton_.start(); }
+    Dfa::StreamState feed(Dfa::StreamState state, std::string_view chunk) const {
+        return automaton_.feed(state, chunk);
+    }
+    /// Ids of patterns matching the input fed up to @p state.
+    const PatternSet& get_matches(Dfa::StreamState state) const { return tags_[state]; }
+
+    size_t num_of_states() const { return automaton_.num_of_states(); }
+    size_t num_of_patterns() const { return num_of_patterns_; }
+
+private:
+    size_t num_of_patterns_;
+    std::vector<PatternSet> tags_; ///< Tags of every state of @c automaton_.
+    Dfa::StreamAutomaton automaton_;
+
+    /// Minimize @p aut with its tags into a DFA, storing the tags of states of the DFA to @p tags.
+    static Dfa::Dfa compile_minimal(const TaggedNfa& aut, std::vector<PatternSet>& tags);
+}; // class MultiPatternMatcher.
+
+} // namespace Nfa.
+} // namespace Mata.
+
+#endif // MATA_NFA_MULTI_PATTERN_HH_
@@ -45,9 +45,9 @@ namespace Plumbing {
         *result = complement(aut, alphabet, params, subset_map);
     } // complement }}}
 
-    inline void minimize(Nfa* res, const Nfa &aut)
+    inline void minimize(Nfa* res, const Nfa &aut, const StringMap& params = {})
     { // {{{
-        *res = minimize(aut);
+        *res = minimize(aut, params);
     } // minimize }}}
 
     inline void determinize(
@@ -0,0 +1,125 @@
+/* nfa-post-image.hh -- computing post images of macrostates without allocations
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_NFA_POST_IMAGE_HH_
+#define MATA_NFA_POST_IMAGE_HH_
+
+#include <cstdint>
+#include <vector>
+
+#include <mata/nfa.hh>
+
+namespace Mata {
+namespace Nfa {
+
+/**
+ * @brief Computes post images of macrostates (sets of states) in a transition relation with reusable buffers.
+ *
+ * A sweep started by @c start() visits all symbols leaving a macrostate in the ascending order, merging the moves of
+ *  all states of the macrostate at once, and exposes the image of the macrostate under the current symbol as a sorted
+ *  range of states. The next symbol is found by a linear scan over the states of small macrostates and by a binary
+ *  heap of the states ordered by their next symbols for large ones (O(log k) per move of a macrostate of k states).
+ *  Targets of several moves are deduplicated in a dense bitset over states; an image coming from a single move is
+ *  exposed directly from the transition relation without any copy. All buffers are kept between calls, so that after
+ *  warming up, an engine computes images without allocating.
+ *
+ * An engine is meant to be owned by an algorithm (one per thread for parallel algorithms); @c thread_local_engine()
+ *  provides an engine private to the calling thread for functions which cannot keep their own. Only const accesses
+ *  to posts of states of the transition relation are made, so several engines can share one relation concurrently.
+ */
+class PostImageEngine {
+public:
+    PostImageEngine() = default;
+    // The current image may point into the buffers of the engine, a copy would have to start a new sweep anyway.
+    PostImageEngine(const PostImageEngine&) = delete;
+    PostImageEngine(PostImageEngine&&) = default;
+    PostImageEngine& operator=(const PostImageEngine&) = delete;
+    PostImageEngine& operator=(PostImageEngine&&) = default;
+
+    /// Largest number of states with moves in a macrostate for which the next symbol is found by a linear scan.
+    static constexpr size_t LINEAR_SWEEP_LIMIT{ 8 };
+
+    /**
+     * Start a sweep over images of the macrostate [@p first, @p last) in @p delta. States without a post in
+     *  @p delta are skipped.
+     *
+     * @p delta must not change during the sweep; the macrostate is not accessed after @c start() returns.
+     */
+    void start(const Delta& delta, const State* first, const State* last);
+    void start(const Delta& delta, const StateSet& macrostate) {
+        const std::vector<State>& states{ macrostate.ToVector() };
+        start(delta, states.data(), states.data() + states.size());
+    }
+
+    /**
+     * Move to the next symbol with a non-empty image.
+     * @return False if all symbols leaving the macrostate have been visited.
+     */
+    bool next();
+
+    /// Current symbol of the sweep.
+    Symbol symbol() const { return symbol_; }
+    /// Image of the macrostate under the current symbol, sorted and without duplicates. The range is valid until the
+    ///  next call of @c next() or @c start().
+    const State* begin() const { return image_first_; }
+    const State* end() const { return image_last_; }
+    size_t size() const { return static_cast<size_t>(image_last_ - image_first_); }
+
+    /**
+     * Compute the image of the macrostate [@p first, @p last) in @p delta under @p symbol.
+     * @param[out] image Buffer for the image (cleared first), sorted and without duplicates.
+     */
+    void post(const Delta& delta, const State* first, const State* last, Symbol symbol, std::vector<State>& image);
+
+    /// Engine private to the calling thread.
+    static PostImageEngine& thread_local_engine();
+
+private:
+    /// Remaining moves of a state of the macrostate.
+    struct Cursor {
+        const Move* current;
+        const Move* last;
+    };
+
+    /// Cursor with the next symbol in the heap of cursors.
+    struct HeapEntry {
+        Symbol symbol;
+        size_t cursor;
+    };
+
+    std::vector<Cursor> cursors_{};
+    std::vector<HeapEntry> heap_{}; ///< Min-heap of cursors by their next symbols for large macrostates.
+    Symbol symbol_{ 0 };
+    const State* image_first_{ nullptr };
+    const State* image_last_{ nullptr };
+    std::vector<State> buffer_{}; ///< Image merged from several moves.
+    std::vector<uint64_t> seen_{}; ///< Dense bitset of states in @c buffer_; all bits are clear between calls.
+
+    bool next_by_scan();
+    bool next_by_heap();
+    /// Restore the heap property of @c heap_ below the entry @p index.
+    void sift_down(size_t index);
+    /// Append states of [@p first, @p last) which are not in @p image yet to @p image, marking them in @c seen_.
+    void add_targets(const State* first, const State* last, std::vector<State>& image);
+    /// Sort @p image built by @c add_targets() and clear their marks in @c seen_.
+    void finish_image(std::vector<State>& image);
+}; // class PostImageEngine.
+
+} // namespace Nfa.
+} // namespace Mata.
+
+#endif // MATA_NFA_POST_IMAGE_HH_
@@ -35,11 +35,13 @@ namespace Strings {
     public:
         /**
          * Maps states in the automaton @p aut to shortest words accepted by languages of the states.
+         *
+         * Words are computed backwards from final states over the predecessor index of the transition relation.
          * @param aut Automaton to compute shortest words for.
          */
-        explicit ShortestWordsMap(const Nfa::Nfa& aut) : reversed_automaton(revert(aut)) {
-            insert_initial_lengths();
-            compute();
+        explicit ShortestWordsMap(const Nfa::Nfa& aut) {
+            insert_initial_lengths(aut);
+            compute(aut);
         }
 
         /**
@@ -64,25 +66,25 @@ namespace Strings {
         std::unordered_map<State, LengthWordsPair> shortest_words_map{};
         std::set<State> processed{}; ///< Set of already processed states.
         std::deque<State> fifo_queue{}; ///< FIFO queue for states to process.
-        const Nfa::Nfa reversed_automaton; ///< Reversed input automaton.
 
         /**
          * @brief Inserts initial lengths into the shortest words map.
          *
-         * Inserts initial length of length 0 for final state in the automaton (initial states in the reversed automaton).
+         * Inserts initial length of length 0 for final states in the automaton @p aut.
          */
-        void insert_initial_lengths();
+        void insert_initial_lengths(const Nfa::Nfa& aut);
 
         /**
-         * Computes shortest words for all states in the automaton.
+         * Computes shortest words for all states in the automaton @p aut.
          */
-        void compute();
+        void compute(const Nfa::Nfa& aut);
 
         /**
-         * Computes shortest words for the given @p state.
+         * Computes shortest words for the given @p state of the automaton @p aut.
+         * @param[in] aut Automaton to compute shortest words for.
          * @param[in] state State to compute shortest words for.
          */
-        void compute_for_state(State state);
+        void compute_for_state(const Nfa::Nfa& aut, State state);
 
         /**
          * Creates default shortest words mapping for yet unprocessed @p state.
@@ -33,6 +33,7 @@
 #include <mata/parser.hh>
 #include <mata/util.hh>
 #include <mata/ord-vector.hh>
+#include <mata/small-vector.hh>
 #include <mata/inter-aut.hh>
 #include <mata/synchronized-iterator.hh>
 
@@ -42,10 +43,20 @@ namespace Nfa
 {
 extern const std::string TYPE_NFA;
 
+#ifdef MATA_COMPACT_IDS
+// Compact mode (CMake option MATA_COMPACT_IDS): states and symbols fit into 32 bits.
+using State = uint32_t;
+using Symbol = uint32_t;
+#else
 using State = unsigned long;
 using Symbol = unsigned long;
+#endif
 
 using StateSet = Mata::Util::OrdVector<State>;
+/// Number of targets of a move stored without a heap allocation.
+constexpr size_t TARGET_SET_INLINE_SIZE{ 4 };
+/// Set of targets of a move. Most moves have a single target, hence the set keeps a few states inline.
+using TargetSet = Mata::Util::OrdVector<State, Mata::Util::SmallVector<State, TARGET_SET_INLINE_SIZE>>;
 
 template<typename T> using Set = Mata::Util::OrdVector<T>;
 
@@ -168,6 +179,23 @@ struct Trans
 
 using TransSequence = std::vector<Trans>; ///< Set of transitions.
 
+/// Predecessor of a state: the source state and the symbol of a transition leading to the state.
+struct Predecessor {
+    State source;
+    Symbol symbol;
+};
+
+/// Range of predecessors of a state, stored in the predecessor index of @c Delta.
+struct PredecessorRange {
+    const Predecessor* first;
+    const Predecessor* last;
+
+    const Predecessor* begin() const { return first; }
+    const Predecessor* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
 struct Nfa; ///< A non-deterministic finite automaton.
 
 //TODO: Kill these types names? Some of them?
@@ -264,13 +292,13 @@ Mata::Parser::ParsedSection serialize(
  */
 struct Move {
     Symbol symbol{};
-    StateSet targets;
+    TargetSet targets;
 
     Move() = default;
     explicit Move(Symbol symbolOnTransition) : symbol(symbolOnTransition), targets() {}
     Move(Symbol symbolOnTransition, State states_to) :
             symbol(symbolOnTransition), targets{states_to} {}
-    Move(Symbol symbolOnTransition, const StateSet& states_to) :
+    Move(Symbol symbolOnTransition, const TargetSet& states_to) :
             symbol(symbolOnTransition), targets(states_to) {}
 
     inline bool operator<(const Move& rhs) const { return symbol < rhs.symbol; }
@@ -280,11 +308,11 @@ struct Move {
     inline bool operator>(const Move& rhs) const { return symbol > rhs.symbol; }
     inline bool operator>=(const Move& rhs) const { return symbol >= rhs.symbol; }
 
-    StateSet::iterator begin() { return targets.begin(); }
-    StateSet::iterator end() { return targets.end(); }
+    TargetSet::iterator begin() { return targets.begin(); }
+    TargetSet::iterator end() { return targets.end(); }
 
-    StateSet::const_iterator cbegin() const  { return targets.cbegin(); }
-    StateSet::const_iterator cend() const { return targets.cend(); }
+    TargetSet::const_iterator cbegin() const  { return targets.cbegin(); }
+    TargetSet::const_iterator cend() const { return targets.cend(); }
 
     size_t count(State s) const { return targets.count(s); }
     bool empty() const { return targets.empty(); }
@@ -297,7 +325,7 @@ struct Move {
         }
     }
 
-    void insert(StateSet states)
+    void insert(const TargetSet& states)
     {
         for (State s : states) {
             insert(s);
@@ -325,6 +353,10 @@ struct Post : private Util::OrdVector<Move> {
     const_iterator cend() const override { return Util::OrdVector<Move>::cend(); }
 
     Post() = default;
+    Post(const Post&) = default;
+    Post(Post&&) = default;
+    Post& operator=(const Post&) = default;
+    Post& operator=(Post&&) = default;
 
     virtual ~Post() = default;
 
@@ -333,6 +365,11 @@ struct Post : private Util::OrdVector<Move> {
 
     void insert(const Move& m) override { Util::OrdVector<Move>::insert(m); }
 
+    void reserve(size_t capacity) { Util::OrdVector<Move>::reserve(capacity); }
+    /// Append @p m with a symbol greater than symbols of all moves in the post.
+    void push_back(Move&& m) { Util::OrdVector<Move>::push_back(std::move(m)); }
+    void push_back(const Move& m) { Util::OrdVector<Move>::push_back(m); }
+
     const Move& back() const override { return Util::OrdVector<Move>::back(); }
 
     void remove(const Move& m)  { Util::OrdVector<Move>::remove(m); }
@@ -356,20 +393,35 @@ struct Delta {
 private:
     mutable std::vector<Post> post;
     size_t max_state_;
+    /// Predecessors of state 'q' are stored in predecessors_[predecessor_offsets_[q], predecessor_offsets_[q+1]).
+    ///  The index is built lazily by get_predecessors(), empty offsets mean that the index is not built.
+    mutable std::vector<size_t> predecessor_offsets_;
+    mutable std::vector<Predecessor> predecessors_;
 
     /**
      * Size of delta is number of all transitions, i.e. triples of form (state, symbol, state)
      */
     size_t size() const;
 
+    void build_predecessor_index() const;
+
+    void invalidate_predecessor_index() {
+        predecessor_offsets_.clear();
+        predecessors_.clear();
+    }
+
 public:
-    Delta() : post{}, max_state_{0} {}
-    explicit Delta(size_t n) : post(n), max_state_{n} {}
+    Delta() : post{}, max_state_{0}, predecessor_offsets_{}, predecessors_{} {}
+    explicit Delta(size_t n) : post(n), max_state_{n}, predecessor_offsets_{}, predecessors_{} {}
 
     void reserve(size_t n) { post.reserve(n); };
 
+    /**
+     * Get post of @p q for modification. Invalidates the predecessor index.
+     */
     Post & operator[] (State q)
     {
+        invalidate_predecessor_index();
         if (q >= post.size()) {
             post.resize(q+1);
         }
@@ -397,6 +449,7 @@ public:
     {
         post.clear();
         max_state_ = 0;
+        invalidate_predecessor_index();
     }
 
     void increase_size(size_t n)
@@ -411,10 +464,31 @@ public:
 
     void add(State state_from, Symbol symbol, State state_to);
     void add(const Trans& trans) { add(trans.src, trans.symb, trans.tgt); }
+    /**
+     * Add all @p transitions at once.
+     *
+     * The transitions are sorted (unless they are sorted already) and deduplicated first, then posts and moves are built
+     *  directly with exact capacities (or merged with the existing ones), which avoids shifting elements of sorted vectors
+     *  on each insertion.
+     * @param[in] transitions Transitions to add in an arbitrary order, possibly with duplicates.
+     */
+    void add_bulk(TransSequence transitions);
     void remove(State src, Symbol symb, State tgt);
     void remove(const Trans& trans) { remove(trans.src, trans.symb, trans.tgt); }
 
     bool contains(State src, Symbol symb, State tgt) const;
+
+    /**
+     * Get predecessors of @p target, i.e., sources and symbols of all transitions leading to @p target, ordered by
+     *  sources and symbols.
+     *
+     * The first query builds an index of predecessors of all states in the compressed sparse row format in
+     *  O(|delta|), further queries cost O(in-degree of @p target). Any modification of the transition relation (@c add,
+     *  @c remove, the non-const @c operator[], ...) drops the index. The returned range is invalidated likewise.
+     * Building the index is not thread-safe.
+     */
+    PredecessorRange get_predecessors(State target) const;
+
     /**
      * Check whether automaton contains no transitions.
      * @return True if there are no transitions in the automaton, false otherwise.
@@ -437,14 +511,14 @@ public:
         const std::vector<Post>& post;
         size_t current_state;
         Post::const_iterator post_iterator;
-        StateSet::const_iterator targets_position;
+        TargetSet::const_iterator targets_position;
         bool is_end;
 
     public:
         explicit const_iterator(const std::vector<Post>& post_p, bool ise = false);
 
         const_iterator(const std::vector<Post>& post_p, size_t as,
-                       Post::const_iterator pi, StateSet::const_iterator ti, bool ise = false) :
+                       Post::const_iterator pi, TargetSet::const_iterator ti, bool ise = false) :
                 post(post_p), current_state(as), post_iterator(pi), targets_position(ti), is_end(ise) {};
 
         const_iterator(const const_iterator& other) = default;
@@ -550,11 +624,22 @@ public:
         : delta(num_of_states), initial(initial_states), final(final_states),
           alphabet(alphabet_p), max_state_(0) {}
 
+    /**
+     * @brief Construct a new explicit NFA with @p transitions and initial and final states.
+     *
+     * The automaton has states up to the greatest state appearing in @p transitions, @p initial_states and
+     *  @p final_states. Transitions are loaded by Delta::add_bulk().
+     */
+    static Nfa from_transitions(TransSequence transitions, const StateSet& initial_states = StateSet{},
+                                const StateSet& final_states = StateSet{});
+
     /**
      * @brief Construct a new explicit NFA from other NFA.
      */
     Nfa(const Mata::Nfa::Nfa& other) = default;
+    Nfa(Mata::Nfa::Nfa&& other) = default;
     Nfa& operator=(const Mata::Nfa::Nfa& other) = default;
+    Nfa& operator=(Mata::Nfa::Nfa&& other) = default;
 
     /**
      * Clear transitions but keep the automata states.
@@ -591,7 +676,7 @@ public:
 
     size_t max_state() const
     {
-        return std::max({max_state_, delta.max_state(), initial.domain_size(), final.domain_size()});
+        return std::max<size_t>({max_state_, delta.max_state(), initial.domain_size(), final.domain_size()});
     }
 
     /**
@@ -713,7 +798,9 @@ public:
     /**
      * Get transitions leading to @p state_to.
      * @param state_to[in] Target state for transitions to get.
-     * @return Sequence of @c Trans transitions leading to @p state_to.
+     * @return Sequence of @c Trans transitions leading to @p state_to, ordered by sources and symbols.
+     *
+     * Uses the predecessor index of @c delta, see Delta::get_predecessors().
      */
     TransSequence get_transitions_to(State state_to) const;
 
@@ -754,7 +841,7 @@ public:
         const Nfa* nfa;
         size_t trIt;
         Post::const_iterator tlIt;
-        StateSet::const_iterator ssIt;
+        TargetSet::const_iterator ssIt;
         Trans trans;
         bool is_end = { false };
 
@@ -827,6 +914,19 @@ bool are_state_disjoint(const Nfa& lhs, const Nfa& rhs);
  */
 bool is_lang_empty(const Nfa& aut, Run* cex = nullptr);
 
+/**
+ * @brief Check whether the intersection of the languages of @p automata is empty.
+ *
+ * The synchronized product of the automata is explored on the fly without constructing the intersection, and the
+ *  exploration stops at the first product state which is final in all automata. Epsilon symbols are treated as
+ *  ordinary symbols.
+ *
+ * @param[in] automata Automata to intersect. Intersection of no automata is the universal language.
+ * @param[out] cex Shortest word in the intersection if the intersection is not empty (only @c cex.word is set).
+ * @return True if the intersection is empty, false otherwise.
+ */
+bool is_intersection_empty(const ConstAutRefSequence& automata, Run* cex = nullptr);
+
 Nfa uni(const Nfa &lhs, const Nfa &rhs);
 
 /**
@@ -850,6 +950,21 @@ Nfa uni(const Nfa &lhs, const Nfa &rhs);
 Nfa intersection(const Nfa& lhs, const Nfa& rhs,
                  bool preserve_epsilon = false, std::unordered_map<std::pair<State, State>, State> *prod_map = nullptr);
 
+/**
+ * @brief Compute intersection of all @p automata in a single pass over their synchronized product.
+ *
+ * Product states are tuples of states of @p automata. With @p preserve_epsilon set to true, ε-transitions behave as in
+ *  the binary version: each ε-transition of a single automaton moves only its component of the tuple, and ε-transitions
+ *  of all automata at once are synchronized like other symbols.
+ *
+ * @param[in] automata Non-empty sequence of NFAs to compute intersection for.
+ * @param[in] preserve_epsilon Whether to compute intersection preserving epsilon transitions.
+ * @param[out] prod_map Mapping of tuples of the original states to new product states.
+ * @return NFA as a product of @p automata.
+ */
+Nfa intersection(const ConstAutRefSequence& automata, bool preserve_epsilon = false,
+                 std::unordered_map<std::vector<State>, State>* prod_map = nullptr);
+
 /**
  * @brief Concatenate two NFAs.
  *
@@ -882,13 +997,38 @@ Nfa complement(
         const StringMap&  params = {{"algo", "classical"}},
         std::unordered_map<StateSet, State> *subset_map = nullptr);
 
-Nfa minimize(const Nfa &aut);
+/**
+ * @brief Compute minimal deterministic automaton.
+ *
+ * @param[in] aut Automaton to minimize.
+ * @param[in] params Optional parameters to control the minimization algorithm:
+ * - "algo": "brzozowski", "hopcroft" (Default: "hopcroft" for deterministic @p aut, "brzozowski" otherwise)
+ * @return Minimal deterministic automaton with the same language as @p aut (its transition function may be partial).
+ */
+Nfa minimize(const Nfa &aut, const StringMap& params = {});
 
 /// Determinize an automaton
 Nfa determinize(
         const Nfa&  aut,
         std::unordered_map<StateSet, State> *subset_map = nullptr);
 
+/**
+ * @brief Determinize an automaton, possibly on multiple threads.
+ *
+ * The result is identical to the one of the sequential determinization up to renumbering of states.
+ * @param[in] aut Automaton to determinize.
+ * @param[in] params Parameters of the determinization:
+ * - "threads": number of threads to use, a positive number capped by the number of hardware threads (Default: "1")
+ * - "numbering": "deterministic" (states are numbered in the breadth-first order independently of the number of
+ *     threads), "arbitrary" (states are numbered concurrently, faster but not reproducible) (Default: "deterministic")
+ * @param[out] subset_map Map of macrostates of @p aut to states of the result.
+ * @return Deterministic automaton with the same language as @p aut.
+ */
+Nfa determinize(
+        const Nfa&        aut,
+        const StringMap&  params,
+        std::unordered_map<StateSet, State> *subset_map = nullptr);
+
 // Reduce the size of the automaton
 Nfa reduce(
         const Nfa &aut,
@@ -918,7 +1058,7 @@ inline bool is_universal(
  * @param cex[out] Counterexample for the inclusion.
  * @param alphabet[in] Alphabet of both NFAs to compute with.
  * @param params[in] Optional parameters to control the equivalence check algorithm:
- * - "algo": "naive", "antichains" (Default: "antichains")
+ * - "algo": "naive", "antichains", "antichains-sim", "hkc" (Default: "antichains")
  * @return True if @p smaller is included in @p bigger, false otherwise.
  */
 bool is_included(
@@ -931,7 +1071,7 @@ bool is_included(
 /**
  * @brief Checks inclusion of languages of two NFAs: @p smaller and @p bigger (smaller <= bigger).
  * @param params[in] Optional parameters to control the equivalence check algorithm:
- * - "algo": "naive", "antichains" (Default: "antichains")
+ * - "algo": "naive", "antichains", "antichains-sim", "hkc" (Default: "antichains")
  */
 inline bool is_included(
         const Nfa&             smaller,
@@ -949,7 +1089,7 @@ inline bool is_included(
  * @param rhs[in] Second automaton to concatenate.
  * @param alphabet[in] Alphabet of both NFAs to compute with.
  * @param params[in] Optional parameters to control the equivalence check algorithm:
- * - "algo": "naive", "antichains" (Default: "antichains")
+ * - "algo": "naive", "antichains", "antichains-sim", "hkc" (Default: "antichains")
  * @return True if @p lhs and @p rhs are equivalent, false otherwise.
  */
 bool are_equivalent(const Nfa& lhs, const Nfa& rhs, const Alphabet* alphabet,
@@ -969,7 +1109,7 @@ bool are_equivalent(const Nfa& lhs, const Nfa& rhs, const Alphabet* alphabet,
  * @param lhs[in] First automaton to concatenate.
  * @param rhs[in] Second automaton to concatenate.
  * @param params[in] Optional parameters to control the equivalence check algorithm:
- * - "algo": "naive", "antichains" (Default: "antichains")
+ * - "algo": "naive", "antichains", "antichains-sim", "hkc" (Default: "antichains")
  * @return True if @p lhs and @p rhs are equivalent, false otherwise.
  */
 bool are_equivalent(const Nfa& lhs, const Nfa& rhs, const StringMap& params = {{"algo", "antichains"}});
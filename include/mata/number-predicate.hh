@@ -5,7 +5,11 @@
 #ifndef LIBMATA_NUMBER_PREDICATE_HH
 #define LIBMATA_NUMBER_PREDICATE_HH
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
+#include <mata/bits.hh>
 #include <mata/ord-vector.hh>
 
 namespace Mata {
@@ -16,7 +20,9 @@ namespace Mata {
          * implementing a set of numbers, aka a unary predicate over numbers, that provides a constant test and update.
          * A number that is explicitly added is in the set, all the other numbers are implicitly not in the set.
          *
-         * Besides a vector of bools (predicate), it can also be asked to maintain a vector of elements (elements).
+         * Besides a bitset packed in 64-bit words (predicate), it can also be asked to maintain a vector of elements
+         * (elements). The number of true elements is maintained as well, so size() is constant, and the operations
+         * with another predicate (are_disjoint, union, intersection, ...) process a whole word at a time.
          * To keep constant test and set, new elements are pushed back to the vector but remove does not modify the vector.
          * Hence, after a remove, the vector contains a superset of the true elements.
          * Superset is still useful, to iterate through true elements, iterate through the vector and test membership in the bool array.
@@ -26,16 +32,21 @@ namespace Mata {
          *  tracking_elements -> elements contains a superset of the true elements
          *  elements_are_exact -> elements contain exactly the true elements
          *
-         * predicate.size() is referred to as "the size of the domain". Ideally, the "domain" would not be visible form the outside,
+         * The number of bits of the predicate is referred to as "the size of the domain". Ideally, the "domain" would not be visible form the outside,
          * but the size of the domain is going to be used to determine the number of states in the nfa automaton :(.
          * This is somewhat ugly, but don't know how else to do it efficiently (computing true maximum would be costly).
          */
-        template <class Number> class OrdVector;
+        template <class Key, class Container> class OrdVector;
 
         template<typename Number>
         class NumberPredicate {
         private:
-            mutable std::vector<bool> predicate = {};
+            using Word = uint64_t;
+            static constexpr size_t WORD_BITS = 64;
+
+            mutable std::vector<Word> words = {}; // bit q % WORD_BITS of words[q / WORD_BITS] tells whether q is in the set
+            Number domain = 0; // bits beyond the domain are always false
+            Number cardinality = 0;
             mutable std::vector <Number> elements = {};
             mutable bool elements_are_exact = true;
             mutable bool tracking_elements = true;
@@ -43,18 +54,50 @@ namespace Mata {
 
             using const_iterator = typename std::vector<Number>::const_iterator;
 
+            static size_t word_index(Number q) { return static_cast<size_t>(q) / WORD_BITS; }
+            static Word bit_mask(Number q) { return Word{ 1 } << (static_cast<size_t>(q) % WORD_BITS); }
+
+            /**
+             * Call @p f on the numbers of the set bits of @p word, which is the @p index-th word, in increasing order.
+             */
+            template <class Function>
+            static void for_each_bit(Word word, size_t index, Function f) {
+                for (; word != 0; word &= word - 1) {
+                    f(static_cast<Number>(index * WORD_BITS + lowest_bit(word)));
+                }
+            }
+
+            void extend_domain(Number new_domain) {
+                if (domain < new_domain) {
+                    domain = new_domain;
+                    words.resize((static_cast<size_t>(domain) + WORD_BITS - 1) / WORD_BITS, 0);
+                }
+            }
+
+            void recount() {
+                cardinality = 0;
+                for (Word word: words)
+                    cardinality += static_cast<Number>(count_bits(word));
+            }
+
             /**
              * assuming that elements contain a superset of the true elements, prune them (in situ)
              */
             void prune_elements() const {
-                Number new_pos = 0;
-                for (Number orig_pos = 0; orig_pos < elements.size(); ++orig_pos) {
-                    if (predicate[elements[orig_pos]]) {
-                        elements[new_pos] = elements[orig_pos];
+                // an element removed and added again is in elements twice; bits of kept elements are cleared until
+                //  the end so that their copies are dropped
+                size_t new_pos = 0;
+                for (size_t orig_pos = 0; orig_pos < elements.size(); ++orig_pos) {
+                    const Number q = elements[orig_pos];
+                    if ((*this)[q]) {
+                        words[word_index(q)] &= ~bit_mask(q);
+                        elements[new_pos] = q;
                         ++new_pos;
                     }
                 }
                 elements.resize(new_pos);
+                for (const Number q: elements)
+                    words[word_index(q)] |= bit_mask(q);
                 elements_are_exact = true;
             }
 
@@ -63,9 +106,9 @@ namespace Mata {
              */
             void compute_elements() const {
                 elements.clear();
-                for (Number q = 0, size=predicate.size(); q < size; ++q) {
-                    if (predicate[q])
-                        elements.push_back(q);
+                elements.reserve(static_cast<size_t>(cardinality));
+                for (size_t i = 0, size = words.size(); i < size; ++i) {
+                    for_each_bit(words[i], i, [&](Number q) { elements.push_back(q); });
                 }
                 elements_are_exact = true;
             }
@@ -95,7 +138,7 @@ namespace Mata {
                 add(list);
             }
 
-            NumberPredicate(Mata::Util::OrdVector<Number> vec, bool track_elements = true) : elements_are_exact(true), tracking_elements(track_elements) {
+            NumberPredicate(Mata::Util::OrdVector<Number, std::vector<Number>> vec, bool track_elements = true) : elements_are_exact(true), tracking_elements(track_elements) {
                 for (auto q: vec)
                     add(q);
             }
@@ -113,24 +156,23 @@ namespace Mata {
              * Note that it extends predicate if q is out of its current domain.
              */
             void add(Number q) {
-                if (predicate.size() <= q)
-                    predicate.resize(q+1,false);
-                if (tracking_elements) {
-                    Number q_was_there = predicate[q];
-                    predicate[q] = true;
-                    if (!q_was_there) {
+                extend_domain(q + 1);
+                Word& word = words[word_index(q)];
+                if (!(word & bit_mask(q))) {
+                    word |= bit_mask(q);
+                    ++cardinality;
+                    if (tracking_elements)
                         elements.push_back(q);
-                    }
-                } else {
-                    predicate[q] = true;
-                    elements_are_exact = false;
+                    else
+                        elements_are_exact = false;
                 }
             }
 
             void remove(Number q) {
-                elements_are_exact = false;
-                if (q < predicate.size() && predicate[q]) {
-                    predicate[q] = false;
+                if ((*this)[q]) {
+                    words[word_index(q)] &= ~bit_mask(q);
+                    --cardinality;
+                    elements_are_exact = false;
                 }
             }
 
@@ -144,6 +186,52 @@ namespace Mata {
                     remove(q);
             }
 
+            /**
+             * Add all elements of @p other (union), a word at a time.
+             */
+            void add_all(const NumberPredicate<Number> &other) {
+                extend_domain(other.domain);
+                for (size_t i = 0, size = other.words.size(); i < size; ++i) {
+                    const Word added = other.words[i] & ~words[i];
+                    if (added == 0)
+                        continue;
+                    words[i] |= added;
+                    cardinality += static_cast<Number>(count_bits(added));
+                    if (tracking_elements)
+                        for_each_bit(added, i, [&](Number q) { elements.push_back(q); });
+                    else
+                        elements_are_exact = false;
+                }
+            }
+
+            /**
+             * Remove all elements of @p other (difference), a word at a time.
+             */
+            void remove_all(const NumberPredicate<Number> &other) {
+                for (size_t i = 0, size = std::min(words.size(), other.words.size()); i < size; ++i) {
+                    const Word removed = words[i] & other.words[i];
+                    if (removed == 0)
+                        continue;
+                    words[i] &= ~removed;
+                    cardinality -= static_cast<Number>(count_bits(removed));
+                    elements_are_exact = false;
+                }
+            }
+
+            /**
+             * Intersection with @p other, computed a word at a time. Elements of the result are ordered.
+             */
+            NumberPredicate<Number> intersection(const NumberPredicate<Number> &other) const {
+                NumberPredicate<Number> result(tracking_elements);
+                result.extend_domain(std::min(domain, other.domain));
+                for (size_t i = 0, size = result.words.size(); i < size; ++i)
+                    result.words[i] = words[i] & other.words[i];
+                result.recount();
+                if (result.cardinality != 0)
+                    result.compute_elements();
+                return result;
+            }
+
             /**
              * start tracking elements (might require updating them to establish the invariant)
              */
@@ -162,8 +250,8 @@ namespace Mata {
              * Note that it returns false if q is out of range of the predicate.
              */
             bool operator[](Number q) const {
-                if (q < predicate.size())
-                    return predicate[q];
+                if (q < domain)
+                    return (words[word_index(q)] & bit_mask(q)) != 0;
                 else
                     return false;
             }
@@ -172,40 +260,25 @@ namespace Mata {
              * This is the number of the true elements, not the size of any data structure.
              */
             Number size() const {
-                if (elements_are_exact)
-                    return elements.size();
-                if (tracking_elements) {
-                    prune_elements();
-                    return elements.size();
-                } else {
-                    Number cnt = 0;
-                    for (Number q = 0, size = predicate.size(); q < size; ++q) {
-                        if (predicate[q])
-                            cnt++;
-                    }
-                    return cnt;
-                }
+                return cardinality;
             }
 
             /*
              * Clears the set of true elements. Does not clear the predicate, only sets it false everywhere.
              */
             void clear() {
-                if (tracking_elements)
-                    for (size_t i = 0, size = elements.size(); i < size; i++)
-                        predicate[elements[i]] = false;
+                if (tracking_elements && elements.size() < words.size())
+                    for (const Number q: elements)
+                        words[word_index(q)] &= ~bit_mask(q);
                 else
-                    //for (size_t i = 0, size = predicate.size(); i < size; i++)
-                    //    predicate[i] = false;
-                    // Vysvetlete mi, co dela to && nize a zaplatim obed.
-                    for (auto && i : predicate)
-                        i = false;
+                    std::fill(words.begin(), words.end(), 0);
+                cardinality = 0;
                 elements.clear();
                 elements_are_exact = true;
             }
 
             void reserve(Number n) {
-                predicate.reserve(n);
+                words.reserve((static_cast<size_t>(n) + WORD_BITS - 1) / WORD_BITS);
                 if (tracking_elements) {
                     elements.reserve(n);
                 }
@@ -213,10 +286,10 @@ namespace Mata {
 
             //TODO: or negate()?
             void flip(Number q) {
-                if (this[q])
-                    add(q);
-                else
+                if ((*this)[q])
                     remove(q);
+                else
+                    add(q);
             }
 
             /*
@@ -224,22 +297,25 @@ namespace Mata {
              * Should be somewhat efficient.
              */
             void complement(Number domain_size) {
-                Number old_domain_size = predicate.size();
-                predicate.reserve(domain_size);
-                Number to_flip = std::min(domain_size,old_domain_size);
-                for (Number q = 0; q < to_flip; ++q) {
-                     predicate[q] = !predicate[q];
+                const Number old_domain_size = domain;
+                extend_domain(domain_size);
+                // flip [0, domain_size), which also sets the new part of the domain
+                const size_t full_words = static_cast<size_t>(domain_size) / WORD_BITS;
+                for (size_t i = 0; i < full_words; ++i)
+                    words[i] = ~words[i];
+                const Word last_word_mask = (Word{ 1 } << (static_cast<size_t>(domain_size) % WORD_BITS)) - 1;
+                if (last_word_mask != 0)
+                    words[full_words] ^= last_word_mask;
+                // clear [domain_size, old_domain_size)
+                if (domain_size < old_domain_size) {
+                    words[full_words] &= last_word_mask;
+                    std::fill(words.begin() + static_cast<std::ptrdiff_t>(full_words) + 1, words.end(), 0);
                 }
-                if (domain_size > old_domain_size)
-                    for (Number q = old_domain_size; q < domain_size; ++q) {
-                        predicate.push_back(true);
-                    }
-                else if (domain_size < old_domain_size)
-                    for (Number q = domain_size; q < old_domain_size; ++q) {
-                        predicate[q]=false;
-                    }
+                recount();
                 if (tracking_elements) {
                     compute_elements();
+                } else {
+                    elements_are_exact = false;
                 }
             }
 
@@ -282,9 +358,8 @@ namespace Mata {
             }
 
             bool are_disjoint(const NumberPredicate<Number> &other) const {
-                //return std::all_of(begin(),end(),[&other](Number x) {return !other[x];});//Vau!
-                for (auto q: *this)
-                    if (other[q])
+                for (size_t i = 0, size = std::min(words.size(), other.words.size()); i < size; ++i)
+                    if ((words[i] & other.words[i]) != 0)
                         return false;
                 return true;
             }
@@ -296,36 +371,24 @@ namespace Mata {
             // This is supposed to return something not smaller than the largest element in the set
             // the easiest is to return the size of the predicate, roughly, the largest element ever inserted.
             Number domain_size() const {
-                return predicate.size();
+                return domain;
             }
 
             // truncates the domain to the maximal element (so the elements stay the same)
             // this could be needed in defragmentation of nfa
             void truncate_domain() {
-                if (predicate.empty())
-                    return;
-                else if (predicate[predicate.size()])
-                    return;
-
-                Number max;
-                if (tracking_elements) {
-                    update_elements();
-                    // if empty, max would be something strange
-                    if (elements.empty()) {
-                        predicate.resize(0);
-                        return;
-                    }
-                    else
-                        max = *std::max_element(elements.begin(), elements.end());
-                }
+                size_t used_words = words.size();
+                while (used_words > 0 && words[used_words - 1] == 0)
+                    --used_words;
+                words.resize(used_words);
+                if (used_words == 0)
+                    domain = 0;
                 else {
-                    // one needs to be careful, Number can be unsigned, empty predicate would cause 0-1 below
-                    for (max = predicate.size()-1; max >= 0; --max)
-                        if (predicate[max])
-                            break;
+                    size_t highest_bit = WORD_BITS - 1;
+                    while (!(words[used_words - 1] >> highest_bit & 1))
+                        --highest_bit;
+                    domain = static_cast<Number>((used_words - 1) * WORD_BITS + highest_bit + 1);
                 }
-
-                predicate.resize(max+1);
             }
         };
     }
@@ -15,8 +15,12 @@
 #include <vector>
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 #include <mata/number-predicate.hh>
+#include <mata/set-kernels.hh>
 
 // insert the class into proper namespace
 namespace Mata
@@ -26,13 +30,16 @@ namespace Mata
         template <class Number> class NumberPredicate;
 
         template <
-            class Key
+            class Key,
+            class Container = std::vector<Key>
         >
         class OrdVector;
 
-        template <class Key>
-        bool is_sorted(std::vector<Key> vec)
+        template <class Container>
+        bool is_sorted(const Container& vec)
         {
+            if (vec.size() < 2) { return true; }
+
             for (auto itVec = vec.cbegin() + 1; itVec < vec.cend(); ++itVec)
             {	// check that the vector is sorted
                 if (!(*(itVec - 1) < *itVec))
@@ -80,17 +87,26 @@ namespace
  *
  * @tparam  Key  Key type: type of the elements contained in the container.
  *               Each elements in a set is also its key.
+ * @tparam  Container  Underlying vector type (e.g., a small vector with inline
+ *                     storage for sets which are mostly tiny).
  */
 template
 <
-    class Key
+    class Key,
+    class Container
 >
 class Mata::Util::OrdVector
 {
+    template <class, class> friend class Mata::Util::OrdVector;
+
 private:  // Private data types
-    using VectorType = std::vector<Key>;
+    using VectorType = Container;
+    /// Whether set operations can run the kernels over raw arrays of keys (see @c SetKernels).
+    using UseSetKernels = std::integral_constant<bool,
+        std::is_trivially_copyable<Key>::value && std::is_default_constructible<Key>::value>;
 
 public:   // Public data types
+    using value_type = Key;
     using iterator = typename VectorType::iterator ;
     using const_iterator = typename VectorType::const_iterator;
     using const_reference = typename VectorType::const_reference;
@@ -107,6 +123,115 @@ private:  // Private methods
         return(Mata::Util::is_sorted(vec_));
     }
 
+    /**
+     * Run a set kernel writing at most @p max_size elements into @p result. Small results are computed in a buffer on
+     *  the stack, so that no memory is allocated for empty results and vectors do not keep oversized capacities.
+     */
+    template <class Kernel>
+    static void run_kernel(VectorType& result, const size_t max_size, Kernel kernel)
+    {
+        constexpr size_t STACK_BUFFER_SIZE{ 32 };
+        if (max_size <= STACK_BUFFER_SIZE)
+        {
+            Key buffer[STACK_BUFFER_SIZE];
+            const size_t size{ kernel(buffer) };
+            if (size > 0) { result = VectorType(buffer, buffer + size); }
+        }
+        else
+        {
+            result.resize(max_size);
+            result.resize(kernel(result.data()));
+        }
+    }
+
+    template <class OtherContainer>
+    void intersection(const OtherContainer& rhs, VectorType& result, std::true_type) const
+    {
+        run_kernel(result, std::min(vec_.size(), rhs.size()), [&](Key* out) {
+            return SetKernels::intersection(vec_.data(), vec_.size(), rhs.data(), rhs.size(), out);
+        });
+    }
+
+    template <class OtherContainer>
+    void intersection(const OtherContainer& rhs, VectorType& result, std::false_type) const
+    {
+        std::set_intersection(vec_.begin(), vec_.end(), rhs.begin(), rhs.end(), std::back_inserter(result));
+    }
+
+    template <class OtherContainer>
+    void Union(const OtherContainer& rhs, VectorType& result, std::true_type) const
+    {
+        run_kernel(result, vec_.size() + rhs.size(), [&](Key* out) {
+            return SetKernels::set_union(vec_.data(), vec_.size(), rhs.data(), rhs.size(), out);
+        });
+    }
+
+    template <class OtherContainer>
+    void Union(const OtherContainer& rhs, VectorType& result, std::false_type) const
+    {
+        // equal elements are taken from the right-hand side
+        result.reserve(vec_.size() + rhs.size());
+        std::set_union(rhs.begin(), rhs.end(), vec_.begin(), vec_.end(), std::back_inserter(result));
+    }
+
+    template <class OtherContainer>
+    void difference(const OtherContainer& rhs, VectorType& result, std::true_type) const
+    {
+        run_kernel(result, vec_.size(), [&](Key* out) {
+            return SetKernels::difference(vec_.data(), vec_.size(), rhs.data(), rhs.size(), out);
+        });
+    }
+
+    template <class OtherContainer>
+    void difference(const OtherContainer& rhs, VectorType& result, std::false_type) const
+    {
+        std::set_difference(vec_.begin(), vec_.end(), rhs.begin(), rhs.end(), std::back_inserter(result));
+    }
+
+    template <class OtherContainer>
+    bool IsSubsetOf(const OtherContainer& bigger, std::true_type) const
+    {
+        return SetKernels::is_subset(vec_.data(), vec_.size(), bigger.data(), bigger.size());
+    }
+
+    template <class OtherContainer>
+    bool IsSubsetOf(const OtherContainer& bigger, std::false_type) const
+    {
+        return std::includes(bigger.cbegin(), bigger.cend(), vec_.cbegin(), vec_.cend());
+    }
+
+    template <class OtherContainer>
+    bool HaveEmptyIntersection(const OtherContainer& rhs, std::true_type) const
+    {
+        return SetKernels::are_disjoint(vec_.data(), vec_.size(), rhs.data(), rhs.size());
+    }
+
+    template <class OtherContainer>
+    bool HaveEmptyIntersection(const OtherContainer& rhs, std::false_type) const
+    {
+        auto itLhs = vec_.cbegin();
+        auto itRhs = rhs.cbegin();
+
+        while ((itLhs != vec_.cend()) && (itRhs != rhs.cend()))
+        {	// until we drop out of the array (or find a common element)
+            if (*itLhs == *itRhs)
+            {	// in case there exists a common element
+                return false;
+            }
+            else if (*itLhs < *itRhs)
+            {	// in case the element in lhs is smaller
+                ++itLhs;
+            }
+            else
+            {	// in case the element in rhs is smaller
+                assert(*itLhs > *itRhs);
+                ++itRhs;
+            }
+        }
+
+        return true;
+    }
+
 
 public:   // Public methods
 
@@ -117,8 +242,8 @@ public:   // Public methods
         assert(vectorIsSorted());
     }
 
-    explicit OrdVector(const VectorType& vec) :
-        vec_(vec)
+    explicit OrdVector(const std::vector<Key>& vec) :
+        vec_(vec.begin(), vec.end())
     {
         //if (vectorIsSorted()) return;//probably useless
 
@@ -162,6 +287,25 @@ public:   // Public methods
         assert(vectorIsSorted());
     }
 
+    OrdVector(OrdVector&& rhs) noexcept(std::is_nothrow_move_constructible<VectorType>::value) :
+        vec_(std::move(rhs.vec_))
+    {
+        // Assertions
+        assert(vectorIsSorted());
+    }
+
+    /**
+     * Convert an ordered vector with a different underlying container.
+     */
+    template <class OtherContainer,
+              typename = typename std::enable_if<!std::is_same<OtherContainer, Container>::value>::type>
+    OrdVector(const OrdVector<Key, OtherContainer>& rhs) :
+        vec_(rhs.vec_.begin(), rhs.vec_.end())
+    {
+        // Assertions
+        assert(vectorIsSorted());
+    }
+
     explicit OrdVector(const Key& key) :
         vec_(1, key)
     {
@@ -216,6 +360,42 @@ public:   // Public methods
         return *this;
     }
 
+    OrdVector& operator=(OrdVector&& rhs) noexcept(std::is_nothrow_move_assignable<VectorType>::value)
+    {
+        if (&rhs != this)
+        {
+            vec_ = std::move(rhs.vec_);
+        }
+
+        // Assertions
+        assert(vectorIsSorted());
+
+        return *this;
+    }
+
+    /**
+     * Reserve space for @p capacity elements.
+     */
+    void reserve(const size_t capacity)
+    {
+        vec_.reserve(capacity);
+    }
+
+    /**
+     * Append @p x, which has to be greater than all elements in the vector (e.g., when elements are produced ordered).
+     */
+    void push_back(const Key& x)
+    {
+        assert(vec_.empty() || vec_.back() < x);
+        vec_.push_back(x);
+    }
+
+    void push_back(Key&& x)
+    {
+        assert(vec_.empty() || vec_.back() < x);
+        vec_.push_back(std::move(x));
+    }
+
 
     void insert(iterator itr, const Key& x)
     {
@@ -304,48 +484,23 @@ public:   // Public methods
         // Assertions
         assert(vectorIsSorted());
 
-        for (auto v : this->vec_)
-        {
-            if (v == key)
-                return 1;
-            else if (v > key)
-                return 0;
-        }
-
-        return 0;
+        return std::binary_search(vec_.begin(), vec_.end(), key) ? 1 : 0;
     }
 
     OrdVector intersection(const OrdVector& rhs) const
+    {
+        return intersection<Container>(rhs);
+    }
+
+    template <class OtherContainer>
+    OrdVector intersection(const OrdVector<Key, OtherContainer>& rhs) const
     {
         // Assertions
         assert(vectorIsSorted());
         assert(rhs.vectorIsSorted());
 
-        VectorType newVector{};
-
-        auto lhsIt = vec_.begin();
-        auto rhsIt = rhs.vec_.begin();
-
-        while ((lhsIt != vec_.end()) && (rhsIt != rhs.vec_.end()))
-        {	// until we get to the end of both vectors
-            if (*lhsIt == *rhsIt)
-            {
-                newVector.push_back(*lhsIt);
-
-                ++lhsIt;
-                ++rhsIt;
-            }
-            else if (*lhsIt < *rhsIt)
-            {
-                ++lhsIt;
-            }
-            else if (*rhsIt < *lhsIt)
-            {
-                ++rhsIt;
-            }
-        }
-
-        OrdVector result(newVector);
+        OrdVector result{};
+        intersection(rhs.vec_, result.vec_, UseSetKernels{});
 
         // Assertions
         assert(result.vectorIsSorted());
@@ -354,50 +509,43 @@ public:   // Public methods
     }
 
     OrdVector Union(const OrdVector& rhs) const
+    {
+        return Union<Container>(rhs);
+    }
+
+    template <class OtherContainer>
+    OrdVector Union(const OrdVector<Key, OtherContainer>& rhs) const
     {
         // Assertions
         assert(vectorIsSorted());
         assert(rhs.vectorIsSorted());
 
-        VectorType newVector;
+        OrdVector result{};
+        Union(rhs.vec_, result.vec_, UseSetKernels{});
 
-        auto lhsIt = vec_.begin();
-        auto rhsIt = rhs.vec_.begin();
+        // Assertions
+        assert(result.vectorIsSorted());
 
-        while ((lhsIt != vec_.end()) || (rhsIt != rhs.vec_.end()))
-        {	// until we get to the end of both vectors
-            if (lhsIt == vec_.end())
-            {	// if we are finished with the left-hand side vector
-                newVector.push_back(*rhsIt);
-                ++rhsIt;
-            }
-            else if (rhsIt == rhs.vec_.end())
-            {	// if we are finished with the right-hand side vector
-                newVector.push_back(*lhsIt);
-                ++lhsIt;
-            }
-            else
-            {
-                if (*lhsIt < *rhsIt)
-                {
-                    newVector.push_back(*lhsIt);
-                    ++lhsIt;
-                }
-                else if (*rhsIt < *lhsIt)
-                {
-                    newVector.push_back(*rhsIt);
-                    ++rhsIt;
-                }
-                else
-                {	// in case they are equal
-                    newVector.push_back(*rhsIt);
-                    ++rhsIt;
-                    ++lhsIt;
-                }
-            }
-        }
+        return result;
+    }
+
+    /**
+     * @brief  Elements of this vector which are not in @p rhs
+     */
+    OrdVector difference(const OrdVector& rhs) const
+    {
+        return difference<Container>(rhs);
+    }
+
+    template <class OtherContainer>
+    OrdVector difference(const OrdVector<Key, OtherContainer>& rhs) const
+    {
+        // Assertions
+        assert(vectorIsSorted());
+        assert(rhs.vectorIsSorted());
 
-        OrdVector result(newVector);
+        OrdVector result{};
+        difference(rhs.vec_, result.vec_, UseSetKernels{});
 
         // Assertions
         assert(result.vectorIsSorted());
@@ -590,44 +738,39 @@ public:   // Public methods
             rhs.vec_.begin(), rhs.vec_.end());
     }
 
-    const std::vector<Key>& ToVector() const
+    const VectorType& ToVector() const
     {
         return vec_;
     }
 
     bool IsSubsetOf(const OrdVector& bigger) const
     {
-        return std::includes(bigger.cbegin(), bigger.cend(),
-            this->cbegin(), this->cend());
+        return IsSubsetOf<Container>(bigger);
     }
 
-    bool HaveEmptyIntersection(const OrdVector& rhs) const
+    template <class OtherContainer>
+    bool IsSubsetOf(const OrdVector<Key, OtherContainer>& bigger) const
     {
         // Assertions
         assert(vectorIsSorted());
-        assert(rhs.vectorIsSorted());
+        assert(bigger.vectorIsSorted());
 
-        const_iterator itLhs = begin();
-        const_iterator itRhs = rhs.begin();
+        return IsSubsetOf(bigger.vec_, UseSetKernels{});
+    }
 
-        while ((itLhs != end()) && (itRhs != rhs.end()))
-        {	// until we drop out of the array (or find a common element)
-            if (*itLhs == *itRhs)
-            {	// in case there exists a common element
-                return false;
-            }
-            else if (*itLhs < *itRhs)
-            {	// in case the element in lhs is smaller
-                ++itLhs;
-            }
-            else
-            {	// in case the element in rhs is smaller
-                assert(*itLhs > *itRhs);
-                ++itRhs;
-            }
-        }
+    bool HaveEmptyIntersection(const OrdVector& rhs) const
+    {
+        return HaveEmptyIntersection<Container>(rhs);
+    }
 
-        return true;
+    template <class OtherContainer>
+    bool HaveEmptyIntersection(const OrdVector<Key, OtherContainer>& rhs) const
+    {
+        // Assertions
+        assert(vectorIsSorted());
+        assert(rhs.vectorIsSorted());
+
+        return HaveEmptyIntersection(rhs.vec_, UseSetKernels{});
     }
 };
 
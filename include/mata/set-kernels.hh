@@ -0,0 +1,394 @@
+/* set-kernels.hh -- kernels of set operations over sorted arrays
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_SET_KERNELS_HH_
+#define MATA_SET_KERNELS_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__SSE2__) || defined(__SSE4_1__) || defined(__AVX2__))
+#include <immintrin.h>
+#define MATA_SET_KERNELS_SIMD 1
+#endif
+
+namespace Mata {
+namespace Util {
+
+/**
+ * @brief Set operations over strictly increasing arrays (sorted sets without duplicates).
+ *
+ * Operands of similar sizes are merged. Blocks of integer elements are compared all-against-all with SIMD
+ *  instructions when the library is compiled for a CPU supporting them (SSE2 for 32-bit elements, SSE4.1 or AVX2 for
+ *  64-bit elements, see the @c MATA_SIMD CMake option), with a scalar merge as the fallback. When one of the operands
+ *  is much smaller than the other, elements of the smaller operand are looked up in the bigger one by galloping
+ *  (exponential) search instead, which makes the operation logarithmic in the size of the bigger operand.
+ *
+ * Output arrays have to be large enough to hold the result (the size of the smaller operand for intersection, the size
+ *  of the left operand for difference, and the sum of the sizes for union); the functions return the number of
+ *  written elements. Output must not overlap with the operands.
+ */
+namespace SetKernels {
+
+/// Operands whose sizes differ by this factor are processed by galloping search instead of merging.
+constexpr size_t GALLOP_RATIO{ 32 };
+
+/**
+ * Galloping search: index of the first element of @p data not less than @p value.
+ *
+ * The cost is logarithmic in the returned index, not in @p size, which makes repeated searches with increasing
+ *  values in the suffix following the previous result cheap.
+ */
+template<typename T>
+size_t gallop(const T* data, const size_t size, const T& value) {
+    if (size == 0 || !(data[0] < value)) { return 0; }
+    size_t low{ 0 }; // data[low] < value
+    size_t high{ 1 };
+    while (high < size && data[high] < value) {
+        low = high;
+        high *= 2;
+    }
+    if (high > size) { high = size; }
+    return static_cast<size_t>(std::lower_bound(data + low + 1, data + high, value) - data);
+}
+
+namespace Detail {
+
+    /**
+     * All-against-all comparison of a block of @c width elements of the left operand with a block of the right
+     *  operand. @c match() returns a mask of the left elements which occur in the right block. Width 0 means that
+     *  there is no vectorized comparison for @p T.
+     */
+    template<typename T, typename Enable = void>
+    struct Block {
+        static constexpr size_t width{ 0 };
+        static unsigned match(const T*, const T*) { return 0; }
+    };
+
+#if defined(MATA_SET_KERNELS_SIMD) && defined(__SSE2__)
+    template<typename T>
+    struct Block<T, typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 4>::type> {
+        static constexpr size_t width{ 4 };
+        static unsigned match(const T* lhs, const T* rhs) {
+            const __m128i left{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs)) };
+            const __m128i right{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs)) };
+            __m128i equal{ _mm_cmpeq_epi32(left, right) };
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(left, _mm_shuffle_epi32(right, 0x39)));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(left, _mm_shuffle_epi32(right, 0x4E)));
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi32(left, _mm_shuffle_epi32(right, 0x93)));
+            return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(equal)));
+        }
+    };
+#endif
+
+#if defined(MATA_SET_KERNELS_SIMD) && defined(__AVX2__)
+    template<typename T>
+    struct Block<T, typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 8>::type> {
+        static constexpr size_t width{ 4 };
+        static unsigned match(const T* lhs, const T* rhs) {
+            const __m256i left{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs)) };
+            const __m256i right{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs)) };
+            __m256i equal{ _mm256_cmpeq_epi64(left, right) };
+            equal = _mm256_or_si256(equal, _mm256_cmpeq_epi64(left, _mm256_permute4x64_epi64(right, 0x39)));
+            equal = _mm256_or_si256(equal, _mm256_cmpeq_epi64(left, _mm256_permute4x64_epi64(right, 0x4E)));
+            equal = _mm256_or_si256(equal, _mm256_cmpeq_epi64(left, _mm256_permute4x64_epi64(right, 0x93)));
+            return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(equal)));
+        }
+    };
+#elif defined(MATA_SET_KERNELS_SIMD) && defined(__SSE4_1__)
+    template<typename T>
+    struct Block<T, typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 8>::type> {
+        static constexpr size_t width{ 2 };
+        static unsigned match(const T* lhs, const T* rhs) {
+            const __m128i left{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs)) };
+            const __m128i right{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs)) };
+            const __m128i equal{ _mm_or_si128(_mm_cmpeq_epi64(left, right),
+                                              _mm_cmpeq_epi64(left, _mm_shuffle_epi32(right, 0x4E))) };
+            return static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(equal)));
+        }
+    };
+#endif
+
+    /**
+     * Advance blocks of both operands the way a merge advances elements: the block with the smaller last element
+     *  has been compared with all elements of the other operand it can occur in.
+     * @return True iff the left block was advanced.
+     */
+    template<typename T>
+    bool advance_blocks(const T* lhs, size_t& lhs_index, const T* rhs, size_t& rhs_index, const size_t width) {
+        const T& lhs_last{ lhs[lhs_index + width - 1] };
+        const T& rhs_last{ rhs[rhs_index + width - 1] };
+        const bool advance_lhs{ !(rhs_last < lhs_last) };
+        if (!(lhs_last < rhs_last)) { rhs_index += width; }
+        if (advance_lhs) { lhs_index += width; }
+        return advance_lhs;
+    }
+
+
+    /// Are the sizes of operands so different that galloping beats merging?
+    inline bool is_skewed(const size_t lhs_size, const size_t rhs_size) {
+        return lhs_size * GALLOP_RATIO < rhs_size || rhs_size * GALLOP_RATIO < lhs_size;
+    }
+
+    /// Intersection of a small set @p lhs with a big set @p rhs by galloping.
+    template<typename T>
+    size_t gallop_intersection(const T* lhs, const size_t lhs_size, const T* rhs, const size_t rhs_size, T* out) {
+        size_t written{ 0 };
+        size_t rhs_index{ 0 };
+        for (size_t lhs_index{ 0 }; lhs_index < lhs_size; ++lhs_index) {
+            rhs_index += gallop(rhs + rhs_index, rhs_size - rhs_index, lhs[lhs_index]);
+            if (rhs_index == rhs_size) { break; }
+            if (!(lhs[lhs_index] < rhs[rhs_index])) {
+                out[written++] = lhs[lhs_index];
+                ++rhs_index;
+            }
+        }
+        return written;
+    }
+
+    /// Disjointness of a small set @p lhs and a big set @p rhs by galloping.
+    template<typename T>
+    bool gallop_are_disjoint(const T* lhs, const size_t lhs_size, const T* rhs, const size_t rhs_size) {
+        size_t rhs_index{ 0 };
+        for (size_t lhs_index{ 0 }; lhs_index < lhs_size; ++lhs_index) {
+            rhs_index += gallop(rhs + rhs_index, rhs_size - rhs_index, lhs[lhs_index]);
+            if (rhs_index == rhs_size) { return true; }
+            if (!(lhs[lhs_index] < rhs[rhs_index])) { return false; }
+        }
+        return true;
+    }
+
+    /// Inclusion of a small set @p lhs in a big set @p rhs by galloping.
+    template<typename T>
+    bool gallop_is_subset(const T* lhs, const size_t lhs_size, const T* rhs, const size_t rhs_size) {
+        size_t rhs_index{ 0 };
+        for (size_t lhs_index{ 0 }; lhs_index < lhs_size; ++lhs_index, ++rhs_index) {
+            rhs_index += gallop(rhs + rhs_index, rhs_size - rhs_index, lhs[lhs_index]);
+            if (rhs_index == rhs_size || lhs[lhs_index] < rhs[rhs_index]) { return false; }
+        }
+        return true;
+    }
+
+    /// Difference of a small set @p lhs and a big set @p rhs by galloping.
+    template<typename T>
+    size_t gallop_difference_small_lhs(const T* lhs, const size_t lhs_size, const T* rhs, const size_t rhs_size,
+                                       T* out) {
+        size_t written{ 0 };
+        size_t lhs_index{ 0 };
+        size_t rhs_index{ 0 };
+        for (; lhs_index < lhs_size; ++lhs_index) {
+            rhs_index += gallop(rhs + rhs_index, rhs_size - rhs_index, lhs[lhs_index]);
+            if (rhs_index == rhs_size) { break; }
+            if (lhs[lhs_index] < rhs[rhs_index]) { out[written++] = lhs[lhs_index]; }
+            else { ++rhs_index; }
+        }
+        return static_cast<size_t>(std::copy(lhs + lhs_index, lhs + lhs_size, out + written) - out);
+    }
+
+    /// Difference of a big set @p lhs and a small set @p rhs: runs of @p lhs between elements of @p rhs are copied.
+    template<typename T>
+    size_t gallop_difference_small_rhs(const T* lhs, const size_t lhs_size, const T* rhs, const size_t rhs_size,
+                                       T* out) {
+        size_t written{ 0 };
+        size_t lhs_index{ 0 };
+        for (size_t rhs_index{ 0 }; rhs_index < rhs_size; ++rhs_index) {
+            const size_t skipped{ gallop(lhs + lhs_index, lhs_size - lhs_index, rhs[rhs_index]) };
+            written = static_cast<size_t>(std::copy(lhs + lhs_index, lhs + lhs_index + skipped, out + written) - out);
+            lhs_index += skipped;
+            if (lhs_index == lhs_size) { break; }
+            if (!(rhs[rhs_index] < lhs[lhs_index])) { ++lhs_index; }
+        }
+        return static_cast<size_t>(std::copy(lhs + lhs_index, lhs + lhs_size, out + written) - out);
+    }
+
+    /**
+     * Union of a small set @p small and a big set @p big: runs of @p big between elements of @p small are copied.
+     * Equal elements are taken from @p big iff @p prefer_big.
+     */
+    template<typename T>
+    size_t gallop_union(const T* small, const size_t small_size, const T* big, const size_t big_size, T* out,
+                        const bool prefer_big) {
+        size_t written{ 0 };
+        size_t big_index{ 0 };
+        for (size_t small_index{ 0 }; small_index < small_size; ++small_index) {
+            const size_t skipped{ gallop(big + big_index, big_size - big_index, small[small_index]) };
+            written = static_cast<size_t>(std::copy(big + big_index, big + big_index + skipped, out + written) - out);
+            big_index += skipped;
+            if (big_index < big_size && !(small[small_index] < big[big_index])) {
+                out[written++] = prefer_big ? big[big_index] : small[small_index];
+                ++big_index;
+            } else {
+                out[written++] = small[small_index];
+            }
+        }
+        return static_cast<size_t>(std::copy(big + big_index, big + big_size, out + written) - out);
+    }
+
+} // namespace Detail.
+
+/**
+ * Write the intersection of @p lhs and @p rhs to @p out.
+ * @return Number of written elements.
+ */
+template<typename T>
+size_t intersection(const T* lhs, const size_t lhs_size, const T* rhs, const size_t rhs_size, T* out) {
+    if (Detail::is_skewed(lhs_size, rhs_size)) {
+        return lhs_size < rhs_size ? Detail::gallop_intersection(lhs, lhs_size, rhs, rhs_size, out)
+                                   : Detail::gallop_intersection(rhs, rhs_size, lhs, lhs_size, out);
+    }
+
+    using Block = Detail::Block<T>;
+    size_t written{ 0 };
+    size_t lhs_index{ 0 };
+    size_t rhs_index{ 0 };
+    if (Block::width > 0) {
+        // Every pair of blocks is compared at most once and matches come out ordered, so they can be written directly.
+        while (lhs_index + Block::width <= lhs_size && rhs_index + Block::width <= rhs_size) {
+            for (unsigned mask{ Block::match(lhs + lhs_index, rhs + rhs_index) }; mask != 0; mask &= mask - 1) {
+                size_t lane{ 0 };
+                while (((mask >> lane) & 1) == 0) { ++lane; }
+                out[written++] = lhs[lhs_index + lane];
+            }
+            Detail::advance_blocks(lhs, lhs_index, rhs, rhs_index, Block::width);
+        }
+    }
+    // Elements of the current blocks which matched earlier blocks are smaller than the current element of the other
+    //  operand, hence the merge skips them.
+    return static_cast<size_t>(
+        std::set_intersection(lhs + lhs_index, lhs + lhs_size, rhs + rhs_index, rhs + rhs_size, out + written) - out);
+}
+
+/**
+ * Check whether @p lhs and @p rhs have no common element.
+ */
+template<typename T>
+bool are_disjoint(const T* lhs, const size_t lhs_size, const T* rhs, const size_t rhs_size) {
+    if (lhs_size == 0 || rhs_size == 0 || lhs[lhs_size - 1] < rhs[0] || rhs[rhs_size - 1] < lhs[0]) { return true; }
+    if (Detail::is_skewed(lhs_size, rhs_size)) {
+        return lhs_size < rhs_size ? Detail::gallop_are_disjoint(lhs, lhs_size, rhs, rhs_size)
+                                   : Detail::gallop_are_disjoint(rhs, rhs_size, lhs, lhs_size);
+    }
+
+    using Block = Detail::Block<T>;
+    size_t lhs_index{ 0 };
+    size_t rhs_index{ 0 };
+    if (Block::width > 0) {
+        while (lhs_index + Block::width <= lhs_size && rhs_index + Block::width <= rhs_size) {
+            if (Block::match(lhs + lhs_index, rhs + rhs_index) != 0) { return false; }
+            Detail::advance_blocks(lhs, lhs_index, rhs, rhs_index, Block::width);
+        }
+    }
+    while (lhs_index < lhs_size && rhs_index < rhs_size) {
+        if (lhs[lhs_index] < rhs[rhs_index]) { ++lhs_index; }
+        else if (rhs[rhs_index] < lhs[lhs_index]) { ++rhs_index; }
+        else { return false; }
+    }
+    return true;
+}
+
+/**
+ * Check whether @p lhs is a subset of @p rhs.
+ */
+template<typename T>
+bool is_subset(const T* lhs, const size_t lhs_size, const T* rhs, const size_t rhs_size) {
+    if (rhs_size < lhs_size) { return false; }
+    if (lhs_size * GALLOP_RATIO < rhs_size) { return Detail::gallop_is_subset(lhs, lhs_size, rhs, rhs_size); }
+
+    using Block = Detail::Block<T>;
+    size_t lhs_index{ 0 };
+    size_t rhs_index{ 0 };
+    if (Block::width > 0) {
+        const unsigned full_mask{ (1u << Block::width) - 1 };
+        unsigned matched{ 0 };
+        while (lhs_index + Block::width <= lhs_size && rhs_index + Block::width <= rhs_size) {
+            matched |= Block::match(lhs + lhs_index, rhs + rhs_index);
+            if (Detail::advance_blocks(lhs, lhs_index, rhs, rhs_index, Block::width)) {
+                if (matched != full_mask) { return false; }
+                matched = 0;
+            }
+        }
+        // Elements of the current left block which are smaller than the current right element could only have
+        //  matched earlier right blocks.
+        for (size_t lane{ 0 }; matched != 0 && lane < Block::width
+                               && (rhs_index == rhs_size || lhs[lhs_index] < rhs[rhs_index]); ++lane, ++lhs_index) {
+            if (((matched >> lane) & 1) == 0) { return false; }
+        }
+    }
+    return std::includes(rhs + rhs_index, rhs + rhs_size, lhs + lhs_index, lhs + lhs_size);
+}
+
+/**
+ * Write the difference @p lhs minus @p rhs to @p out.
+ * @return Number of written elements.
+ */
+template<typename T>
+size_t difference(const T* lhs, const size_t lhs_size, const T* rhs, const size_t rhs_size, T* out) {
+    if (Detail::is_skewed(lhs_size, rhs_size)) {
+        return lhs_size < rhs_size ? Detail::gallop_difference_small_lhs(lhs, lhs_size, rhs, rhs_size, out)
+                                   : Detail::gallop_difference_small_rhs(lhs, lhs_size, rhs, rhs_size, out);
+    }
+
+    using Block = Detail::Block<T>;
+    size_t written{ 0 };
+    size_t lhs_index{ 0 };
+    size_t rhs_index{ 0 };
+    if (Block::width > 0) {
+        unsigned matched{ 0 };
+        while (lhs_index + Block::width <= lhs_size && rhs_index + Block::width <= rhs_size) {
+            matched |= Block::match(lhs + lhs_index, rhs + rhs_index);
+            const size_t block_start{ lhs_index };
+            if (Detail::advance_blocks(lhs, lhs_index, rhs, rhs_index, Block::width)) {
+                for (size_t lane{ 0 }; lane < Block::width; ++lane) {
+                    out[written] = lhs[block_start + lane];
+                    written += ((matched >> lane) & 1) == 0;
+                }
+                matched = 0;
+            }
+        }
+        // See is_subset().
+        for (size_t lane{ 0 }; matched != 0 && lane < Block::width
+                               && (rhs_index == rhs_size || lhs[lhs_index] < rhs[rhs_index]); ++lane, ++lhs_index) {
+            if (((matched >> lane) & 1) == 0) { out[written++] = lhs[lhs_index]; }
+        }
+    }
+    return static_cast<size_t>(
+        std::set_difference(lhs + lhs_index, lhs + lhs_size, rhs + rhs_index, rhs + rhs_size, out + written) - out);
+}
+
+/**
+ * Write the union of @p lhs and @p rhs to @p out.
+ *
+ * There is no vectorized variant: merging needs a sorting network, which does not pay off for the sets of states
+ *  appearing in automata. Equal elements are taken from @p rhs.
+ * @return Number of written elements.
+ */
+template<typename T>
+size_t set_union(const T* lhs, const size_t lhs_size, const T* rhs, const size_t rhs_size, T* out) {
+    if (Detail::is_skewed(lhs_size, rhs_size)) {
+        return lhs_size < rhs_size ? Detail::gallop_union(lhs, lhs_size, rhs, rhs_size, out, true)
+                                   : Detail::gallop_union(rhs, rhs_size, lhs, lhs_size, out, false);
+    }
+    // std::set_union() takes equal elements from its first range.
+    return static_cast<size_t>(std::set_union(rhs, rhs + rhs_size, lhs, lhs + lhs_size, out) - out);
+}
+
+} // namespace SetKernels.
+} // namespace Util.
+} // namespace Mata.
+
+#endif // MATA_SET_KERNELS_HH_
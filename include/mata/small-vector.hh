@@ -0,0 +1,222 @@
+/* small-vector.hh -- vector with inline storage for a few elements
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_SMALL_VECTOR_HH_
+#define MATA_SMALL_VECTOR_HH_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace Mata {
+namespace Util {
+
+/**
+ * @brief Vector storing up to @p N elements inline and spilling to the heap only beyond that.
+ *
+ * Provides the subset of the interface of @c std::vector used by @c OrdVector, so that it can serve as its underlying
+ *  container (e.g., for target sets of moves, which mostly contain a single state). Elements must be trivially
+ *  copyable, iterators are plain pointers and are invalidated by any operation changing the size.
+ */
+template<typename T, size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector supports only trivially copyable elements.");
+    static_assert(N > 0, "SmallVector needs a non-empty inline storage.");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() {}
+
+    SmallVector(size_type count, const T& value) {
+        resize(count, value);
+    }
+
+    template<typename InputIterator,
+             typename = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+    SmallVector(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) { push_back(*first); }
+    }
+
+    SmallVector(std::initializer_list<T> list) : SmallVector(list.begin(), list.end()) {}
+
+    explicit SmallVector(const std::vector<T>& vec) : SmallVector(vec.begin(), vec.end()) {}
+
+    SmallVector(const SmallVector& other) {
+        assign(other.data(), other.size_);
+    }
+
+    SmallVector(SmallVector&& other) noexcept {
+        steal(other);
+    }
+
+    ~SmallVector() {
+        if (!is_inline()) { delete[] storage_.heap; }
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            size_ = 0;
+            assign(other.data(), other.size_);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            if (!is_inline()) { delete[] storage_.heap; }
+            capacity_ = N;
+            steal(other);
+        }
+        return *this;
+    }
+
+    /// Convert to @c std::vector (e.g., for interfaces exposing elements as a vector).
+    operator std::vector<T>() const { return std::vector<T>(begin(), end()); }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size_; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size_; }
+    const_iterator cbegin() const { return data(); }
+    const_iterator cend() const { return data() + size_; }
+
+    T* data() { return is_inline() ? storage_.inline_elements : storage_.heap; }
+    const T* data() const { return is_inline() ? storage_.inline_elements : storage_.heap; }
+
+    size_type size() const { return size_; }
+    size_type capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+    /// Whether the elements are stored inline (no heap allocation).
+    bool is_inline() const { return capacity_ <= N; }
+
+    T& operator[](size_type index) { assert(index < size_); return data()[index]; }
+    const T& operator[](size_type index) const { assert(index < size_); return data()[index]; }
+    T& front() { assert(!empty()); return data()[0]; }
+    const T& front() const { assert(!empty()); return data()[0]; }
+    T& back() { assert(!empty()); return data()[size_ - 1]; }
+    const T& back() const { assert(!empty()); return data()[size_ - 1]; }
+
+    void reserve(size_type new_capacity) {
+        if (new_capacity <= capacity_) { return; }
+        T* const new_heap{ new T[new_capacity] };
+        std::memcpy(static_cast<void*>(new_heap), data(), size_ * sizeof(T));
+        if (!is_inline()) { delete[] storage_.heap; }
+        storage_.heap = new_heap;
+        capacity_ = static_cast<uint32_t>(new_capacity);
+    }
+
+    void resize(size_type new_size) { resize(new_size, T{}); }
+
+    void resize(size_type new_size, const T& value) {
+        if (new_size > size_) {
+            reserve(new_size);
+            std::fill(data() + size_, data() + new_size, value);
+        }
+        size_ = static_cast<uint32_t>(new_size);
+    }
+
+    void push_back(const T& value) {
+        if (size_ == capacity_) {
+            const T copy{ value }; // The value might be stored in the vector itself.
+            reserve(2 * static_cast<size_type>(capacity_));
+            data()[size_++] = copy;
+            return;
+        }
+        data()[size_++] = value;
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        push_back(T(std::forward<Args>(args)...));
+        return back();
+    }
+
+    void pop_back() { assert(!empty()); --size_; }
+
+    void clear() { size_ = 0; }
+
+    iterator insert(const_iterator position, const T& value) {
+        const size_type index{ static_cast<size_type>(position - cbegin()) };
+        assert(index <= size_);
+        push_back(value);
+        std::rotate(begin() + index, end() - 1, end());
+        return begin() + index;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        const size_type index{ static_cast<size_type>(first - cbegin()) };
+        const size_type count{ static_cast<size_type>(last - first) };
+        std::copy(begin() + index + count, end(), begin() + index);
+        size_ -= static_cast<uint32_t>(count);
+        return begin() + index;
+    }
+
+    iterator erase(const_iterator position) { return erase(position, position + 1); }
+
+    bool operator==(const SmallVector& rhs) const { return std::equal(begin(), end(), rhs.begin(), rhs.end()); }
+    bool operator!=(const SmallVector& rhs) const { return !(*this == rhs); }
+    bool operator<(const SmallVector& rhs) const {
+        return std::lexicographical_compare(begin(), end(), rhs.begin(), rhs.end());
+    }
+
+private:
+    uint32_t size_{ 0 };
+    uint32_t capacity_{ N }; ///< Capacity of the storage, at most N means the inline storage.
+    union Storage {
+        T inline_elements[N];
+        T* heap;
+    } storage_{};
+
+    void assign(const T* elements, size_type count) {
+        reserve(count);
+        std::memcpy(static_cast<void*>(data()), elements, count * sizeof(T));
+        size_ = static_cast<uint32_t>(count);
+    }
+
+    /// Take over elements of @p other, which is left empty. The vector has to be inline and empty.
+    void steal(SmallVector& other) {
+        if (other.is_inline()) {
+            std::memcpy(static_cast<void*>(storage_.inline_elements), other.storage_.inline_elements,
+                        other.size_ * sizeof(T));
+        } else {
+            storage_.heap = other.storage_.heap;
+            capacity_ = other.capacity_;
+            other.capacity_ = N;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+}; // class SmallVector.
+
+} // namespace Util.
+} // namespace Mata.
+
+#endif // MATA_SMALL_VECTOR_HH_
@@ -5,6 +5,10 @@
 #ifndef LIBMATA_SYNCHRONIZED_ITERATOR_HH
 #define LIBMATA_SYNCHRONIZED_ITERATOR_HH
 
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
 #include <mata/ord-vector.hh>
 
 namespace Mata {
@@ -29,6 +33,12 @@ namespace Mata {
         *  Method get_current then returns the vector of all position iterators, synchronized.
         *  ii) In determinization, it is enough that there EXISTS a position that points to the smallest class.
         *  Method get_current then returns the vector of only those positions that point to the smallest equiv. class.
+        *  With few positions, the smallest class is found by a linear scan over the positions. With more than
+        *  LINEAR_ADVANCE_LIMIT positions, the positions are kept in a binary heap ordered by the values they point to,
+        *  so that advancing a position costs O(log k) for k positions instead of O(k).
+        *
+        *  get_current returns a reference to a vector held by the iterator, valid until the next call of advance
+        *  or reset, so that reading the current positions does not allocate.
         *
         *  Usage: 0) construct, 1) fill in using push_back, iterate using advance and get_current, 2) reset, goto 1)
         *
@@ -75,7 +85,7 @@ namespace Mata {
             };
 
             virtual bool advance() = 0;
-            virtual const std::vector<Iterator> get_current() = 0;
+            virtual const std::vector<Iterator>& get_current() = 0;
         };
 
 
@@ -121,6 +131,7 @@ namespace Mata {
                         return false;
 
                     //  Advance position[i] and position[0] to the closest equal values.
+                    const Iterator first_position{ this->positions[0] };
                     while (*this->positions[i] != *this->positions[0]) {
 
                         // Advance position[i] to or beyond position[0].
@@ -136,27 +147,19 @@ namespace Mata {
                             if (this->positions[0] == this->ends[0])
                                 return false;
                         }
-
-                        // If position[0] changed, start from position 1 again.
-                        // (note that
-                        // i gets incremented at the end of the for-loop body,
-                        // and that,
-                        // since we are inside the for, there are at least two positions
-                        // as the for starts with i=1.)
-                        if (this->positions[0] > this->positions[1])
-                            i=0;
                     }
+                    // If position[0] changed, positions before i might not be synchronized with it any more,
+                    //  start from position 1 again (note that i gets incremented at the end of the for-loop body).
+                    if (this->positions[0] != first_position)
+                        i=0;
                 }
                 this->synchronized_at_current_minimum = true;
                 return true;
             }
 
-            // Returns the vector of current positions.
-            const std::vector<Iterator> get_current()
+            // Returns the vector of current positions, valid until the next call of advance or reset.
+            const std::vector<Iterator>& get_current()
             {
-                // How to return so that things don't get copied?
-                // Or maybe we should return a copy of positions anyway, to prevent a side effect of advance?
-                // Instead of returning a vector, we could also provide iterators through the result.
                 return this->positions;
             };
 
@@ -176,6 +179,9 @@ namespace Mata {
 
             Iterator next_minimum; // the value we should synchronise on after the first next call of advance().
 
+            // Largest number of positions for which advance() scans all positions linearly.
+            static constexpr size_t LINEAR_ADVANCE_LIMIT = 8;
+
             bool is_synchronized() {
                 return !currently_synchronized.empty();
             }
@@ -195,6 +201,12 @@ namespace Mata {
              * new next_minimum must be updated too.
              */
             bool advance() {
+                if (!this->advancing) {
+                    this->advancing = true;
+                    if (this->positions.size() > LINEAR_ADVANCE_LIMIT) { build_heap(); }
+                }
+                if (this->heap_advance) { return advance_by_heap(); }
+
                 // The next_minimum becomes the current current_minimum.
                 auto current_minimum = this->next_minimum;
 
@@ -243,7 +255,7 @@ namespace Mata {
             * Beware, thy will be ordered differently from how there were input into the iterator.
             * This is due to swapping of the emptied positions with positions at the end.
             */
-            const std::vector<Iterator> get_current()
+            const std::vector<Iterator>& get_current()
             {
                 return this->currently_synchronized;
             };
@@ -281,10 +293,66 @@ namespace Mata {
                 }
 
                 this->currently_synchronized.clear();
-
+                this->heap.clear();
+                this->advancing = false;
+                this->heap_advance = false;
             };
+
+        private:
+            // Indices of positions which are not at their ends, ordered by the values the positions point to.
+            std::vector<size_t> heap{};
+            bool advancing = false; // Has advance() been called since the last reset?
+            bool heap_advance = false; // Does advance() use the heap instead of the linear scan?
+
+            bool precedes(const size_t lhs, const size_t rhs) const {
+                return *this->positions[lhs] < *this->positions[rhs];
+            }
+
+            void sift_down(size_t index) {
+                const size_t position = this->heap[index];
+                const size_t heap_size = this->heap.size();
+                for (size_t child = 2 * index + 1; child < heap_size; child = 2 * index + 1) {
+                    if (child + 1 < heap_size && precedes(this->heap[child + 1], this->heap[child])) { ++child; }
+                    if (!precedes(this->heap[child], position)) { break; }
+                    this->heap[index] = this->heap[child];
+                    index = child;
+                }
+                this->heap[index] = position;
+            }
+
+            void build_heap() {
+                this->heap_advance = true;
+                this->heap.clear();
+                // push_back() leaves out empty ranges, all positions point to some value.
+                for (size_t i = 0; i < this->positions.size(); ++i) { this->heap.push_back(i); }
+                for (size_t i = this->heap.size() / 2; i > 0; --i) { sift_down(i - 1); }
+            }
+
+            /* Pops all positions at the smallest value from the heap into currently_synchronized,
+             * advances them and pushes back those which are not at their ends.
+             * Positions are never removed from positions and ends, exhausted ones only leave the heap.
+             */
+            bool advance_by_heap() {
+                currently_synchronized.clear();
+                if (this->heap.empty()) { return false; }
+
+                const Iterator current_minimum = this->positions[this->heap.front()];
+                while (!this->heap.empty() && *this->positions[this->heap.front()] == *current_minimum) {
+                    const size_t i = this->heap.front();
+                    this->currently_synchronized.emplace_back(this->positions[i]);
+                    if (++this->positions[i] == this->ends[i]) {
+                        this->heap.front() = this->heap.back();
+                        this->heap.pop_back();
+                    }
+                    if (!this->heap.empty()) { sift_down(0); }
+                }
+                return true;
+            }
         };
 
+        template<typename Iterator>
+        constexpr size_t SynchronizedExistentialIterator<Iterator>::LINEAR_ADVANCE_LIMIT;
+
        /* In order to make initialisation of the sync. iterator nicer than inputting v.begin() and v.end()
         * as the two parameters of the method push_back,
         * this function wraps the method push_back,
@@ -61,15 +61,18 @@ namespace Util
 {
 
 template <typename Number>
-bool are_disjoint(NumberPredicate<Number> lhs, NumberPredicate<Number> rhs) {
+bool are_disjoint(const NumberPredicate<Number>& lhs, const NumberPredicate<Number>& rhs) {
     return lhs.are_disjoint(rhs);
 }
 
 template <typename Number>
-bool are_disjoint(Mata::Util::OrdVector<Number> lhs, NumberPredicate<Number> rhs) {
-    for (auto q: lhs)
+bool are_disjoint(const Mata::Util::OrdVector<Number>& lhs, const NumberPredicate<Number>& rhs) {
+    for (auto q: lhs) {
+        if (!(q < rhs.domain_size()))
+            return true; // lhs is ordered, the remaining numbers are out of the domain of rhs
         if (rhs[q])
             return false;
+    }
     return true;
 }
 
@@ -90,19 +93,10 @@ bool are_disjoint(const std::set<T>& lhs, const std::set<T>& rhs)
 } // }}}
 
 
-template <class T>
-bool are_disjoint(const Util::OrdVector<T>& lhs, const Util::OrdVector<T>& rhs)
+template <class T, class LhsContainer, class RhsContainer>
+bool are_disjoint(const Util::OrdVector<T, LhsContainer>& lhs, const Util::OrdVector<T, RhsContainer>& rhs)
 { // {{{
-    auto itLhs = lhs.begin();
-    auto itRhs = rhs.begin();
-    while (itLhs != lhs.end() && itRhs != rhs.end())
-    {
-        if (*itLhs == *itRhs) { return false; }
-        else if (*itLhs < *itRhs) { ++itLhs; }
-        else {++itRhs; }
-    }
-
-    return true;
+    return lhs.HaveEmptyIntersection(rhs);
 } // }}}
 
 /** Is there an element in a container? */
@@ -0,0 +1,94 @@
+/* dfa-stream.cc -- resumable matching of byte streams arriving in chunks
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+// MATA headers
+#include <mata/dfa-stream.hh>
+
+using namespace Mata::Dfa;
+
+namespace {
+    constexpr uint16_t NO_CLASS{ std::numeric_limits<uint16_t>::max() };
+}
+
+constexpr uint8_t StreamAutomaton::ACCEPTING;
+constexpr uint8_t StreamAutomaton::LIVE;
+
+StreamAutomaton::StreamAutomaton(const Mata::Nfa::Nfa& aut, const ByteMap& byte_map)
+    : StreamAutomaton(compile(aut), byte_map) {}
+
+StreamAutomaton::StreamAutomaton(const Dfa& dfa, const ByteMap& byte_map)
+    : initial_{ static_cast<StreamState>(dfa.initial()) }, num_of_byte_classes_{ 0 }, byte_classes_{}, table_{},
+      flags_{} {
+    const size_t num_of_states{ dfa.num_of_states() };
+    if (num_of_states > std::numeric_limits<StreamState>::max()) {
+        throw std::length_error(std::string(__func__) + ": the DFA has " + std::to_string(num_of_states)
+                                + " states, more than a stream state can hold");
+    }
+
+    // Bytes of the same class of symbols of the DFA form a byte class.
+    std::vector<uint16_t> byte_class_of(dfa.num_of_symbol_classes(), NO_CLASS);
+    std::vector<Symbol> class_symbols{};
+    for (size_t byte{ 0 }; byte < byte_map.size(); ++byte) {
+        const size_t symbol_class{ dfa.symbol_class(byte_map[byte]) };
+        if (byte_class_of[symbol_class] == NO_CLASS) {
+            byte_class_of[symbol_class] = static_cast<uint16_t>(class_symbols.size());
+            class_symbols.push_back(byte_map[byte]);
+        }
+        byte_classes_[byte] = byte_class_of[symbol_class];
+    }
+    num_of_byte_classes_ = class_symbols.size();
+
+    table_.resize(num_of_states * num_of_byte_classes_);
+    flags_.assign(num_of_states, 0);
+    for (State state{ 0 }; state < num_of_states; ++state) {
+        for (size_t byte_class{ 0 }; byte_class < num_of_byte_classes_; ++byte_class) {
+            table_[state * num_of_byte_classes_ + byte_class] =
+                static_cast<StreamState>(dfa.successor(state, class_symbols[byte_class]));
+        }
+        if (dfa.is_final(state)) { flags_[state] = ACCEPTING | LIVE; }
+    }
+
+    // States from which a final state is reachable over bytes are found backwards from final states.
+    std::vector<size_t> first_predecessor(num_of_states + 1, 0);
+    for (const StreamState target: table_) { ++first_predecessor[target + 1]; }
+    for (size_t state{ 0 }; state < num_of_states; ++state) {
+        first_predecessor[state + 1] += first_predecessor[state];
+    }
+    std::vector<StreamState> predecessors(table_.size());
+    std::vector<size_t> next_predecessor(first_predecessor.begin(), first_predecessor.end() - 1);
+    for (size_t index{ 0 }; index < table_.size(); ++index) {
+        predecessors[next_predecessor[table_[index]]++] = static_cast<StreamState>(index / num_of_byte_classes_);
+    }
+    std::vector<StreamState> worklist{};
+    for (StreamState state{ 0 }; state < num_of_states; ++state) {
+        if ((flags_[state] & LIVE) != 0) { worklist.push_back(state); }
+    }
+    while (!worklist.empty()) {
+        const StreamState state{ worklist.back() };
+        worklist.pop_back();
+        for (size_t i{ first_predecessor[state] }; i < first_predecessor[state + 1]; ++i) {
+            if ((flags_[predecessors[i]] & LIVE) == 0) {
+                flags_[predecessors[i]] |= LIVE;
+                worklist.push_back(predecessors[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,231 @@
+/* dfa.cc -- deterministic finite automaton with a dense transition table
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+// MATA headers
+#include <mata/dfa.hh>
+#include <mata/nfa-algorithms.hh>
+#include <mata/flat-hash-map.hh>
+
+using namespace Mata::Dfa;
+
+namespace {
+    constexpr State UNVISITED{ std::numeric_limits<State>::max() };
+
+    size_t num_of_words(const size_t num_of_states) { return (num_of_states + 63) / 64; }
+}
+
+constexpr Symbol Dfa::DENSE_SYMBOL_LIMIT;
+
+Dfa::Dfa() : num_of_states_{ 1 }, num_of_classes_{ 1 }, initial_{ 0 }, table_{ 0 }, final_{ 0 }, symbols_{},
+             symbol_classes_{}, dense_classes_{}, symbols_are_dense_{ true }, representatives_{ 0 } {}
+
+Dfa::Dfa(const Mata::Nfa::Nfa& aut) : Dfa() {
+    if (aut.initial.size() > 1) {
+        throw std::runtime_error(std::string(__func__) + ": the automaton has more than one initial state");
+    }
+
+    // States of the automaton are followed by the sink state.
+    size_t num_of_states{ aut.delta.post_size() };
+    for (State state{ 0 }; state < aut.delta.post_size(); ++state) {
+        for (const Mata::Nfa::Move& move: aut.delta[state]) {
+            if (move.targets.size() != 1) {
+                throw std::runtime_error(std::string(__func__) + ": the automaton is not deterministic");
+            }
+            num_of_states = std::max(num_of_states, static_cast<size_t>(*move.targets.begin()) + 1);
+        }
+    }
+    for (const State state: aut.initial) { num_of_states = std::max(num_of_states, static_cast<size_t>(state) + 1); }
+    for (const State state: aut.final) { num_of_states = std::max(num_of_states, static_cast<size_t>(state) + 1); }
+    const State sink{ static_cast<State>(num_of_states) };
+    ++num_of_states;
+
+    Mata::Nfa::Algorithms::SymbolClasses classes{ Mata::Nfa::Algorithms::compute_symbol_classes(aut) };
+    num_of_states_ = num_of_states;
+    num_of_classes_ = classes.num_of_classes;
+    initial_ = aut.initial.size() == 0 ? sink : *aut.initial.begin();
+    // Only moves over the first symbol of every class fill the table, the other symbols have the same targets.
+    table_.assign(num_of_states_ * num_of_classes_, sink);
+    for (State state{ 0 }; state < aut.delta.post_size(); ++state) {
+        const Symbol* symbol{ classes.symbols.data() };
+        for (const Mata::Nfa::Move& move: aut.delta[state]) {
+            const Symbol* const symbols_end{ classes.symbols.data() + classes.symbols.size() };
+            symbol = std::lower_bound(symbol, symbols_end, move.symbol);
+            const size_t index{ static_cast<size_t>(symbol - classes.symbols.data()) };
+            if (classes.is_first_of_class[index]) {
+                table_[state * num_of_classes_ + classes.symbol_classes[index]] = *move.targets.begin();
+            }
+        }
+    }
+    final_.assign(num_of_words(num_of_states_), 0);
+    for (const State state: aut.final) { set_final(state); }
+    set_symbol_classes(std::move(classes.symbols), std::move(classes.symbol_classes), num_of_classes_);
+}
+
+void Dfa::set_symbol_classes(std::vector<Symbol> symbols, std::vector<uint32_t> symbol_classes,
+                             const size_t num_of_classes) {
+    symbols_ = std::move(symbols);
+    symbol_classes_ = std::move(symbol_classes);
+
+    dense_classes_.clear();
+    symbols_are_dense_ = symbols_.empty() || symbols_.back() < DENSE_SYMBOL_LIMIT;
+    if (!symbols_.empty()) {
+        dense_classes_.assign(static_cast<size_t>(std::min(symbols_.back(), DENSE_SYMBOL_LIMIT - 1)) + 1, 0);
+        for (size_t i{ 0 }; i < symbols_.size() && symbols_[i] < dense_classes_.size(); ++i) {
+            dense_classes_[symbols_[i]] = symbol_classes_[i];
+        }
+    }
+
+    // The smallest symbol of every class; symbols of the class 0 are those missing in 'symbols_'.
+    representatives_.assign(num_of_classes, 0);
+    std::vector<bool> has_representative(num_of_classes, false);
+    Symbol missing{ 0 };
+    for (size_t i{ 0 }; i < symbols_.size(); ++i) {
+        if (symbols_[i] == missing) { ++missing; }
+        if (!has_representative[symbol_classes_[i]]) {
+            has_representative[symbol_classes_[i]] = true;
+            representatives_[symbol_classes_[i]] = symbols_[i];
+        }
+    }
+    representatives_[0] = missing;
+}
+
+size_t Dfa::find_symbol_class(const Symbol symbol) const {
+    const auto found{ std::lower_bound(symbols_.begin(), symbols_.end(), symbol) };
+    if (found == symbols_.end() || *found != symbol) { return 0; }
+    return symbol_classes_[static_cast<size_t>(found - symbols_.begin())];
+}
+
+Mata::Nfa::Nfa Dfa::to_nfa() const {
+    Mata::Nfa::Nfa result{ num_of_states_ };
+    result.initial.add(initial_);
+    for (State state{ 0 }; state < num_of_states_; ++state) {
+        if (is_final(state)) { result.final.add(state); }
+    }
+    std::vector<Mata::Nfa::Trans> transitions{};
+    transitions.reserve(num_of_states_ * symbols_.size());
+    for (State state{ 0 }; state < num_of_states_; ++state) {
+        for (size_t i{ 0 }; i < symbols_.size(); ++i) {
+            transitions.emplace_back(state, symbols_[i], table_[state * num_of_classes_ + symbol_classes_[i]]);
+        }
+    }
+    result.delta.add_bulk(std::move(transitions));
+    return result;
+}
+
+Dfa Mata::Dfa::complement(const Dfa& aut) {
+    Dfa result{ aut };
+    for (uint64_t& word: result.final_) { word = ~word; }
+    if (result.num_of_states_ % 64 != 0) {
+        result.final_.back() &= (uint64_t{ 1 } << (result.num_of_states_ % 64)) - 1;
+    }
+    return result;
+}
+
+Dfa Mata::Dfa::product(const Dfa& lhs, const Dfa& rhs, bool (*is_final)(bool, bool)) {
+    // Classes of the product are the pairs of classes of symbols appearing in lhs or rhs, the class 0 is (0, 0).
+    std::vector<Symbol> symbols{};
+    std::set_union(lhs.symbols_.begin(), lhs.symbols_.end(), rhs.symbols_.begin(), rhs.symbols_.end(),
+                   std::back_inserter(symbols));
+    std::vector<uint32_t> symbol_classes{};
+    symbol_classes.reserve(symbols.size());
+    std::vector<std::pair<size_t, size_t>> class_pairs{ { 0, 0 } };
+    Mata::Util::FlatHashMap<std::pair<size_t, size_t>, uint32_t> class_ids{};
+    class_ids.emplace({ 0, 0 }, 0);
+    for (const Symbol symbol: symbols) {
+        const std::pair<size_t, size_t> class_pair{ lhs.symbol_class(symbol), rhs.symbol_class(symbol) };
+        const auto [class_id, inserted]{ class_ids.emplace(class_pair, static_cast<uint32_t>(class_pairs.size())) };
+        if (inserted) { class_pairs.push_back(class_pair); }
+        symbol_classes.push_back(class_id->second);
+    }
+
+    Dfa result{};
+    result.num_of_classes_ = class_pairs.size();
+    result.table_.clear();
+    std::vector<std::pair<State, State>> state_pairs{ { lhs.initial_, rhs.initial_ } };
+    Mata::Util::FlatHashMap<std::pair<State, State>, State> state_ids{};
+    state_ids.emplace(state_pairs.front(), 0);
+    // Pairs are processed in the order of their ids, so that rows of the table are appended in the same order.
+    for (State state{ 0 }; state < state_pairs.size(); ++state) {
+        const State lhs_state{ state_pairs[state].first };
+        const State rhs_state{ state_pairs[state].second };
+        for (const std::pair<size_t, size_t>& class_pair: class_pairs) {
+            const std::pair<State, State> target{ lhs.table_[lhs_state * lhs.num_of_classes_ + class_pair.first],
+                                                  rhs.table_[rhs_state * rhs.num_of_classes_ + class_pair.second] };
+            const auto [target_id, inserted]{ state_ids.emplace(target, static_cast<State>(state_pairs.size())) };
+            if (inserted) { state_pairs.push_back(target); }
+            result.table_.push_back(target_id->second);
+        }
+    }
+
+    result.num_of_states_ = state_pairs.size();
+    result.final_.assign(num_of_words(result.num_of_states_), 0);
+    for (State state{ 0 }; state < result.num_of_states_; ++state) {
+        if (is_final(lhs.is_final(state_pairs[state].first), rhs.is_final(state_pairs[state].second))) {
+            result.set_final(state);
+        }
+    }
+    result.set_symbol_classes(std::move(symbols), std::move(symbol_classes), result.num_of_classes_);
+    return result;
+}
+
+Dfa Mata::Dfa::intersection(const Dfa& lhs, const Dfa& rhs) {
+    return product(lhs, rhs, [](bool lhs_final, bool rhs_final) { return lhs_final && rhs_final; });
+}
+
+Dfa Mata::Dfa::uni(const Dfa& lhs, const Dfa& rhs) {
+    return product(lhs, rhs, [](bool lhs_final, bool rhs_final) { return lhs_final || rhs_final; });
+}
+
+bool Mata::Dfa::is_lang_empty(const Dfa& aut, Run* cex) {
+    // 'parents[q]' is the state from which q was reached and the class of the symbol it was reached over.
+    std::vector<std::pair<State, size_t>> parents(aut.num_of_states(), { UNVISITED, 0 });
+    parents[aut.initial()] = { aut.initial(), 0 };
+    std::vector<State> worklist{ aut.initial() };
+    // States are visited breadth-first (the worklist is never shrunk), so that the counterexample is shortest.
+    for (size_t next{ 0 }; next < worklist.size(); ++next) {
+        const State state{ worklist[next] };
+        if (aut.is_final(state)) {
+            if (cex != nullptr) {
+                cex->word.clear();
+                cex->path.clear();
+                for (State trav{ state }; parents[trav].first != trav; trav = parents[trav].first) {
+                    cex->word.push_back(aut.representative(parents[trav].second));
+                }
+                std::reverse(cex->word.begin(), cex->word.end());
+            }
+            return false;
+        }
+        for (size_t symbol_class{ 0 }; symbol_class < aut.num_of_symbol_classes(); ++symbol_class) {
+            const State target{ aut.successor(state, aut.representative(symbol_class)) };
+            if (parents[target].first == UNVISITED) {
+                parents[target] = { state, symbol_class };
+                worklist.push_back(target);
+            }
+        }
+    }
+    return true;
+}
+
+Dfa Mata::Dfa::compile(const Mata::Nfa::Nfa& aut) {
+    if (aut.initial.size() <= 1 && Mata::Nfa::is_deterministic(aut)) { return Dfa{ aut }; }
+    return Dfa{ Mata::Nfa::determinize(aut) };
+}
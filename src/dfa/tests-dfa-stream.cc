@@ -0,0 +1,136 @@
+/* tests-dfa-stream.cc -- Tests for resumable matching of byte streams
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <cstring>
+#include <random>
+
+#include "../3rdparty/catch.hpp"
+
+#include <mata/nfa.hh>
+#include <mata/dfa-stream.hh>
+
+using namespace Mata::Dfa;
+using Mata::Nfa::Nfa;
+
+namespace {
+    /// Automaton of streams starting with @p prefix and containing @p pattern after it.
+    Nfa prefix_and_pattern(const std::string& prefix, const std::string& pattern) {
+        Nfa aut{ prefix.size() + pattern.size() + 1 };
+        aut.initial = { 0 };
+        const State pattern_start{ static_cast<State>(prefix.size()) };
+        const State last{ static_cast<State>(prefix.size() + pattern.size()) };
+        aut.final = { last };
+        for (State state{ 0 }; state < prefix.size(); ++state) {
+            aut.delta.add(state, static_cast<unsigned char>(prefix[state]), state + 1);
+        }
+        for (State state{ 0 }; state < pattern.size(); ++state) {
+            aut.delta.add(pattern_start + state, static_cast<unsigned char>(pattern[state]), pattern_start + state + 1);
+        }
+        for (Symbol symbol{ 0 }; symbol < 256; ++symbol) {
+            aut.delta.add(pattern_start, symbol, pattern_start);
+            aut.delta.add(last, symbol, last);
+        }
+        return aut;
+    }
+
+    Mata::Nfa::Run to_run(const std::string& text) { return { { text.begin(), text.end() }, {} }; }
+} // namespace.
+
+TEST_CASE("Mata::Dfa::StreamAutomaton")
+{
+    const Nfa aut{ prefix_and_pattern("GET ", "passwd") };
+    const StreamAutomaton stream_aut{ aut };
+
+    SECTION("Chunks of a stream")
+    {
+        StreamMatcher matcher{ stream_aut };
+        CHECK(!matcher.is_accepting());
+        CHECK(matcher.can_still_accept());
+        matcher.feed("GE");
+        matcher.feed("T /etc/pas");
+        CHECK(!matcher.is_accepting());
+        CHECK(matcher.can_still_accept());
+        matcher.feed("swd HTTP/1.1");
+        CHECK(matcher.is_accepting());
+        matcher.feed("");
+        CHECK(matcher.is_accepting());
+
+        matcher.reset();
+        matcher.feed("POST /etc/passwd");
+        CHECK(!matcher.is_accepting());
+        CHECK(!matcher.can_still_accept());
+    }
+
+    SECTION("Stored stream states")
+    {
+        // Streams of a flow table are stored as bare states and resumed by new matchers.
+        std::vector<unsigned char> stored(sizeof(StreamState));
+        StreamMatcher first{ stream_aut };
+        first.feed("GET /pa");
+        const StreamState state{ first.get_state() };
+        std::memcpy(stored.data(), &state, sizeof(state));
+
+        StreamState loaded{};
+        std::memcpy(&loaded, stored.data(), sizeof(loaded));
+        CHECK(stream_aut.is_valid(loaded));
+        StreamMatcher resumed{ stream_aut, loaded };
+        resumed.feed("sswd");
+        CHECK(resumed.is_accepting());
+        CHECK(!stream_aut.is_valid(static_cast<StreamState>(stream_aut.num_of_states())));
+    }
+
+    SECTION("Byte maps")
+    {
+        // Upper-case and lower-case letters are the same symbols.
+        ByteMap byte_map{ identity_byte_map() };
+        for (char letter{ 'a' }; letter <= 'z'; ++letter) {
+            byte_map[static_cast<unsigned char>(letter)] = static_cast<Symbol>(letter - 'a' + 'A');
+        }
+        const StreamAutomaton case_insensitive{ prefix_and_pattern("GET ", "PASSWD"), byte_map };
+        StreamMatcher matcher{ case_insensitive };
+        matcher.feed("get /etc/PassWd");
+        CHECK(matcher.is_accepting());
+    }
+
+    SECTION("Random chunking")
+    {
+        std::mt19937 generator{ 42 };
+        const std::string alphabet{ "GET pasw" };
+        for (size_t round{ 0 }; round < 200; ++round) {
+            std::string text{ round % 2 == 0 ? "GET " : "" };
+            for (size_t length{ generator() % 30 }; length > 0; --length) {
+                text.push_back(alphabet[generator() % alphabet.size()]);
+            }
+            if (round % 5 == 0) { text.insert(text.size() / 2, "passwd"); }
+
+            StreamMatcher matcher{ stream_aut };
+            bool could_accept{ true };
+            // Chunks may be empty.
+            for (size_t position{ 0 }; position < text.size();) {
+                const size_t length{ std::min<size_t>(generator() % 5, text.size() - position) };
+                matcher.feed(std::string_view{ text }.substr(position, length));
+                position += length;
+                const bool accepting{ Mata::Nfa::is_in_lang(aut, to_run(text.substr(0, position))) };
+                CHECK(matcher.is_accepting() == accepting);
+                // Once rejected early, a stream is never accepted.
+                if (!could_accept) { CHECK(!accepting); }
+                could_accept = matcher.can_still_accept();
+                if (accepting) { CHECK(could_accept); }
+            }
+        }
+    }
+}
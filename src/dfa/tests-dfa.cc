@@ -0,0 +1,129 @@
+/* tests-dfa.cc -- Tests for deterministic automata with a dense transition table
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <random>
+
+#include "../3rdparty/catch.hpp"
+
+#include <mata/nfa.hh>
+#include <mata/dfa.hh>
+
+#include "../tests-utils.hh"
+
+using namespace Mata::Dfa;
+using Mata::Nfa::Nfa;
+using Mata::Tests::random_aut;
+using Mata::Tests::random_word;
+
+TEST_CASE("Mata::Dfa::Dfa")
+{
+    // Accepts words over {a, b, c} ending with 'a'; 'b' and 'c' behave the same.
+    Nfa aut{ 2 };
+    aut.initial = { 0 };
+    aut.final = { 1 };
+    aut.delta.add(0, 'a', 1);
+    aut.delta.add(0, 'b', 0);
+    aut.delta.add(0, 'c', 0);
+    aut.delta.add(1, 'a', 1);
+    aut.delta.add(1, 'b', 0);
+    aut.delta.add(1, 'c', 0);
+
+    SECTION("Compilation of a deterministic NFA")
+    {
+        const Dfa dfa{ aut };
+        CHECK(dfa.num_of_states() == 3); // Two states and the sink.
+        CHECK(dfa.num_of_symbol_classes() == 3); // Other symbols, {a}, {b, c}.
+        CHECK(dfa.symbol_class('b') == dfa.symbol_class('c'));
+        CHECK(dfa.symbol_class('a') != dfa.symbol_class('b'));
+        CHECK(dfa.symbol_class('z') == 0);
+        CHECK(dfa.symbol_class(1000000) == 0);
+        CHECK(dfa.representative(0) == 0);
+        CHECK(dfa.representative(dfa.symbol_class('c')) == 'b');
+
+        CHECK(dfa.run(Run{ { 'a' }, {} }));
+        CHECK(dfa.run(Run{ { 'b', 'c', 'a' }, {} }));
+        CHECK(!dfa.run(Run{ { 'a', 'b' }, {} }));
+        CHECK(!dfa.run(Run{ { 'a', 'z', 'a' }, {} }));
+        CHECK(!dfa.run(Run{}));
+
+        const Nfa back{ dfa.to_nfa() };
+        CHECK(Mata::Nfa::is_deterministic(back));
+        CHECK(Mata::Nfa::are_equivalent(back, aut));
+    }
+
+    SECTION("Non-deterministic automata are rejected")
+    {
+        Nfa nondeterministic{ aut };
+        nondeterministic.delta.add(0, 'a', 0);
+        CHECK_THROWS_AS(Dfa{ nondeterministic }, std::runtime_error);
+        nondeterministic = aut;
+        nondeterministic.initial.add(1);
+        CHECK_THROWS_AS(Dfa{ nondeterministic }, std::runtime_error);
+        CHECK(compile(nondeterministic).run(Run{ {}, {} }));
+    }
+
+    SECTION("Emptiness, complement and products")
+    {
+        const Dfa dfa{ aut };
+        Run cex{};
+        CHECK(!is_lang_empty(dfa, &cex));
+        CHECK(cex.word == std::vector<Symbol>{ 'a' });
+        CHECK(is_lang_empty(Dfa{}));
+
+        const Dfa dfa_complement{ complement(dfa) };
+        CHECK(!is_lang_empty(dfa_complement, &cex));
+        CHECK(cex.word.empty());
+        CHECK(dfa_complement.run(Run{ { 'a', 'z' }, {} }));
+        CHECK(is_lang_empty(intersection(dfa, dfa_complement)));
+        CHECK(is_lang_empty(complement(uni(dfa, dfa_complement))));
+    }
+
+    SECTION("Random automata")
+    {
+        std::mt19937 generator{ 42 };
+        // Symbols both below and above the limit of the dense lookup of symbol classes.
+        const std::vector<Symbol> symbols{ 0, 1, 2, Dfa::DENSE_SYMBOL_LIMIT + 5 };
+        // Words also contain the symbol 7, which is not in any automaton.
+        const std::vector<Symbol> word_symbols{ 0, 1, 2, Dfa::DENSE_SYMBOL_LIMIT + 5, 7 };
+        for (size_t round{ 0 }; round < 30; ++round) {
+            const Nfa lhs{ random_aut(generator, 3 + round % 5, symbols, 1, 1, 2) };
+            const Nfa rhs{ random_aut(generator, 3 + round % 7, { 1, 2, 3 }, 1, 1, 2) };
+            const Dfa lhs_dfa{ compile(lhs) };
+            const Dfa rhs_dfa{ compile(rhs) };
+            const Dfa both{ intersection(lhs_dfa, rhs_dfa) };
+            const Dfa either{ uni(lhs_dfa, rhs_dfa) };
+            const Dfa lhs_complement{ complement(lhs_dfa) };
+            for (size_t i{ 0 }; i < 50; ++i) {
+                const Run word{ random_word(generator, word_symbols, 7) };
+                const bool in_lhs{ Mata::Nfa::is_in_lang(lhs, word) };
+                const bool in_rhs{ Mata::Nfa::is_in_lang(rhs, word) };
+                CHECK(lhs_dfa.run(word) == in_lhs);
+                CHECK(lhs_complement.run(word) == !in_lhs);
+                CHECK(both.run(word) == (in_lhs && in_rhs));
+                CHECK(either.run(word) == (in_lhs || in_rhs));
+            }
+
+            Run cex{};
+            const bool empty{ Mata::Nfa::is_lang_empty(Mata::Nfa::intersection(lhs, rhs)) };
+            CHECK(is_lang_empty(both, &cex) == empty);
+            if (!empty) {
+                CHECK(Mata::Nfa::is_in_lang(lhs, cex));
+                CHECK(Mata::Nfa::is_in_lang(rhs, cex));
+            }
+        }
+    }
+}
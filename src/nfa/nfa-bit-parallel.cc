@@ -0,0 +1,201 @@
+/* nfa-bit-parallel.cc -- matching words with small NFAs by bit-parallel simulation
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+// MATA headers
+#include <mata/bits.hh>
+#include <mata/nfa-algorithms.hh>
+#include <mata/nfa-bit-parallel.hh>
+
+using namespace Mata::Nfa;
+using Mata::Util::lowest_bit;
+
+namespace {
+    void set_bit(uint64_t* mask, const State state) { mask[state / 64] |= uint64_t{ 1 } << (state % 64); }
+}
+
+constexpr size_t BitParallelMatcher::MAX_STATES;
+constexpr Symbol BitParallelMatcher::DENSE_SYMBOL_LIMIT;
+constexpr size_t BitParallelMatcher::MAX_WORDS;
+
+BitParallelMatcher::BitParallelMatcher(const Nfa& aut, const ByteMap& byte_map)
+    : num_of_states_{ aut.delta.post_size() }, num_of_words_{ 1 }, num_of_classes_{ 1 }, initial_{}, final_{},
+      successors_{}, symbols_{}, symbol_classes_{}, dense_classes_{}, byte_classes_{}, follow_bytes_{}, entered_{} {
+    for (State state{ 0 }; state < aut.delta.post_size(); ++state) {
+        for (const Move& move: aut.delta[state]) {
+            if (!move.targets.empty()) {
+                num_of_states_ = std::max(num_of_states_, static_cast<size_t>(move.targets.back()) + 1);
+            }
+        }
+    }
+    for (const State state: aut.initial) { num_of_states_ = std::max(num_of_states_, static_cast<size_t>(state) + 1); }
+    for (const State state: aut.final) { num_of_states_ = std::max(num_of_states_, static_cast<size_t>(state) + 1); }
+    if (num_of_states_ > MAX_STATES) {
+        throw std::length_error(std::string(__func__) + ": the automaton has " + std::to_string(num_of_states_)
+                                + " states, at most " + std::to_string(MAX_STATES) + " are supported");
+    }
+    num_of_words_ = std::max(size_t{ 1 }, (num_of_states_ + 63) / 64);
+    initial_.assign(num_of_words_, 0);
+    final_.assign(num_of_words_, 0);
+    for (const State state: aut.initial) { set_bit(initial_.data(), state); }
+    for (const State state: aut.final) { set_bit(final_.data(), state); }
+
+    // Table 'c' holds masks of successors of all states under the symbols of the class c; the class 0 has none. Only
+    //  moves over the first symbol of every class fill the tables, the other symbols have the same targets.
+    Algorithms::SymbolClasses classes{ Algorithms::compute_symbol_classes(aut) };
+    num_of_classes_ = classes.num_of_classes;
+    const size_t table_size{ num_of_states_ * num_of_words_ };
+    successors_.assign(num_of_classes_ * table_size, 0);
+    for (State state{ 0 }; state < aut.delta.post_size(); ++state) {
+        const Symbol* symbol{ classes.symbols.data() };
+        const Symbol* const symbols_end{ classes.symbols.data() + classes.symbols.size() };
+        for (const Move& move: aut.delta[state]) {
+            symbol = std::lower_bound(symbol, symbols_end, move.symbol);
+            const size_t index{ static_cast<size_t>(symbol - classes.symbols.data()) };
+            if (!classes.is_first_of_class[index]) { continue; }
+            uint64_t* const mask{ successors_.data() + classes.symbol_classes[index] * table_size
+                                  + state * num_of_words_ };
+            for (const State target: move.targets) { set_bit(mask, target); }
+        }
+    }
+    symbols_ = std::move(classes.symbols);
+    symbol_classes_ = std::move(classes.symbol_classes);
+
+    if (!symbols_.empty()) {
+        dense_classes_.assign(static_cast<size_t>(std::min(symbols_.back(), DENSE_SYMBOL_LIMIT - 1)) + 1, 0);
+        for (size_t i{ 0 }; i < symbols_.size() && symbols_[i] < dense_classes_.size(); ++i) {
+            dense_classes_[symbols_[i]] = symbol_classes_[i];
+        }
+    }
+    for (size_t byte{ 0 }; byte < byte_classes_.size(); ++byte) { byte_classes_[byte] = symbol_class(byte_map[byte]); }
+
+    compile_shift_and();
+}
+
+void BitParallelMatcher::compile_shift_and() {
+    if (num_of_words_ != 1) { return; }
+
+    // The automaton is simulated as in Shift-And iff the successors of every state q under every class c are the
+    //  successors of q under any class restricted to the states entered over c.
+    std::vector<uint64_t> follow(num_of_states_, 0);
+    std::vector<uint64_t> entered(num_of_classes_, 0);
+    for (size_t symbol_class{ 0 }; symbol_class < num_of_classes_; ++symbol_class) {
+        for (State state{ 0 }; state < num_of_states_; ++state) {
+            follow[state] |= successors_[symbol_class * num_of_states_ + state];
+            entered[symbol_class] |= successors_[symbol_class * num_of_states_ + state];
+        }
+    }
+    for (size_t symbol_class{ 0 }; symbol_class < num_of_classes_; ++symbol_class) {
+        for (State state{ 0 }; state < num_of_states_; ++state) {
+            if (successors_[symbol_class * num_of_states_ + state] != (follow[state] & entered[symbol_class])) {
+                return;
+            }
+        }
+    }
+
+    const size_t num_of_bytes{ (num_of_states_ + 7) / 8 };
+    follow_bytes_.assign(256 * num_of_bytes, 0);
+    for (size_t byte_index{ 0 }; byte_index < num_of_bytes; ++byte_index) {
+        uint64_t* const table{ follow_bytes_.data() + 256 * byte_index };
+        for (size_t byte{ 1 }; byte < 256; ++byte) {
+            // The successors of a byte are the successors of its lowest state and of the byte without it.
+            const size_t lowest{ lowest_bit(byte) };
+            const State state{ static_cast<State>(8 * byte_index + lowest) };
+            table[byte] = table[byte & (byte - 1)] | (state < num_of_states_ ? follow[state] : 0);
+        }
+    }
+    entered_ = std::move(entered);
+}
+
+uint32_t BitParallelMatcher::symbol_class(const Symbol symbol) const {
+    if (symbol < dense_classes_.size()) { return dense_classes_[symbol]; }
+    if (symbols_.empty() || symbols_.back() < DENSE_SYMBOL_LIMIT) { return 0; }
+    const auto found{ std::lower_bound(symbols_.begin(), symbols_.end(), symbol) };
+    if (found == symbols_.end() || *found != symbol) { return 0; }
+    return symbol_classes_[static_cast<size_t>(found - symbols_.begin())];
+}
+
+template<class ClassOf>
+bool BitParallelMatcher::run(const size_t length, ClassOf class_of, const bool prefix) const {
+    if (is_shift_and()) {
+        const uint64_t final{ final_[0] };
+        uint64_t current{ initial_[0] };
+        for (size_t position{ 0 }; position < length; ++position) {
+            if (prefix && (current & final) != 0) { return true; }
+            uint64_t next{ 0 };
+            const uint64_t* table{ follow_bytes_.data() };
+            for (uint64_t rest{ current }; rest != 0; rest >>= 8, table += 256) { next |= table[rest & 255]; }
+            current = next & entered_[class_of(position)];
+            if (current == 0) { return false; }
+        }
+        return (current & final) != 0;
+    }
+
+    const size_t num_of_words{ num_of_words_ };
+    const auto intersects_final = [&](const uint64_t* mask) {
+        for (size_t word{ 0 }; word < num_of_words; ++word) {
+            if ((mask[word] & final_[word]) != 0) { return true; }
+        }
+        return false;
+    };
+    uint64_t current[MAX_WORDS];
+    uint64_t next[MAX_WORDS];
+    std::copy(initial_.begin(), initial_.end(), current);
+    for (size_t position{ 0 }; position < length; ++position) {
+        if (prefix && intersects_final(current)) { return true; }
+        std::fill(next, next + num_of_words, 0);
+        const uint64_t* const successors{ successors_.data() + class_of(position) * num_of_states_ * num_of_words };
+        bool is_empty{ true };
+        for (size_t word{ 0 }; word < num_of_words; ++word) {
+            for (uint64_t bits{ current[word] }; bits != 0; bits &= bits - 1) {
+                const uint64_t* const mask{ successors + (64 * word + lowest_bit(bits)) * num_of_words };
+                for (size_t target_word{ 0 }; target_word < num_of_words; ++target_word) {
+                    next[target_word] |= mask[target_word];
+                }
+                is_empty = false;
+            }
+        }
+        if (is_empty) { return false; }
+        std::copy(next, next + num_of_words, current);
+    }
+    return intersects_final(current);
+}
+
+bool BitParallelMatcher::is_in_lang(const Symbol* first, const Symbol* last) const {
+    return run(static_cast<size_t>(last - first), [&](size_t position) { return symbol_class(first[position]); },
+               false);
+}
+
+bool BitParallelMatcher::is_prfx_in_lang(const Symbol* first, const Symbol* last) const {
+    return run(static_cast<size_t>(last - first), [&](size_t position) { return symbol_class(first[position]); },
+               true);
+}
+
+bool BitParallelMatcher::is_in_lang(const std::string_view input) const {
+    return run(input.size(), [&](size_t position) {
+        return byte_classes_[static_cast<unsigned char>(input[position])];
+    }, false);
+}
+
+bool BitParallelMatcher::is_prfx_in_lang(const std::string_view input) const {
+    return run(input.size(), [&](size_t position) {
+        return byte_classes_[static_cast<unsigned char>(input[position])];
+    }, true);
+}
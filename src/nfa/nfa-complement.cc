@@ -27,23 +27,15 @@ Nfa Mata::Nfa::Algorithms::complement_classical(
 	const Alphabet&    alphabet,
 	std::unordered_map<StateSet, State>* subset_map)
 { // {{{
- 	Nfa result;
-
- 	bool delete_subset_map = false;
-	if  (nullptr == subset_map)
-	{
-		subset_map = new std::unordered_map<StateSet, State>();
-		delete_subset_map = true;
-	}
-
-	result = determinize(aut, subset_map);
+	SubsetMap flat_subset_map{};
+	Nfa result = determinize_classical(aut, flat_subset_map);
 	State sink_state = result.delta.post_size() + 1;
 	result.increase_size(sink_state+1);
 	assert(sink_state < result.delta.post_size());
-	auto it_inserted_pair = subset_map->insert({{}, sink_state});
-	if (!it_inserted_pair.second)
+	const auto [sink_id, inserted] = flat_subset_map.emplace(nullptr, nullptr, sink_state);
+	if (!inserted)
 	{
-		sink_state = it_inserted_pair.first->second;
+		sink_state = flat_subset_map.get_value(sink_id);
 	}
 
 	make_complete(result, alphabet, sink_state);
@@ -65,9 +57,9 @@ Nfa Mata::Nfa::Algorithms::complement_classical(
                 make_final_if_not_in_old(trs.tgt);
 	}
 
-	if (delete_subset_map)
+	if (nullptr != subset_map)
 	{
-		delete subset_map;
+		flat_subset_map.move_to(*subset_map);
 	}
 
 	return result;
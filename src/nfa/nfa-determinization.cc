@@ -0,0 +1,259 @@
+/* nfa-determinization.cc -- Parallel NFA determinization
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+// MATA headers
+#include <mata/nfa.hh>
+#include <mata/nfa-algorithms.hh>
+#include <mata/nfa-post-image.hh>
+
+using namespace Mata::Nfa;
+using namespace Mata::Util;
+
+namespace {
+    /// Number of frontier macrostates a thread claims at once.
+    constexpr size_t CHUNK_SIZE{ 16 };
+
+    /// Macrostate waiting to be expanded.
+    struct FrontierItem {
+        State id;
+        StateSet states;
+    };
+
+    /**
+     * Compute successors of @p macrostate in @p aut over all symbols, ordered by symbols.
+     *
+     * The engine makes only const accesses within the transition relation, so that the function can be called
+     *  concurrently with an engine per thread.
+     */
+    void compute_successors(const Nfa& aut, const StateSet& macrostate, PostImageEngine& post_image,
+                            std::vector<std::pair<Symbol, StateSet>>& successors) {
+        successors.clear();
+        post_image.start(aut.delta, macrostate);
+        while (post_image.next()) {
+            StateSet targets{ StateSet::with_reserved(post_image.size()) };
+            for (const State target: post_image) { targets.push_back(target); }
+            successors.emplace_back(post_image.symbol(), std::move(targets));
+        }
+    }
+
+    bool is_final_macrostate(const Nfa& aut, const StateSet& macrostate) {
+        return std::any_of(macrostate.begin(), macrostate.end(), [&aut](State q) { return aut.final[q]; });
+    }
+
+    /**
+     * Run @p process(item_index, thread_index) for all items [0, @p num_of_items) on @p num_of_threads threads.
+     * Threads claim chunks of items from a shared atomic counter, so that faster threads take over the remaining work.
+     */
+    template<typename Function>
+    void parallel_for(size_t num_of_items, size_t num_of_threads, const Function& process) {
+        std::atomic<size_t> next_item{ 0 };
+        const auto worker = [&](size_t thread_index) {
+            for (size_t begin{ next_item.fetch_add(CHUNK_SIZE) }; begin < num_of_items;
+                 begin = next_item.fetch_add(CHUNK_SIZE)) {
+                const size_t end{ std::min(begin + CHUNK_SIZE, num_of_items) };
+                for (size_t item{ begin }; item < end; ++item) { process(item, thread_index); }
+            }
+        };
+
+        const size_t num_of_spawned{ std::min(num_of_threads, (num_of_items + CHUNK_SIZE - 1) / CHUNK_SIZE) };
+        if (num_of_spawned <= 1) {
+            worker(0);
+            return;
+        }
+        std::vector<std::thread> threads{};
+        threads.reserve(num_of_spawned - 1);
+        for (size_t thread_index{ 1 }; thread_index < num_of_spawned; ++thread_index) {
+            threads.emplace_back(worker, thread_index);
+        }
+        worker(0);
+        for (std::thread& thread: threads) { thread.join(); }
+    }
+
+    /**
+     * Subset map split into independently locked shards.
+     */
+    class ShardedSubsetMap {
+    public:
+        explicit ShardedSubsetMap(size_t num_of_shards) : shards_(num_of_shards) {}
+
+        /**
+         * Get the id of @p macrostate, assigning a new id from @p next_id if the macrostate is not in the map yet.
+         * @return Pair of the id and whether the id is new.
+         */
+        std::pair<State, bool> get_or_insert(const StateSet& macrostate, std::atomic<State>& next_id) {
+            Shard& shard{ shards_[std::hash<StateSet>{}(macrostate) % shards_.size()] };
+            std::lock_guard<std::mutex> lock{ shard.mutex };
+            const auto it{ shard.map.find(macrostate) };
+            if (it != shard.map.end()) { return { it->second, false }; }
+            const State id{ next_id.fetch_add(1) };
+            shard.map.emplace(macrostate, id);
+            return { id, true };
+        }
+
+        void insert(const StateSet& macrostate, State id) {
+            shards_[std::hash<StateSet>{}(macrostate) % shards_.size()].map.emplace(macrostate, id);
+        }
+
+        void move_to(std::unordered_map<StateSet, State>& subset_map) {
+            for (Shard& shard: shards_) {
+                for (auto& [macrostate, id]: shard.map) { subset_map.emplace(macrostate, id); }
+                shard.map.clear();
+            }
+        }
+
+    private:
+        struct Shard {
+            std::mutex mutex{};
+            std::unordered_map<StateSet, State> map{};
+        };
+        std::vector<Shard> shards_;
+    };
+}
+
+Nfa Mata::Nfa::Algorithms::determinize_parallel(
+        const Nfa& aut,
+        size_t num_of_threads,
+        bool deterministic_numbering,
+        std::unordered_map<StateSet, State>* subset_map)
+{ // {{{
+    if (num_of_threads == 0) { num_of_threads = std::max(1u, std::thread::hardware_concurrency()); }
+
+    const StateSet initial_macrostate{ aut.initial };
+    std::vector<bool> final_states{ is_final_macrostate(aut, initial_macrostate) };
+    std::vector<FrontierItem> frontier{ { 0, initial_macrostate } };
+    std::vector<TransSequence> thread_trans(num_of_threads);
+    std::unordered_map<StateSet, State> det_subset_map{};
+    ShardedSubsetMap sharded_subset_map{ deterministic_numbering ? 1 : 8 * num_of_threads };
+    if (deterministic_numbering) {
+        det_subset_map.emplace(initial_macrostate, 0);
+    } else {
+        sharded_subset_map.insert(initial_macrostate, 0);
+    }
+    std::atomic<State> next_id{ 1 };
+
+    std::vector<PostImageEngine> post_images(num_of_threads);
+    std::vector<std::vector<std::pair<Symbol, StateSet>>> thread_successors(num_of_threads);
+
+    // Frontiers are processed level by level.
+    while (!frontier.empty()) {
+        std::vector<FrontierItem> next_frontier{};
+        if (deterministic_numbering) {
+            // Successors are computed in parallel, new macrostates are numbered sequentially in the frontier order.
+            std::vector<std::vector<std::pair<Symbol, StateSet>>> successors(frontier.size());
+            parallel_for(frontier.size(), num_of_threads, [&](size_t item, size_t thread_index) {
+                compute_successors(aut, frontier[item].states, post_images[thread_index], successors[item]);
+            });
+            for (size_t item{ 0 }; item < frontier.size(); ++item) {
+                for (auto& [symbol, macrostate]: successors[item]) {
+                    const auto [it, inserted]{ det_subset_map.emplace(macrostate, next_id.load()) };
+                    if (inserted) {
+                        ++next_id;
+                        final_states.push_back(is_final_macrostate(aut, macrostate));
+                        next_frontier.push_back({ it->second, std::move(macrostate) });
+                    }
+                    thread_trans[0].emplace_back(frontier[item].id, symbol, it->second);
+                }
+            }
+        } else {
+            // Macrostates are numbered concurrently in the sharded subset map.
+            std::vector<std::vector<FrontierItem>> thread_frontiers(num_of_threads);
+            parallel_for(frontier.size(), num_of_threads, [&](size_t item, size_t thread_index) {
+                auto& successors{ thread_successors[thread_index] };
+                compute_successors(aut, frontier[item].states, post_images[thread_index], successors);
+                for (auto& [symbol, macrostate]: successors) {
+                    const auto [id, inserted]{ sharded_subset_map.get_or_insert(macrostate, next_id) };
+                    if (inserted) { thread_frontiers[thread_index].push_back({ id, std::move(macrostate) }); }
+                    thread_trans[thread_index].emplace_back(frontier[item].id, symbol, id);
+                }
+            });
+            final_states.resize(next_id.load(), false);
+            for (auto& items: thread_frontiers) {
+                for (FrontierItem& frontier_item: items) {
+                    final_states[frontier_item.id] = is_final_macrostate(aut, frontier_item.states);
+                    next_frontier.push_back(std::move(frontier_item));
+                }
+            }
+        }
+        frontier = std::move(next_frontier);
+    }
+
+    // Merge per-thread transition buffers.
+    const size_t num_of_det_states{ next_id.load() };
+    Nfa result{ num_of_det_states };
+    result.initial.add(0);
+    for (State state{ 0 }; state < num_of_det_states; ++state) {
+        if (final_states[state]) { result.final.add(state); }
+    }
+    // Each macrostate is expanded by a single thread, so buffers have disjoint sources and are added one by one.
+    for (TransSequence& transitions: thread_trans) { result.delta.add_bulk(std::move(transitions)); }
+
+    if (subset_map != nullptr) {
+        if (deterministic_numbering) {
+            *subset_map = std::move(det_subset_map);
+        } else {
+            subset_map->clear();
+            sharded_subset_map.move_to(*subset_map);
+        }
+    }
+
+    return result;
+} // determinize_parallel }}}
+
+Nfa Mata::Nfa::determinize(
+        const Nfa&        aut,
+        const StringMap&  params,
+        std::unordered_map<StateSet, State>* subset_map)
+{ // {{{
+    size_t num_of_threads{ 1 };
+    if (haskey(params, "threads")) {
+        const std::string& threads{ params.at("threads") };
+        long requested_threads{ 0 };
+        size_t parsed_length{ 0 };
+        try {
+            requested_threads = std::stol(threads, &parsed_length);
+        } catch (const std::logic_error&) {
+            parsed_length = 0;
+        }
+        if (parsed_length == 0 || parsed_length != threads.size() || requested_threads < 1) {
+            throw std::runtime_error(std::to_string(__func__) +
+                                     " received an invalid value of the \"threads\" key: " + threads);
+        }
+        // More threads than the hardware runs concurrently only add contention and per-thread buffers.
+        num_of_threads = std::min(static_cast<size_t>(requested_threads),
+                                  static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())));
+    }
+
+    bool deterministic_numbering{ true };
+    if (haskey(params, "numbering")) {
+        const std::string& numbering = params.at("numbering");
+        if ("deterministic" == numbering) { /* default */ }
+        else if ("arbitrary" == numbering) {
+            deterministic_numbering = false;
+        } else {
+            throw std::runtime_error(std::to_string(__func__) +
+                                     " received an unknown value of the \"numbering\" key: " + numbering);
+        }
+    }
+
+    if (num_of_threads == 1 && !haskey(params, "numbering")) { return determinize(aut, subset_map); }
+    return Algorithms::determinize_parallel(aut, num_of_threads, deterministic_numbering, subset_map);
+} // determinize }}}
@@ -0,0 +1,324 @@
+/* nfa-frozen.cc -- read-only algorithms over frozen NFAs
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <deque>
+
+// MATA headers
+#include <mata/nfa-frozen.hh>
+#include <mata/flat-hash-map.hh>
+
+using namespace Mata::Nfa;
+using namespace Mata::Util;
+
+namespace {
+    /**
+     * Collect targets of the moves selected by @p moves into a sorted vector without duplicates.
+     * @param[in] delta Frozen transition relation.
+     * @param[in] moves Positions in @c delta.symbols of the moves to collect targets from.
+     * @param[out] targets Vector to store the collected targets to (cleared first).
+     */
+    void collect_targets(const FrozenDelta& delta, const std::vector<const Symbol*>& moves,
+                         std::vector<State>& targets) {
+        targets.clear();
+        for (const Symbol* const move_position: moves) {
+            const StateRange move_targets{ delta.targets_of(static_cast<size_t>(move_position - delta.symbols.data())) };
+            targets.insert(targets.end(), move_targets.begin(), move_targets.end());
+        }
+        if (moves.size() > 1) {
+            std::sort(targets.begin(), targets.end());
+            targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+        }
+    }
+}
+
+FrozenDelta::FrozenDelta(const Delta& delta, size_t num_of_states) {
+    const size_t post_size{ delta.post_size() };
+    num_of_states = std::max(num_of_states, post_size);
+    state_offsets.reserve(num_of_states + 1);
+
+    for (State state{ 0 }; state < post_size; ++state) {
+        for (const Move& move: delta[state]) {
+            symbols.push_back(move.symbol);
+            targets.insert(targets.end(), move.targets.begin(), move.targets.end());
+            move_offsets.push_back(targets.size());
+            // Targets are ordered, the last one is the largest.
+            if (!move.targets.empty()) {
+                num_of_states = std::max(num_of_states, static_cast<size_t>(move.targets.back()) + 1);
+            }
+        }
+        state_offsets.push_back(symbols.size());
+    }
+    // States without any outgoing transitions (beyond the size of delta).
+    state_offsets.resize(num_of_states + 1, symbols.size());
+}
+
+size_t FrozenDelta::find_move(const State state, const Symbol symbol) const {
+    const auto moves_first{ symbols.begin() + static_cast<long>(moves_begin(state)) };
+    const auto moves_last{ symbols.begin() + static_cast<long>(moves_end(state)) };
+    const auto move{ std::lower_bound(moves_first, moves_last, symbol) };
+    if (move == moves_last || *move != symbol) { return npos; }
+    return static_cast<size_t>(move - symbols.begin());
+}
+
+FrozenNfa::FrozenNfa(const Nfa& aut)
+    : delta(aut.delta, std::max({ aut.delta.post_size(),
+                                  static_cast<size_t>(aut.initial.domain_size()),
+                                  static_cast<size_t>(aut.final.domain_size()) })),
+      initial(aut.initial), final(aut.final) {}
+
+StateSet FrozenNfa::post(const StateSet& states, const Symbol symbol) const {
+    std::vector<State> targets{};
+    for (const State state: states) {
+        const StateRange state_post{ delta.post(state, symbol) };
+        targets.insert(targets.end(), state_post.begin(), state_post.end());
+    }
+    return StateSet(targets);
+}
+
+bool Mata::Nfa::is_lang_empty(const FrozenNfa& aut, Run* cex) {
+    const size_t num_of_states{ aut.num_of_states() };
+    constexpr State NO_PREDECESSOR{ std::numeric_limits<State>::max() };
+
+    // 'predecessor[s] == t' denotes that state 's' was accessed from state 't' over 'symbol_to[s]',
+    // 'predecessor[s] == s' means that 's' is an initial state.
+    std::vector<State> predecessor(num_of_states, NO_PREDECESSOR);
+    std::vector<Symbol> symbol_to(num_of_states);
+    std::deque<State> worklist{};
+    for (const State state: aut.initial) {
+        worklist.push_back(state);
+        predecessor[state] = state;
+    }
+
+    while (!worklist.empty()) {
+        State state{ worklist.front() };
+        worklist.pop_front();
+
+        if (aut.final[state]) {
+            if (nullptr != cex) {
+                cex->path.clear();
+                cex->word.clear();
+                cex->path.push_back(state);
+                while (predecessor[state] != state) {
+                    cex->word.push_back(symbol_to[state]);
+                    state = predecessor[state];
+                    cex->path.push_back(state);
+                }
+                std::reverse(cex->path.begin(), cex->path.end());
+                std::reverse(cex->word.begin(), cex->word.end());
+            }
+            return false;
+        }
+
+        for (size_t move{ aut.delta.moves_begin(state) }, moves_end{ aut.delta.moves_end(state) };
+             move < moves_end; ++move) {
+            for (const State target: aut.delta.targets_of(move)) {
+                if (predecessor[target] == NO_PREDECESSOR) {
+                    predecessor[target] = state;
+                    symbol_to[target] = aut.delta.symbol(move);
+                    worklist.push_back(target);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+Nfa Mata::Nfa::intersection(const FrozenNfa& lhs, const FrozenNfa& rhs,
+                            std::unordered_map<std::pair<State, State>, State>* prod_map) {
+    Nfa product{};
+    FlatHashMap<std::pair<State, State>, State> product_map{};
+    std::vector<std::pair<State, State>> worklist{};
+
+    auto get_product_state = [&](const State lhs_state, const State rhs_state) {
+        const auto it_inserted{ product_map.emplace(std::make_pair(lhs_state, rhs_state), product.delta.post_size()) };
+        const State product_state{ it_inserted.first->second };
+        if (it_inserted.second) {
+            product.add_state();
+            worklist.emplace_back(lhs_state, rhs_state);
+            if (lhs.final[lhs_state] && rhs.final[rhs_state]) {
+                product.final.add(product_state);
+            }
+        }
+        return product_state;
+    };
+
+    for (const State lhs_initial_state: lhs.initial) {
+        for (const State rhs_initial_state: rhs.initial) {
+            product.initial.add(get_product_state(lhs_initial_state, rhs_initial_state));
+        }
+    }
+
+    std::vector<State> targets{};
+    while (!worklist.empty()) {
+        const std::pair<State, State> pair_to_process{ worklist.back() };
+        worklist.pop_back();
+        const State product_state{ product_map.find(pair_to_process)->second };
+
+        // Merge-join moves of both states; both ranges are ordered by symbols.
+        size_t lhs_move{ lhs.delta.moves_begin(pair_to_process.first) };
+        const size_t lhs_moves_end{ lhs.delta.moves_end(pair_to_process.first) };
+        size_t rhs_move{ rhs.delta.moves_begin(pair_to_process.second) };
+        const size_t rhs_moves_end{ rhs.delta.moves_end(pair_to_process.second) };
+        while (lhs_move < lhs_moves_end && rhs_move < rhs_moves_end) {
+            const Symbol lhs_symbol{ lhs.delta.symbol(lhs_move) };
+            const Symbol rhs_symbol{ rhs.delta.symbol(rhs_move) };
+            if (lhs_symbol < rhs_symbol) { ++lhs_move; continue; }
+            if (rhs_symbol < lhs_symbol) { ++rhs_move; continue; }
+
+            targets.clear();
+            for (const State lhs_target: lhs.delta.targets_of(lhs_move)) {
+                for (const State rhs_target: rhs.delta.targets_of(rhs_move)) {
+                    targets.push_back(get_product_state(lhs_target, rhs_target));
+                }
+            }
+            // Symbols are processed in an increasing order, the move is appended to the end of the post.
+            product.delta[product_state].insert(Move(lhs_symbol, TargetSet(targets)));
+            ++lhs_move;
+            ++rhs_move;
+        }
+    }
+
+    if (prod_map != nullptr) { product_map.move_to(*prod_map); }
+    return product;
+}
+
+Nfa Mata::Nfa::determinize(const FrozenNfa& aut, std::unordered_map<StateSet, State>* subset_map) {
+    Nfa result{};
+    std::unordered_map<StateSet, State> local_subset_map{};
+    if (subset_map == nullptr) { subset_map = &local_subset_map; }
+
+    std::vector<std::pair<State, StateSet>> worklist{};
+    const StateSet initial_set{ aut.initial };
+    const State initial_state{ result.add_state() };
+    result.initial.add(initial_state);
+    if (!are_disjoint(initial_set, aut.final)) { result.final.add(initial_state); }
+    (*subset_map)[initial_set] = initial_state;
+    worklist.emplace_back(initial_state, initial_set);
+
+    SynchronizedExistentialIterator<const Symbol*> synchronized_iterator{};
+    std::vector<State> targets{};
+    while (!worklist.empty()) {
+        const std::pair<State, StateSet> macrostate{ std::move(worklist.back()) };
+        worklist.pop_back();
+
+        synchronized_iterator.reset();
+        for (const State state: macrostate.second) {
+            synchronized_iterator.push_back(aut.delta.symbols.data() + aut.delta.moves_begin(state),
+                                            aut.delta.symbols.data() + aut.delta.moves_end(state));
+        }
+
+        while (synchronized_iterator.advance()) {
+            const std::vector<const Symbol*>& moves{ synchronized_iterator.get_current() };
+            const Symbol symbol{ *moves.front() };
+            collect_targets(aut.delta, moves, targets);
+            StateSet target_set{ targets };
+
+            const auto existing_target{ subset_map->find(target_set) };
+            State target_state;
+            if (existing_target != subset_map->end()) {
+                target_state = existing_target->second;
+            } else {
+                target_state = result.add_state();
+                if (!are_disjoint(target_set, aut.final)) { result.final.add(target_state); }
+                (*subset_map)[target_set] = target_state;
+                worklist.emplace_back(target_state, std::move(target_set));
+            }
+            result.delta[macrostate.first].insert(Move(symbol, target_state));
+        }
+    }
+
+    return result;
+}
+
+bool Mata::Nfa::is_included(const FrozenNfa& smaller, const FrozenNfa& bigger, Run* cex) {
+    using ProdStateType = std::pair<State, StateSet>;
+
+    auto subsumes = [](const ProdStateType& lhs, const ProdStateType& rhs) {
+        if (lhs.first != rhs.first || lhs.second.size() > rhs.second.size()) { return false; }
+        return lhs.second.IsSubsetOf(rhs.second);
+    };
+
+    std::deque<ProdStateType> worklist{};
+    std::deque<ProdStateType> processed{};
+    // 'paths[s] == t' denotes that state 's' was accessed from state 't',
+    // 'paths[s] == s' means that 's' is an initial state
+    std::map<ProdStateType, std::pair<ProdStateType, Symbol>> paths{};
+
+    const StateSet bigger_initial{ bigger.initial };
+    for (const State state: smaller.initial) {
+        if (smaller.final[state] && are_disjoint(bigger_initial, bigger.final)) {
+            if (cex != nullptr) { cex->word.clear(); }
+            return false;
+        }
+        const ProdStateType initial_state{ state, bigger_initial };
+        worklist.push_back(initial_state);
+        processed.push_back(initial_state);
+        if (cex != nullptr) { paths.insert({ initial_state, { initial_state, 0 } }); }
+    }
+
+    std::vector<State> bigger_targets{};
+    while (!worklist.empty()) {
+        const ProdStateType prod_state{ worklist.back() };
+        worklist.pop_back();
+
+        for (size_t move{ smaller.delta.moves_begin(prod_state.first) },
+                 moves_end{ smaller.delta.moves_end(prod_state.first) }; move < moves_end; ++move) {
+            const Symbol symbol{ smaller.delta.symbol(move) };
+            bigger_targets.clear();
+            for (const State bigger_state: prod_state.second) {
+                const StateRange bigger_post{ bigger.delta.post(bigger_state, symbol) };
+                bigger_targets.insert(bigger_targets.end(), bigger_post.begin(), bigger_post.end());
+            }
+            const StateSet bigger_succ{ bigger_targets };
+
+            for (const State smaller_succ: smaller.delta.targets_of(move)) {
+                const ProdStateType succ{ smaller_succ, bigger_succ };
+
+                if (smaller.final[smaller_succ] && are_disjoint(bigger_succ, bigger.final)) {
+                    if (cex != nullptr) {
+                        cex->word.clear();
+                        cex->word.push_back(symbol);
+                        ProdStateType trav{ prod_state };
+                        while (paths[trav].first != trav) { // go back until initial state
+                            cex->word.push_back(paths[trav].second);
+                            trav = paths[trav].first;
+                        }
+                        std::reverse(cex->word.begin(), cex->word.end());
+                    }
+                    return false;
+                }
+
+                if (std::any_of(processed.begin(), processed.end(),
+                                [&](const ProdStateType& anti_state) { return subsumes(anti_state, succ); })) {
+                    continue;
+                }
+
+                for (std::deque<ProdStateType>* ds: { &processed, &worklist }) {
+                    ds->erase(std::remove_if(ds->begin(), ds->end(),
+                                             [&](const ProdStateType& state) { return subsumes(succ, state); }),
+                              ds->end());
+                    ds->push_back(succ);
+                }
+
+                if (cex != nullptr) { paths[succ] = { prod_state, symbol }; }
+            }
+        }
+    }
+
+    return true;
+}
@@ -18,26 +18,71 @@
 // MATA headers
 #include <mata/nfa.hh>
 #include <mata/nfa-algorithms.hh>
+#include <mata/antichain.hh>
+#include <mata/nfa-post-image.hh>
+#include <mata/nfa-lazy-dfa.hh>
+#include <mata/flat-hash-map.hh>
 
 using namespace Mata::Nfa;
 using namespace Mata::Util;
 
-/// naive language inclusion check (complementation + intersection + emptiness)
+/// naive language inclusion check (search for a pair of a final state of smaller and a non-final macrostate of the
+/// lazily determinized bigger)
 bool Mata::Nfa::Algorithms::is_included_naive(
         const Nfa &smaller,
         const Nfa &bigger,
-        const Alphabet *const alphabet,//TODO: this should not be needed, likewise for equivalence
+        const Alphabet *const /* alphabet */,
         Run *cex,
         const StringMap &  /* params*/) { // {{{
-    Nfa bigger_cmpl;
-    if (alphabet == nullptr) {
-        bigger_cmpl = complement(bigger, OnTheFlyAlphabet::from_nfas(smaller, bigger));
-    } else {
-        bigger_cmpl = complement(bigger, *alphabet);
+    // Symbols missing in the bigger automaton lead to the dead macrostate, no alphabet is needed to complete it.
+    LazyDfa bigger_dfa{ bigger };
+
+    // A node of the product of smaller and the DFA of bigger, reached from the node 'parent' over 'symbol'.
+    struct Node {
+        State smaller_state;
+        State macrostate;
+        size_t parent;
+        Symbol symbol;
+    };
+    std::vector<Node> nodes{};
+    FlatHashMap<std::pair<State, State>, size_t> visited{};
+    const State bigger_initial{ bigger_dfa.initial() };
+    for (const State state: smaller.initial) {
+        if (visited.emplace({ state, bigger_initial }, nodes.size()).second) {
+            nodes.push_back({ state, bigger_initial, nodes.size(), 0 });
+        }
     }
-    Nfa nfa_isect = intersection(smaller, bigger_cmpl, false, nullptr);
 
-    return is_lang_empty(nfa_isect, cex);
+    // Nodes are processed in the order of their creation (breadth-first), so that the counterexample is shortest.
+    for (size_t node{ 0 }; node < nodes.size(); ++node) {
+        const State smaller_state{ nodes[node].smaller_state };
+        const State macrostate{ nodes[node].macrostate };
+        if (smaller.final[smaller_state] && !bigger_dfa.is_final(macrostate)) {
+            if (cex != nullptr) {
+                cex->word.clear();
+                cex->path.clear();
+                cex->path.push_back(smaller_state);
+                for (size_t trav{ node }; nodes[trav].parent != trav; trav = nodes[trav].parent) {
+                    cex->word.push_back(nodes[trav].symbol);
+                    cex->path.push_back(nodes[nodes[trav].parent].smaller_state);
+                }
+                std::reverse(cex->word.begin(), cex->word.end());
+                std::reverse(cex->path.begin(), cex->path.end());
+            }
+            return false;
+        }
+        if (smaller_state >= smaller.delta.post_size()) { continue; }
+
+        for (const Move& move: smaller.delta[smaller_state]) {
+            const State successor{ bigger_dfa.successor(macrostate, move.symbol) };
+            for (const State target: move.targets) {
+                if (visited.emplace({ target, successor }, nodes.size()).second) {
+                    nodes.push_back({ target, successor, node, move.symbol });
+                }
+            }
+        }
+    }
+    return true;
 } // is_included_naive }}}
 
 
@@ -54,45 +99,24 @@ bool Mata::Nfa::Algorithms::is_included_antichains(
     (void)params;
     (void)alphabet;
 
-    using ProdStateType = std::pair<State, StateSet>;
-    using WorklistType = std::deque<ProdStateType>;
-    using ProcessedType = std::deque<ProdStateType>;
-
-    //TODO: This is used in a container (a deque) of pairs, where every new pair means iterating through the entire list,
-    // and testing subsumption with everybody.
-    // Rewrite this as a deque (vector?) indexed by the first component (state) of vectors of the second components.
-    // We will go to the vector of the first component and test subsumption of the second components there.
-    // It may need some more fiddling if we still want to implement pure dfs/bfs however.
-    auto subsumes = [](const ProdStateType& lhs, const ProdStateType& rhs) {
-        if (lhs.first != rhs.first) {
-            return false;
-        }
-
-        const StateSet& lhs_bigger = lhs.second;
-        const StateSet& rhs_bigger = rhs.second;
-        if (lhs_bigger.size() > rhs_bigger.size()) { // bigger set cannot be subset
-            return false;
-        }
-
-        //TODO: Can this be done faster using more heuristics? E.g., compare the last elements first ...
-        //TODO: Try BDDs! What about some abstractions?
-        return std::includes(rhs_bigger.begin(), rhs_bigger.end(),
-            lhs_bigger.begin(), lhs_bigger.end());
-    };
+    using ElementId = Antichain<State, StateSet>::ElementId;
 
     // process parameters
     // TODO: set correctly!!!!
     bool is_dfs = true;
 
     // initialize
-    WorklistType worklist = { };
-    ProcessedType processed = { };
+    // Product states (smaller state, bigger macrostate) in the antichain; the worklist holds their ids, ids of states
+    // removed from the antichain in the meantime are skipped when popped.
+    Antichain<State, StateSet> processed{};
+    std::deque<ElementId> worklist{};
 
-    // 'paths[s] == t' denotes that state 's' was accessed from state 't',
-    // 'paths[s] == s' means that 's' is an initial state
-    std::map<ProdStateType, std::pair<ProdStateType, Symbol>> paths;
+    // 'paths[s] == t' denotes that the product state with the id 's' was accessed from the product state with the
+    // id 't', 'paths[s] == s' means that 's' is an initial product state
+    std::vector<std::pair<ElementId, Symbol>> paths{};
 
     // check initial states first // TODO: this would be done in the main loop as the first thing anyway?
+    const StateSet bigger_initial{ bigger.initial };
     for (const auto& state : smaller.initial) {
         if (smaller.final[state] &&
             are_disjoint(bigger.initial, bigger.final))
@@ -101,69 +125,51 @@ bool Mata::Nfa::Algorithms::is_included_antichains(
             return false;
         }
 
-        const ProdStateType st = std::make_pair(state, StateSet(bigger.initial));
-        worklist.push_back(st);
-        processed.push_back(st);
-
-        if (cex != nullptr)
-            paths.insert({ st, {st, 0}});
+        const auto [id, inserted] = processed.insert_if_not_subsumed(state, bigger_initial);
+        if (!inserted) { continue; }
+        worklist.push_back(id);
+        paths.emplace_back(id, 0);
     }
 
-    //For synchronised iteration over the set of states
-    using Iterator = Mata::Util::OrdVector<Move>::const_iterator;
-    Mata::Util::SynchronizedExistentialIterator<Iterator> sync_iterator;
+    // images of bigger macrostates under all symbols are computed in one sweep
+    PostImageEngine post_image{};
 
     while (!worklist.empty()) {
         // get a next product state
-        ProdStateType prod_state;
+        ElementId prod_state;
         if (is_dfs) {
-            prod_state = *worklist.rbegin();
+            prod_state = worklist.back();
             worklist.pop_back();
         } else { // BFS
-            prod_state = *worklist.begin();
+            prod_state = worklist.front();
             worklist.pop_front();
         }
+        if (!processed.is_alive(prod_state)) { continue; }
 
-        const State& smaller_state = prod_state.first;
-        const StateSet& bigger_set = prod_state.second;
+        const State smaller_state = processed.get_key(prod_state);
 
-        sync_iterator.reset();
-        for (State q: bigger_set) {
-            Mata::Util::push_back(sync_iterator, bigger.delta[q]);
-        }
+        post_image.start(bigger.delta, processed.set_begin(prod_state), processed.set_end(prod_state));
+        bool has_image = post_image.next();
 
         // process transitions leaving smaller_state
         for (const auto& smaller_move : smaller[smaller_state]) {//TODO: this should become smaller.delta[smaller_state] after refactoring
             const Symbol& smaller_symbol = smaller_move.symbol;
 
-            do {
-                if (sync_iterator.is_synchronized()) {
-                    auto current_min = sync_iterator.get_current_minimum();
-                    if (*current_min >= smaller_move) {
-                        break;
-                    }
-                }
-            } while (sync_iterator.advance());
-
-            // TODO: this is ugly, the interface of the sync iterator should be redesigned so that this looks ok
-            StateSet bigger_succ = {};
-            if(sync_iterator.is_synchronized() && *sync_iterator.get_current_minimum() == smaller_move) {
-                std::vector<Iterator> bigger_moves = sync_iterator.get_current();
-                for (auto m: bigger_moves) {
-                    bigger_succ = bigger_succ.Union(m->targets);
-                }
-            }
+            // the image of the bigger macrostate under the symbol, empty if the symbol is missing in the sweep
+            while (has_image && post_image.symbol() < smaller_symbol) { has_image = post_image.next(); }
+            const bool is_nonempty = has_image && post_image.symbol() == smaller_symbol;
+            const State* const bigger_succ_begin = is_nonempty ? post_image.begin() : nullptr;
+            const State* const bigger_succ_end = is_nonempty ? post_image.end() : nullptr;
+            const bool is_bigger_succ_final = std::any_of(bigger_succ_begin, bigger_succ_end,
+                                                          [&bigger](State q) { return bigger.final[q]; });
 
-            for (const State& smaller_succ : smaller_move.targets) {            
-                const ProdStateType succ = {smaller_succ, bigger_succ};
-
-                if (smaller.final[smaller_succ] &&
-                    are_disjoint(bigger_succ, bigger.final))
+            for (const State& smaller_succ : smaller_move.targets) {
+                if (smaller.final[smaller_succ] && !is_bigger_succ_final)
                 {
                     if (cex  != nullptr) {
                         cex->word.clear();
                         cex->word.push_back(smaller_symbol);
-                        ProdStateType trav = prod_state;
+                        ElementId trav = prod_state;
                         while (paths[trav].first != trav)
                         { // go back until initial state
                             cex->word.push_back(paths[trav].second);
@@ -176,43 +182,281 @@ bool Mata::Nfa::Algorithms::is_included_antichains(
                     return false;
                 }
 
-                bool is_subsumed = false;
-                for (const auto& anti_state : processed)
-                { // trying to find a smaller state in processed
-                    if (subsumes(anti_state, succ)) {
-                        is_subsumed = true;
-                        break;
-                    }
-                }
+                // insert succ unless it is subsumed, pruning the states it subsumes
+                const auto [succ, inserted] = processed.insert_if_not_subsumed(smaller_succ, bigger_succ_begin, bigger_succ_end);
+                if (!inserted) { continue; }
+
+                // TODO: set pushing strategy
+                worklist.push_back(succ);
 
-                if (is_subsumed) { continue; }
-
-                for (std::deque<ProdStateType>* ds : {&processed, &worklist}) {
-                    for (size_t it = 0; it < ds->size(); ++it) {
-                        if (subsumes(succ, ds->at(it))) {
-                            //Removal though replacement by the last element and removal pob_back.
-                            //Because calling erase would invalidate iterator it (in deque).
-                            ds->at(it) = ds->back(); //does it coppy stuff?
-                            ds->pop_back();
-                        } else {
-                            ++it;
+                // also set that succ was accessed from state
+                paths.emplace_back(prod_state, smaller_symbol);
+            }
+        }
+    }
+
+    return true;
+} // }}}
+
+/// language inclusion check using antichains with simulation-based pruning and subsumption
+bool Mata::Nfa::Algorithms::is_included_antichains_sim(
+    const Nfa&             smaller,
+    const Nfa&             bigger,
+    const Alphabet* const  /* alphabet */,
+    Run*                   cex,
+    const StringMap&       /* params */)
+{ // {{{
+    // Simulation is computed once on the disjoint union of both automata, bigger states are shifted by offset.
+    const State offset = std::max<size_t>({ smaller.delta.post_size(), smaller.delta.max_state() + 1,
+                                    smaller.initial.domain_size(), smaller.final.domain_size() });
+    Nfa union_aut{ smaller };
+    for (State q = 0; q < bigger.delta.post_size(); ++q) {
+        for (const Move& move : bigger.delta[q]) {
+            for (const State target : move.targets) {
+                union_aut.delta.add(q + offset, move.symbol, target + offset);
+            }
+        }
+    }
+    for (const State q : bigger.final) { union_aut.final.add(q + offset); }
+    const Simlib::Util::BinaryRelation sim = compute_relation(union_aut);
+
+    // 'is_simulated(p, q)' denotes that the union state 'q' simulates the union state 'p'
+    auto is_simulated = [&sim](State p, State q) {
+        return p == q || (p < sim.size() && q < sim.size() && sim.get(p, q));
+    };
+    // keep only simulation-maximal states (one representative of states simulating each other)
+    auto minimize_macrostate = [&](const StateSet& macrostate) {
+        std::vector<State> maximal;
+        for (const State p : macrostate) {
+            const bool is_dominated = std::any_of(macrostate.begin(), macrostate.end(), [&](State q) {
+                return p != q && is_simulated(p + offset, q + offset)
+                       && (!is_simulated(q + offset, p + offset) || q < p);
+            });
+            if (!is_dominated) { maximal.push_back(p); }
+        }
+        return StateSet(maximal);
+    };
+    // L(p) <= L(macrostate) is implied by p being simulated by some state of the macrostate
+    auto is_trivially_included = [&](State p, const StateSet& macrostate) {
+        return std::any_of(macrostate.begin(), macrostate.end(), [&](State q) { return is_simulated(p, q + offset); });
+    };
+
+    // A processed product state (r, R) subsumes (p, P) if p is simulated by r and every state of R is simulated by
+    // some state of P. Product states are kept in an antichain indexed by their smaller states and ordered by the
+    // simulation on bigger macrostates; the other direction is checked over all smaller states related to p.
+    const auto is_bigger_simulated = [&is_simulated, offset](State p, State q) {
+        return is_simulated(p + offset, q + offset);
+    };
+    using SimulationOrder = ForallExistsOrder<decltype(is_bigger_simulated)>;
+    using ElementId = Antichain<State, StateSet, SimulationOrder>::ElementId;
+    Antichain<State, StateSet, SimulationOrder> processed{ SimulationOrder{ is_bigger_simulated } };
+    // smaller states occurring in the antichain
+    std::vector<State> processed_smaller_states;
+    std::vector<bool> occurs_in_antichain(offset, false);
+    std::deque<ElementId> worklist;
+
+    // 'paths[s] == t' denotes that the product state with the id 's' was accessed from the product state with the
+    // id 't', 'paths[s] == s' means that 's' is an initial product state
+    std::vector<std::pair<ElementId, Symbol>> paths;
+
+    // smaller states simulating (up) and simulated by (down) a given state, computed lazily
+    std::unordered_map<State, std::pair<std::vector<State>, std::vector<State>>> up_down;
+    auto get_up_down = [&](State p) -> const std::pair<std::vector<State>, std::vector<State>>& {
+        auto it = up_down.find(p);
+        if (it == up_down.end()) {
+            std::pair<std::vector<State>, std::vector<State>> value;
+            for (const State r : processed_smaller_states) {
+                if (is_simulated(p, r)) { value.first.push_back(r); }
+                if (is_simulated(r, p)) { value.second.push_back(r); }
+            }
+            it = up_down.emplace(p, std::move(value)).first;
+        }
+        return it->second;
+    };
+
+    // tries to insert (p, macrostate) reached from 'parent' over 'symbol', returns false for subsumed states
+    auto insert = [&](State p, const StateSet& macrostate, ElementId parent, Symbol symbol) {
+        if (is_trivially_included(p, macrostate)) { return false; }
+
+        // (p, P) is subsumed by a processed (r, R) with p <= r and R <=forall-exists P
+        const auto& [up, down] = get_up_down(p);
+        for (const State r : up) {
+            if (processed.is_subsumed(r, macrostate)) { return false; }
+        }
+        // remove processed (r, R) subsumed by (p, P), i.e., r <= p and P <=forall-exists R
+        for (const State r : down) { processed.remove_subsumed(r, macrostate); }
+
+        const ElementId id = processed.insert(p, macrostate);
+        paths.emplace_back(parent == std::numeric_limits<ElementId>::max() ? id : parent, symbol);
+        if (!occurs_in_antichain[p]) {
+            // a new smaller state occurs in the antichain, its relation to the other ones is recomputed
+            occurs_in_antichain[p] = true;
+            processed_smaller_states.push_back(p);
+            up_down.clear();
+        }
+        worklist.push_back(id);
+        return true;
+    };
+
+    const StateSet bigger_initial = minimize_macrostate(StateSet(bigger.initial));
+    const bool bigger_initial_is_final = !are_disjoint(bigger_initial, bigger.final);
+    for (const State state : smaller.initial) {
+        if (smaller.final[state] && !bigger_initial_is_final) {
+            if (cex != nullptr) { cex->word.clear(); }
+            return false;
+        }
+        insert(state, bigger_initial, std::numeric_limits<ElementId>::max(), 0);
+    }
+
+    // breadth-first search yields the shortest counterexample
+    while (!worklist.empty()) {
+        const ElementId prod_state = worklist.front();
+        worklist.pop_front();
+        if (!processed.is_alive(prod_state)) { continue; }
+
+        const State smaller_state = processed.get_key(prod_state);
+        const StateSet bigger_set = processed.get_set(prod_state);
+        if (smaller_state >= smaller.delta.post_size()) { continue; }
+
+        for (const Move& smaller_move : smaller.delta[smaller_state]) {
+            const Symbol smaller_symbol = smaller_move.symbol;
+            const StateSet bigger_succ = minimize_macrostate(bigger.post(bigger_set, smaller_symbol));
+            const bool bigger_succ_is_final = !are_disjoint(bigger_succ, bigger.final);
+
+            for (const State smaller_succ : smaller_move.targets) {
+                if (smaller.final[smaller_succ] && !bigger_succ_is_final) {
+                    if (cex != nullptr) {
+                        cex->word.clear();
+                        cex->word.push_back(smaller_symbol);
+                        ElementId trav = prod_state;
+                        while (paths[trav].first != trav)
+                        { // go back until initial state
+                            cex->word.push_back(paths[trav].second);
+                            trav = paths[trav].first;
                         }
+
+                        std::reverse(cex->word.begin(), cex->word.end());
                     }
 
-                    // TODO: set pushing strategy
-                    ds->push_back(succ);
+                    return false;
                 }
 
-                // also set that succ was accessed from state
-                paths[succ] = {prod_state, smaller_symbol};
+                insert(smaller_succ, bigger_succ, prod_state, smaller_symbol);
             }
         }
     }
 
     return true;
-} // }}}
+} // is_included_antichains_sim }}}
 
 namespace {
+    /// Upper bound of states of @p aut: all states of @p aut are smaller than the bound.
+    size_t states_bound(const Nfa& aut) {
+        return std::max<size_t>({ aut.delta.post_size(), aut.delta.max_state() + 1, aut.initial.domain_size(),
+                                  aut.final.domain_size() });
+    }
+
+    /**
+     * Bisimulation up to congruence (HKC) of Bonchi and Pous over the disjoint union of @p lhs and @p rhs.
+     *
+     * States of @p lhs are kept, states of @p rhs are shifted by the states bound of @p lhs. Macrostates are
+     *  determinized on the fly and explored in the breadth-first order; a pair is skipped whenever it lies in the
+     *  congruence closure of the pairs processed so far.
+     * @param[in] check_inclusion Check L(lhs) <= L(rhs) (as L(lhs) + L(rhs) == L(rhs)) instead of equivalence.
+     * @param[out] cex Shortest word distinguishing the automata, if there is any.
+     */
+    bool check_hkc(const Nfa& lhs, const Nfa& rhs, bool check_inclusion, Run* cex) {
+        const size_t offset{ states_bound(lhs) };
+        constexpr size_t MAX_STATE{ std::numeric_limits<State>::max() };
+        if (offset > MAX_STATE || states_bound(rhs) > MAX_STATE - offset) {
+            throw std::length_error(std::string(__func__) + ": states of the disjoint union of automata with "
+                                    + std::to_string(offset) + " and " + std::to_string(states_bound(rhs))
+                                    + " states do not fit into the state type");
+        }
+        const auto encode = [&](const StateSet& states, bool is_rhs) {
+            std::vector<State> encoded{};
+            encoded.reserve(states.size());
+            for (const State state: states) { encoded.push_back(is_rhs ? state + offset : state); }
+            return StateSet(encoded);
+        };
+        const auto is_accepting = [&](const StateSet& macrostate) {
+            return std::any_of(macrostate.begin(), macrostate.end(), [&](State state) {
+                return state >= offset ? rhs.final[state - offset] : lhs.final[state];
+            });
+        };
+
+        struct Node {
+            StateSet lhs;
+            StateSet rhs;
+            size_t parent;
+            Symbol symbol;
+        };
+        constexpr size_t NO_PARENT{ std::numeric_limits<size_t>::max() };
+
+        StateSet lhs_initial{ encode(StateSet(lhs.initial), false) };
+        const StateSet rhs_initial{ encode(StateSet(rhs.initial), true) };
+        if (check_inclusion) { lhs_initial = lhs_initial.Union(rhs_initial); }
+        std::vector<Node> nodes{ { lhs_initial, rhs_initial, NO_PARENT, 0 } };
+        std::deque<size_t> worklist{ 0 };
+        Algorithms::CongruenceClosure closure{};
+
+        // Successors of a pair grouped by symbols: (symbol, side, encoded target).
+        std::vector<std::tuple<Symbol, State, State>> succs{};
+        while (!worklist.empty()) {
+            const size_t node_id{ worklist.front() };
+            worklist.pop_front();
+            const StateSet lhs_macrostate{ nodes[node_id].lhs };
+            const StateSet rhs_macrostate{ nodes[node_id].rhs };
+
+            if (closure.are_congruent(lhs_macrostate, rhs_macrostate)) { continue; }
+
+            if (is_accepting(lhs_macrostate) != is_accepting(rhs_macrostate)) {
+                if (cex != nullptr) {
+                    cex->word.clear();
+                    for (size_t trav{ node_id }; nodes[trav].parent != NO_PARENT; trav = nodes[trav].parent) {
+                        cex->word.push_back(nodes[trav].symbol);
+                    }
+                    std::reverse(cex->word.begin(), cex->word.end());
+                }
+                return false;
+            }
+
+            succs.clear();
+            for (State side{ 0 }; side < 2; ++side) {
+                for (const State state: side == 0 ? lhs_macrostate : rhs_macrostate) {
+                    const bool is_rhs{ state >= offset };
+                    const Nfa& aut{ is_rhs ? rhs : lhs };
+                    const State shift{ is_rhs ? static_cast<State>(offset) : 0 };
+                    const State orig_state{ state - shift };
+                    if (orig_state >= aut.delta.post_size()) { continue; }
+                    for (const Move& move: aut.delta[orig_state]) {
+                        for (const State target: move.targets) {
+                            succs.emplace_back(move.symbol, side, target + shift);
+                        }
+                    }
+                }
+            }
+            std::sort(succs.begin(), succs.end());
+
+            std::vector<State> lhs_targets{};
+            std::vector<State> rhs_targets{};
+            for (auto it{ succs.begin() }; it != succs.end();) {
+                const Symbol symbol{ std::get<0>(*it) };
+                lhs_targets.clear();
+                rhs_targets.clear();
+                for (; it != succs.end() && std::get<0>(*it) == symbol; ++it) {
+                    (std::get<1>(*it) == 0 ? lhs_targets : rhs_targets).push_back(std::get<2>(*it));
+                }
+                nodes.push_back({ StateSet(lhs_targets), StateSet(rhs_targets), node_id, symbol });
+                worklist.push_back(nodes.size() - 1);
+            }
+
+            closure.add(lhs_macrostate, rhs_macrostate);
+        }
+
+        return true;
+    }
+
     using AlgoType = decltype(Algorithms::is_included_naive)*;
 
     bool compute_equivalence(const Nfa &lhs, const Nfa &rhs, const Alphabet *const alphabet, const StringMap &params,
@@ -240,6 +484,10 @@ namespace {
             algo = Algorithms::is_included_naive;
         } else if ("antichains" == str_algo) {
             algo = Algorithms::is_included_antichains;
+        } else if ("antichains-sim" == str_algo) {
+            algo = Algorithms::is_included_antichains_sim;
+        } else if ("hkc" == str_algo) {
+            algo = Algorithms::is_included_hkc;
         } else {
             throw std::runtime_error(std::to_string(__func__) +
                                      " received an unknown value of the \"algo\" key: " + str_algo);
@@ -250,6 +498,75 @@ namespace {
 
 }
 
+bool Mata::Nfa::Algorithms::CongruenceClosure::are_congruent(const StateSet& lhs, const StateSet& rhs) {
+    if (lhs == rhs) { return true; }
+    const auto lhs_id{ ids_.find(lhs) };
+    const auto rhs_id{ ids_.find(rhs) };
+    if (lhs_id != ids_.end() && rhs_id != ids_.end() && find(lhs_id->second) == find(rhs_id->second)) {
+        return true;
+    }
+    return normal_form(lhs) == normal_form(rhs);
+}
+
+void Mata::Nfa::Algorithms::CongruenceClosure::add(const StateSet& lhs, const StateSet& rhs) {
+    const size_t lhs_id{ intern(lhs) };
+    const size_t rhs_id{ intern(rhs) };
+    parents_[find(lhs_id)] = find(rhs_id);
+    rules_.emplace_back(lhs, rhs);
+}
+
+size_t Mata::Nfa::Algorithms::CongruenceClosure::intern(const StateSet& macrostate) {
+    const auto [it, inserted]{ ids_.emplace(macrostate, parents_.size()) };
+    if (inserted) { parents_.push_back(it->second); }
+    return it->second;
+}
+
+size_t Mata::Nfa::Algorithms::CongruenceClosure::find(size_t id) {
+    while (parents_[id] != id) {
+        parents_[id] = parents_[parents_[id]];
+        id = parents_[id];
+    }
+    return id;
+}
+
+StateSet Mata::Nfa::Algorithms::CongruenceClosure::normal_form(StateSet macrostate) const {
+    std::vector<bool> used(rules_.size(), false);
+    bool changed{ true };
+    while (changed) {
+        changed = false;
+        for (size_t i{ 0 }; i < rules_.size(); ++i) {
+            if (used[i]) { continue; }
+            const auto& [lhs, rhs]{ rules_[i] };
+            const bool lhs_included{ lhs.IsSubsetOf(macrostate) };
+            const bool rhs_included{ rhs.IsSubsetOf(macrostate) };
+            if (lhs_included || rhs_included) {
+                // Once both sides are included, the rule cannot add anything anymore.
+                used[i] = true;
+                if (!(lhs_included && rhs_included)) {
+                    macrostate = macrostate.Union(lhs).Union(rhs);
+                    changed = true;
+                }
+            }
+        }
+    }
+    return macrostate;
+}
+
+/// language inclusion check using bisimulation up to congruence
+bool Mata::Nfa::Algorithms::is_included_hkc(
+        const Nfa&             smaller,
+        const Nfa&             bigger,
+        const Alphabet* const  /* alphabet */,
+        Run*                   cex,
+        const StringMap&       /* params */) { // {{{
+    return check_hkc(smaller, bigger, true, cex);
+} // is_included_hkc }}}
+
+/// language equivalence check using bisimulation up to congruence
+bool Mata::Nfa::Algorithms::are_equivalent_hkc(const Nfa& lhs, const Nfa& rhs, Run* cex) { // {{{
+    return check_hkc(lhs, rhs, false, cex);
+} // are_equivalent_hkc }}}
+
 // The dispatching method that calls the correct one based on parameters
 bool Mata::Nfa::is_included(
         const Nfa &smaller,
@@ -266,6 +583,11 @@ bool Mata::Nfa::are_equivalent(const Nfa& lhs, const Nfa& rhs, const Alphabet *a
     //TODO: add comment on what this is doing, what is __func__ ...
     AlgoType algo{ set_algorithm(std::to_string(__func__), params) };
 
+    if (params.at("algo") == "hkc") {
+        // HKC checks equivalence in a single pass.
+        return Algorithms::are_equivalent_hkc(lhs, rhs, nullptr);
+    }
+
     if (params.at("algo") == "naive") {
         if (alphabet == nullptr) {
             const auto computed_alphabet{ OnTheFlyAlphabet::from_nfas(lhs, rhs) };
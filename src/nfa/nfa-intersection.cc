@@ -13,6 +13,9 @@
  * GNU General Public License for more details.
  */
 
+#include <algorithm>
+#include <limits>
+
 // MATA headers
 #include <mata/nfa.hh>
 #include <mata/nfa-algorithms.hh>
@@ -21,6 +24,9 @@ using namespace Mata::Nfa;
 
 namespace {
 
+/// Map of pairs of original states to product states.
+using ProductMap = Mata::Util::FlatHashMap<std::pair<State,State>, State>;
+
 /**
  * Add transition to the product.
  * @param[out] product Created product automaton.
@@ -28,12 +34,12 @@ namespace {
  * @param[in] pair_to_process Currently processed pair of original states.
  * @param[in] intersection_transition State transitions to add to the product.
  */
-void add_product_transition(Nfa& product, std::unordered_map<std::pair<State,State>, State>& product_map,
+void add_product_transition(Nfa& product, const ProductMap& product_map,
                             const std::pair<State,State>& pair_to_process,
                             Move& intersection_transition) {
     if (intersection_transition.empty()) { return; }
 
-    auto& intersect_state_transitions{ product.delta[product_map[pair_to_process]] };
+    auto& intersect_state_transitions{ product.delta[product_map.find(pair_to_process)->second] };
     auto symbol_transitions_iter{ intersect_state_transitions.find(intersection_transition) };
     if (symbol_transitions_iter == intersect_state_transitions.end()) {
         intersect_state_transitions.insert(intersection_transition);
@@ -47,37 +53,113 @@ void add_product_transition(Nfa& product, std::unordered_map<std::pair<State,Sta
  * Create product state and its transitions.
  * @param[out] product Created product automaton.
  * @param[out] product_map Created product map.
- * @param[out] pairs_to_process Set of product states to process
+ * @param[out] pairs_to_process Worklist of product states to process
  * @param[in] lhs_state_to Target state in NFA @c lhs.
  * @param[in] rhs_state_to Target state in NFA @c rhs.
  * @param[out] intersect_transitions Transitions of the product state.
  */
 void create_product_state_and_trans(
             Nfa& product,
-            std::unordered_map<std::pair<State,State>, State>& product_map,
+            ProductMap& product_map,
             const Nfa& lhs,
             const Nfa& rhs,
-            std::unordered_set<std::pair<State,State>>& pairs_to_process,
+            std::vector<std::pair<State,State>>& pairs_to_process,
             const State lhs_state_to,
             const State rhs_state_to,
             Move& intersect_transitions
 ) {
     const std::pair<State,State> intersect_state_pair_to(lhs_state_to, rhs_state_to);
-    State intersect_state_to;
-    if (product_map.find(intersect_state_pair_to) == product_map.end()) {
-        intersect_state_to = product.add_state();
-        product_map[intersect_state_pair_to] = intersect_state_to;
-        pairs_to_process.insert(intersect_state_pair_to);
+    const auto [product_map_it, inserted]{ product_map.emplace(intersect_state_pair_to, product.delta.post_size()) };
+    const State intersect_state_to{ product_map_it->second };
+    if (inserted) {
+        product.add_state();
+        pairs_to_process.push_back(intersect_state_pair_to);
 
         if (lhs.final[lhs_state_to] && rhs.final[rhs_state_to]) {
             product.final.add(intersect_state_to);
         }
-    } else {
-        intersect_state_to = product_map[intersect_state_pair_to];
     }
     intersect_transitions.insert(intersect_state_to);
 }
 
+/**
+ * Set of product states of a fixed arity, indexed in the order of insertion. Tuples of states are keys of a
+ *  @c FlatHashMap and tuples of small arities are stored inline in its entries, so that no allocation per product
+ *  state is needed.
+ */
+class ProductStateSet {
+public:
+    explicit ProductStateSet(size_t arity) : arity_{ arity }, tuples_{} {}
+
+    /**
+     * Insert @p tuple of @c arity states.
+     * @return Pair of the index of the tuple and whether the tuple was inserted.
+     */
+    std::pair<size_t, bool> insert(const State* tuple) {
+        const auto [entry, inserted]{ tuples_.emplace(Tuple(tuple, tuple + arity_), tuples_.size()) };
+        return { entry->second, inserted };
+    }
+
+    /// Get the tuple with @p index. The pointer is invalidated by the next insertion.
+    const State* get(size_t index) const {
+        return (tuples_.begin() + static_cast<std::ptrdiff_t>(index))->first.data();
+    }
+
+    size_t size() const { return tuples_.size(); }
+
+private:
+    using Tuple = Mata::Util::SmallVector<State, 4>;
+
+    struct TupleHash {
+        size_t operator()(const Tuple& tuple) const {
+            size_t seed{ tuple.size() };
+            for (const State state: tuple) { seed ^= state + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2); }
+            return seed;
+        }
+    };
+
+    size_t arity_;
+    Mata::Util::FlatHashMap<Tuple, size_t, TupleHash> tuples_;
+};
+
+/**
+ * Call @p process on all tuples from the cartesian product of @p sets, until @p process returns true.
+ * @param[out] tuple Buffer holding the current tuple.
+ * @return True iff @p process returned true for some tuple.
+ */
+template<typename Function>
+bool for_each_tuple(const std::vector<const TargetSet*>& sets, std::vector<State>& tuple, const Function& process) {
+    const size_t arity{ sets.size() };
+    for (const TargetSet* set: sets) {
+        if (set->empty()) { return false; }
+    }
+    std::vector<size_t> positions(arity, 0);
+    tuple.resize(arity);
+    for (size_t i{ 0 }; i < arity; ++i) { tuple[i] = sets[i]->begin()[0]; }
+    while (true) {
+        if (process(tuple)) { return true; }
+        // Advance the positions as an odometer.
+        size_t i{ 0 };
+        for (; i < arity; ++i) {
+            if (++positions[i] < sets[i]->size()) {
+                tuple[i] = sets[i]->begin()[positions[i]];
+                break;
+            }
+            positions[i] = 0;
+            tuple[i] = sets[i]->begin()[0];
+        }
+        if (i == arity) { return false; }
+    }
+}
+
+/// Check whether @p tuple is final in all @p automata.
+bool is_final_tuple(const ConstAutRefSequence& automata, const std::vector<State>& tuple) {
+    for (size_t i{ 0 }; i < tuple.size(); ++i) {
+        if (!automata[i].get().final[tuple[i]]) { return false; }
+    }
+    return true;
+}
+
 } // Anonymous namespace.
 
 namespace Mata {
@@ -95,9 +177,9 @@ Nfa Mata::Nfa::Algorithms::intersection_eps(const Nfa& lhs, const Nfa& rhs, bool
                  std::unordered_map<std::pair<State,State>, State> *prod_map) {
     Nfa product{}; // Product of the intersection.
     // Product map for the generated intersection mapping original state pairs to new product states.
-    std::unordered_map<std::pair<State,State>, State> product_map{};
+    ProductMap product_map{};
     std::pair<State,State> pair_to_process{}; // State pair of original states currently being processed.
-    std::unordered_set<std::pair<State,State>> pairs_to_process{}; // Set of state pairs of original states to process.
+    std::vector<std::pair<State,State>> pairs_to_process{}; // Worklist of state pairs of original states to process.
 
     // Initialize pairs to process with initial state pairs.
     for (const State lhs_initial_state : lhs.initial) {
@@ -106,8 +188,8 @@ Nfa Mata::Nfa::Algorithms::intersection_eps(const Nfa& lhs, const Nfa& rhs, bool
             const std::pair<State,State> this_and_other_initial_state_pair(lhs_initial_state, rhs_initial_state);
             const State new_intersection_state = product.add_state();
 
-            product_map[this_and_other_initial_state_pair] = new_intersection_state;
-            pairs_to_process.insert(this_and_other_initial_state_pair);
+            product_map.emplace(this_and_other_initial_state_pair, new_intersection_state);
+            pairs_to_process.push_back(this_and_other_initial_state_pair);
 
             product.initial.add(new_intersection_state);
             if (lhs.final[lhs_initial_state] && rhs.final[rhs_initial_state]) {
@@ -117,8 +199,8 @@ Nfa Mata::Nfa::Algorithms::intersection_eps(const Nfa& lhs, const Nfa& rhs, bool
     }
 
     while (!pairs_to_process.empty()) {
-        pair_to_process = *pairs_to_process.cbegin();
-        pairs_to_process.erase(pair_to_process);
+        pair_to_process = pairs_to_process.back();
+        pairs_to_process.pop_back();
         // Compute classic product for current state pair.
 
         Mata::Util::SynchronizedUniversalIterator<Mata::Util::OrdVector<Move>::const_iterator> sync_iterator(2);
@@ -126,7 +208,7 @@ Nfa Mata::Nfa::Algorithms::intersection_eps(const Nfa& lhs, const Nfa& rhs, bool
         Mata::Util::push_back(sync_iterator,rhs.delta[pair_to_process.second]);
 
         while (sync_iterator.advance()) {
-            std::vector<Post::const_iterator> moves = sync_iterator.get_current();
+            const std::vector<Post::const_iterator>& moves{ sync_iterator.get_current() };
             assert(moves.size() == 2); // One move per state in the pair.
 
             // Compute product for state transitions with same symbols.
@@ -188,9 +270,192 @@ Nfa Mata::Nfa::Algorithms::intersection_eps(const Nfa& lhs, const Nfa& rhs, bool
         }
     }
 
-    if (prod_map != nullptr) { *prod_map = product_map; }
+    if (prod_map != nullptr) { product_map.move_to(*prod_map); }
+    return product;
+} // intersection().
+
+Nfa intersection(const ConstAutRefSequence& automata, bool preserve_epsilon,
+                 std::unordered_map<std::vector<State>, State>* prod_map) {
+    const std::set<Symbol> epsilons({EPSILON});
+    return Algorithms::intersection_eps(automata, preserve_epsilon, epsilons, prod_map);
+}
+
+Nfa Mata::Nfa::Algorithms::intersection_eps(const ConstAutRefSequence& automata, bool preserve_epsilon,
+                                             const std::set<Symbol>& epsilons,
+                                             std::unordered_map<std::vector<State>, State>* prod_map) {
+    const size_t arity{ automata.size() };
+    if (arity == 0) {
+        throw std::runtime_error(std::to_string(__func__) + " requires at least one automaton");
+    }
+
+    Nfa product{};
+    // Product states are numbered in the order of insertion of their tuples.
+    ProductStateSet product_states{ arity };
+    const auto get_product_state = [&](const std::vector<State>& tuple) {
+        const auto [state, inserted]{ product_states.insert(tuple.data()) };
+        if (inserted && is_final_tuple(automata, tuple)) { product.final.add(state); }
+        return state;
+    };
+
+    std::vector<TargetSet> initial_sets{};
+    initial_sets.reserve(arity);
+    std::vector<const TargetSet*> sets{};
+    for (const Nfa& aut: automata) {
+        initial_sets.emplace_back(aut.initial);
+        sets.push_back(&initial_sets.back());
+    }
+    std::vector<State> tuple{};
+    for_each_tuple(sets, tuple, [&](const std::vector<State>& initial_tuple) {
+        product.initial.add(get_product_state(initial_tuple));
+        return false;
+    });
+
+    Mata::Util::SynchronizedUniversalIterator<Mata::Util::OrdVector<Move>::const_iterator> sync_iterator(arity);
+    std::vector<State> source(arity);
+    // Moves of the currently processed product state, possibly several with the same (epsilon) symbol.
+    std::vector<std::pair<Symbol, std::vector<State>>> product_moves{};
+    for (State state{ 0 }; state < product_states.size(); ++state) {
+        const State* const source_tuple{ product_states.get(state) };
+        std::copy(source_tuple, source_tuple + arity, source.begin());
+        product_moves.clear();
+
+        // Synchronized moves over the same symbol in all automata.
+        sync_iterator.reset();
+        bool has_successors{ true };
+        for (size_t i{ 0 }; i < arity && has_successors; ++i) {
+            const Delta& delta{ automata[i].get().delta };
+            has_successors = source[i] < delta.post_size() && !delta[source[i]].empty();
+            if (has_successors) { Mata::Util::push_back(sync_iterator, delta[source[i]]); }
+        }
+        while (has_successors && sync_iterator.advance()) {
+            const std::vector<Post::const_iterator>& moves{ sync_iterator.get_current() };
+            for (size_t i{ 0 }; i < arity; ++i) { sets[i] = &moves[i]->targets; }
+            product_moves.emplace_back(moves[0]->symbol, std::vector<State>{});
+            std::vector<State>& targets{ product_moves.back().second };
+            for_each_tuple(sets, tuple, [&](const std::vector<State>& target_tuple) {
+                targets.push_back(get_product_state(target_tuple));
+                return false;
+            });
+        }
+
+        if (preserve_epsilon) {
+            // Epsilon moves of a single automaton, the other automata stay in their states. Epsilon symbols are the
+            //  largest symbols, hence their moves are at the end of the post.
+            for (size_t i{ 0 }; i < arity; ++i) {
+                const Delta& delta{ automata[i].get().delta };
+                if (source[i] >= delta.post_size()) { continue; }
+                const Post& post{ delta[source[i]] };
+                for (auto move_it{ post.end() }; move_it != post.begin() && epsilons.count((move_it - 1)->symbol);) {
+                    --move_it;
+                    product_moves.emplace_back(move_it->symbol, std::vector<State>{});
+                    std::vector<State>& targets{ product_moves.back().second };
+                    tuple = source;
+                    for (const State target: move_it->targets) {
+                        tuple[i] = target;
+                        targets.push_back(get_product_state(tuple));
+                    }
+                }
+            }
+            std::stable_sort(product_moves.begin(), product_moves.end(),
+                             [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+        }
+
+        Post post{};
+        for (auto move_it{ product_moves.begin() }; move_it != product_moves.end();) {
+            std::vector<State> targets{ std::move(move_it->second) };
+            const Symbol symbol{ move_it->first };
+            for (++move_it; move_it != product_moves.end() && move_it->first == symbol; ++move_it) {
+                targets.insert(targets.end(), move_it->second.begin(), move_it->second.end());
+            }
+            if (!targets.empty()) { post.insert(Move{ symbol, TargetSet{ targets } }); }
+        }
+        if (!post.empty()) { product.delta[state] = std::move(post); }
+    }
+    if (product.delta.post_size() < product_states.size()) { product.increase_size(product_states.size()); }
+
+    if (prod_map != nullptr) {
+        prod_map->clear();
+        for (State state{ 0 }; state < product_states.size(); ++state) {
+            const State* const state_tuple{ product_states.get(state) };
+            prod_map->emplace(std::vector<State>(state_tuple, state_tuple + arity), state);
+        }
+    }
     return product;
 } // intersection().
 
+bool is_intersection_empty(const ConstAutRefSequence& automata, Run* cex) {
+    const size_t arity{ automata.size() };
+    // Intersection of no automata is the universal language.
+    if (arity == 0) {
+        if (cex != nullptr) {
+            cex->word.clear();
+            cex->path.clear();
+        }
+        return false;
+    }
+
+    ProductStateSet product_states{ arity };
+    // 'paths[s] == (t, a)' denotes that the product state with the index 's' was accessed from the product state with
+    //  the index 't' over the symbol 'a', 'paths[s].first == s' means that 's' is an initial product state.
+    std::vector<std::pair<size_t, Symbol>> paths{};
+    size_t accepting_index{ 0 };
+    const auto reach = [&](const std::vector<State>& tuple, size_t source_index, Symbol symbol) {
+        const auto [index, inserted]{ product_states.insert(tuple.data()) };
+        if (!inserted) { return false; }
+        paths.emplace_back(source_index == std::numeric_limits<size_t>::max() ? index : source_index, symbol);
+        accepting_index = index;
+        return is_final_tuple(automata, tuple);
+    };
+
+    std::vector<TargetSet> initial_sets{};
+    initial_sets.reserve(arity);
+    std::vector<const TargetSet*> sets{};
+    for (const Nfa& aut: automata) {
+        initial_sets.emplace_back(aut.initial);
+        sets.push_back(&initial_sets.back());
+    }
+    std::vector<State> tuple{};
+    bool found{ for_each_tuple(sets, tuple, [&](const std::vector<State>& initial_tuple) {
+        return reach(initial_tuple, std::numeric_limits<size_t>::max(), 0);
+    }) };
+
+    // Indices are assigned in the order of discovery, hence iterating over them explores the product breadth-first.
+    Mata::Util::SynchronizedUniversalIterator<Mata::Util::OrdVector<Move>::const_iterator> sync_iterator(arity);
+    std::vector<State> source(arity);
+    for (size_t index{ 0 }; !found && index < product_states.size(); ++index) {
+        const State* const source_tuple{ product_states.get(index) };
+        std::copy(source_tuple, source_tuple + arity, source.begin());
+
+        sync_iterator.reset();
+        bool has_successors{ true };
+        for (size_t i{ 0 }; i < arity && has_successors; ++i) {
+            const Delta& delta{ automata[i].get().delta };
+            has_successors = source[i] < delta.post_size() && !delta[source[i]].empty();
+            if (has_successors) { Mata::Util::push_back(sync_iterator, delta[source[i]]); }
+        }
+        if (!has_successors) { continue; }
+
+        while (!found && sync_iterator.advance()) {
+            const std::vector<Post::const_iterator>& moves{ sync_iterator.get_current() };
+            const Symbol symbol{ moves[0]->symbol };
+            for (size_t i{ 0 }; i < arity; ++i) { sets[i] = &moves[i]->targets; }
+            found = for_each_tuple(sets, tuple, [&](const std::vector<State>& target_tuple) {
+                return reach(target_tuple, index, symbol);
+            });
+        }
+    }
+
+    if (!found) { return true; }
+    if (cex != nullptr) {
+        cex->word.clear();
+        cex->path.clear();
+        for (size_t index{ accepting_index }; paths[index].first != index; index = paths[index].first) {
+            cex->word.push_back(paths[index].second);
+        }
+        std::reverse(cex->word.begin(), cex->word.end());
+    }
+    return false;
+} // is_intersection_empty().
+
 } // namespace Nfa.
 } // namespace Mata.
@@ -0,0 +1,151 @@
+/* nfa-lazy-dfa-matcher.cc -- matching byte strings with a lazily built DFA cache
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <algorithm>
+
+// MATA headers
+#include <mata/nfa-lazy-dfa-matcher.hh>
+
+using namespace Mata::Nfa;
+
+constexpr size_t LazyDfaMatcher::DEFAULT_CACHE_BUDGET;
+constexpr size_t LazyDfaMatcher::MIN_BYTES_PER_STATE;
+constexpr size_t LazyDfaMatcher::NO_MATCH;
+constexpr State LazyDfaMatcher::UNKNOWN;
+constexpr uint8_t LazyDfaMatcher::FINAL;
+constexpr uint8_t LazyDfaMatcher::DEAD;
+
+LazyDfaMatcher::LazyDfaMatcher(const Nfa& aut, const size_t cache_budget, const ByteMap& byte_map)
+    // The matcher keeps the DFA within its budget itself, counting its table too.
+    : aut_{ aut }, cache_budget_{ cache_budget }, dfa_{ aut }, byte_map_{ byte_map } {
+    std::vector<Symbol> symbols{};
+    for (State state{ 0 }; state < aut.delta.post_size(); ++state) {
+        for (const Move& move: aut.delta[state]) { symbols.push_back(move.symbol); }
+    }
+    std::sort(symbols.begin(), symbols.end());
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+
+    // Bytes of symbols without transitions form the class 0, bytes of every other symbol form a class.
+    class_symbols_.push_back(0);
+    bool has_class_0{ false };
+    for (size_t byte{ 0 }; byte < byte_map_.size(); ++byte) {
+        const Symbol symbol{ byte_map_[byte] };
+        if (!std::binary_search(symbols.begin(), symbols.end(), symbol)) {
+            if (!has_class_0) { class_symbols_[0] = symbol; }
+            has_class_0 = true;
+            byte_classes_[byte] = 0;
+            continue;
+        }
+        const auto found{ std::find(class_symbols_.begin() + 1, class_symbols_.end(), symbol) };
+        byte_classes_[byte] = static_cast<uint16_t>(found - class_symbols_.begin());
+        if (found == class_symbols_.end()) { class_symbols_.push_back(symbol); }
+    }
+    num_of_byte_classes_ = class_symbols_.size();
+}
+
+void LazyDfaMatcher::add_rows() {
+    for (size_t state{ flags_.size() }; state < dfa_.num_of_states(); ++state) {
+        flags_.push_back(static_cast<uint8_t>((dfa_.is_final(static_cast<State>(state)) ? FINAL : 0)
+                                              | (dfa_.is_dead(static_cast<State>(state)) ? DEAD : 0)));
+    }
+    transitions_.resize(flags_.size() * num_of_byte_classes_, UNKNOWN);
+}
+
+State LazyDfaMatcher::step(const State state, const size_t byte_class, bool& thrashing) {
+    State target{ dfa_.successor(state, class_symbols_[byte_class]) };
+    add_rows();
+    transitions_[state * num_of_byte_classes_ + byte_class] = target;
+    if (cache_usage() > cache_budget_) {
+        thrashing = bytes_since_flush_ < MIN_BYTES_PER_STATE * dfa_.num_of_states();
+        target = dfa_.flush(target);
+        bytes_since_flush_ = 0;
+        transitions_.clear();
+        flags_.clear();
+        add_rows();
+    }
+    return target;
+}
+
+size_t LazyDfaMatcher::match(const std::string_view input, const MatchKind kind) {
+    State state{ dfa_.initial() };
+    add_rows();
+    size_t last_match{ NO_MATCH };
+    if ((flags_[state] & FINAL) != 0) {
+        if (kind == MatchKind::SHORTEST) { return 0; }
+        last_match = 0;
+    }
+
+    for (size_t position{ 0 }; position < input.size(); ++position) {
+        const size_t byte_class{ byte_classes_[static_cast<unsigned char>(input[position])] };
+        State target{ transitions_[state * num_of_byte_classes_ + byte_class] };
+        if (target == UNKNOWN) {
+            bool thrashing{ false };
+            target = step(state, byte_class, thrashing);
+            if (thrashing) {
+                ++num_of_fallbacks_;
+                return simulate(input, position + 1, target, last_match, kind);
+            }
+        }
+        state = target;
+        ++bytes_since_flush_;
+        const uint8_t flags{ flags_[state] };
+        if (flags != 0) {
+            if ((flags & DEAD) != 0) { break; }
+            if (kind == MatchKind::SHORTEST) { return position + 1; }
+            last_match = position + 1;
+        }
+    }
+
+    if (kind == MatchKind::FULL) { return last_match == input.size() ? last_match : NO_MATCH; }
+    return last_match;
+}
+
+size_t LazyDfaMatcher::simulate(const std::string_view input, size_t position, const State state,
+                                size_t last_match, const MatchKind kind) {
+    current_.assign(dfa_.macrostate_begin(state), dfa_.macrostate_end(state));
+    while (!current_.empty()) {
+        if (std::any_of(current_.begin(), current_.end(), [this](State q) { return aut_.final[q]; })) {
+            if (kind == MatchKind::SHORTEST) { return position; }
+            last_match = position;
+        }
+        if (position == input.size()) { break; }
+
+        const Symbol symbol{ byte_map_[static_cast<unsigned char>(input[position])] };
+        next_.clear();
+        for (const State source: current_) {
+            if (source >= aut_.delta.post_size()) { continue; }
+            const Post& post{ aut_.delta[source] };
+            const auto move{ std::lower_bound(post.begin(), post.end(), symbol, [](const Move& move, Symbol value) {
+                return move.symbol < value;
+            }) };
+            if (move == post.end() || move->symbol != symbol) { continue; }
+            for (const State target: move->targets) {
+                if (target >= in_next_.size()) { in_next_.resize(target + 1, false); }
+                if (!in_next_[target]) {
+                    in_next_[target] = true;
+                    next_.push_back(target);
+                }
+            }
+        }
+        for (const State target: next_) { in_next_[target] = false; }
+        std::swap(current_, next_);
+        ++position;
+    }
+
+    if (kind == MatchKind::FULL) { return last_match == input.size() ? last_match : NO_MATCH; }
+    return last_match;
+}
@@ -0,0 +1,198 @@
+/* nfa-lazy-dfa.cc -- deterministic view of an NFA with macrostates built on demand
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <algorithm>
+#include <deque>
+
+// MATA headers
+#include <mata/nfa-lazy-dfa.hh>
+
+using namespace Mata::Nfa;
+
+namespace {
+    /// Bytes taken by a state of the lazy DFA besides its NFA states: its entry in the macrostate table, its slot
+    ///  in the hash table of the macrostate table (at the maximal load) and its info.
+    constexpr size_t STATE_OVERHEAD{ 16 + 2 * sizeof(uint32_t) + 3 * sizeof(size_t) };
+
+    constexpr State UNVISITED{ std::numeric_limits<State>::max() };
+
+    /// Predecessors of states visited by a breadth-first exploration of a lazy DFA, to rebuild shortest words.
+    class ExplorationTree {
+    public:
+        explicit ExplorationTree(State root) { visit(root, root, 0); }
+
+        /// Mark @p state as reached from @p parent over @p symbol.
+        /// @return False if @p state has already been visited.
+        bool visit(State state, State parent, Symbol symbol) {
+            if (state >= parents_.size()) { parents_.resize(state + 1, { UNVISITED, 0 }); }
+            if (parents_[state].first != UNVISITED) { return false; }
+            parents_[state] = { parent, symbol };
+            return true;
+        }
+
+        /// Word and path of states leading from the root to @p state.
+        Run run_to(State state) const {
+            Run run{};
+            run.path.push_back(state);
+            for (; parents_[state].first != state; state = parents_[state].first) {
+                run.word.push_back(parents_[state].second);
+                run.path.push_back(parents_[state].first);
+            }
+            std::reverse(run.word.begin(), run.word.end());
+            std::reverse(run.path.begin(), run.path.end());
+            return run;
+        }
+
+    private:
+        std::vector<std::pair<State, Symbol>> parents_{};
+    };
+
+    void set_cex(Run* cex, Run run) {
+        if (cex == nullptr) { return; }
+        *cex = std::move(run);
+    }
+}
+
+constexpr size_t LazyDfa::UNBOUNDED;
+constexpr size_t LazyDfa::NOT_EXPANDED;
+constexpr State LazyDfa::NO_STATE;
+
+LazyDfa::LazyDfa(const Nfa& aut, const size_t memory_budget) : aut_{ aut }, memory_budget_{ memory_budget } {}
+
+State LazyDfa::initial() {
+    if (initial_ == NO_STATE) {
+        buffer_.assign(aut_.initial.begin(), aut_.initial.end());
+        std::sort(buffer_.begin(), buffer_.end());
+        initial_ = add_state(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+    return initial_;
+}
+
+State LazyDfa::successor(const State state, const Symbol symbol) {
+    expand(state);
+    const StateInfo& info{ states_[state] };
+    const Successor* const first{ successors_.data() + info.first_successor };
+    const Successor* const last{ first + info.num_of_successors };
+    const Successor* const found{ std::lower_bound(first, last, symbol, [](const Successor& successor, Symbol value) {
+        return successor.symbol < value;
+    }) };
+    const State target{ found != last && found->symbol == symbol ? found->target : add_state(nullptr, nullptr) };
+    return memory_usage_ > memory_budget_ ? flush(target) : target;
+}
+
+LazyDfa::SuccessorRange LazyDfa::successors(const State state) {
+    expand(state);
+    const StateInfo& info{ states_[state] };
+    const Successor* const first{ successors_.data() + info.first_successor };
+    return { first, first + info.num_of_successors };
+}
+
+State LazyDfa::add_state(const State* first, const State* last) {
+    const auto [id, inserted]{ macrostates_.intern(first, last) };
+    if (inserted) {
+        const bool is_final{ std::any_of(first, last, [this](State q) { return aut_.final[q]; }) };
+        states_.push_back({ NOT_EXPANDED, 0, is_final });
+        memory_usage_ += STATE_OVERHEAD + static_cast<size_t>(last - first) * sizeof(State);
+    }
+    return static_cast<State>(id);
+}
+
+void LazyDfa::expand(const State state) {
+    if (states_[state].first_successor != NOT_EXPANDED) { return; }
+    const size_t first_successor{ successors_.size() };
+    // Interning targets does not move macrostates already in the table, the sweep can read the macrostate in place.
+    post_image_.start(aut_.delta, macrostate_begin(state), macrostate_end(state));
+    while (post_image_.next()) {
+        successors_.push_back({ post_image_.symbol(), add_state(post_image_.begin(), post_image_.end()) });
+    }
+    states_[state].first_successor = first_successor;
+    states_[state].num_of_successors = successors_.size() - first_successor;
+    memory_usage_ += states_[state].num_of_successors * sizeof(Successor);
+}
+
+State LazyDfa::flush(const State state) {
+    buffer_.assign(macrostate_begin(state), macrostate_end(state));
+    macrostates_.clear();
+    states_.clear();
+    successors_.clear();
+    initial_ = NO_STATE;
+    memory_usage_ = 0;
+    ++num_of_flushes_;
+    return add_state(buffer_.data(), buffer_.data() + buffer_.size());
+}
+
+bool Mata::Nfa::is_in_lang(LazyDfa& dfa, const Run& word) {
+    State state{ dfa.initial() };
+    for (const Symbol symbol: word.word) {
+        state = dfa.successor(state, symbol);
+        if (dfa.is_dead(state)) { return false; }
+    }
+    return dfa.is_final(state);
+}
+
+bool Mata::Nfa::is_lang_empty(LazyDfa& dfa, Run* cex) {
+    const State initial{ dfa.initial() };
+    ExplorationTree tree{ initial };
+    std::deque<State> worklist{ initial };
+    while (!worklist.empty()) {
+        const State state{ worklist.front() };
+        worklist.pop_front();
+        if (dfa.is_final(state)) {
+            set_cex(cex, tree.run_to(state));
+            return false;
+        }
+        for (const LazyDfa::Successor& successor: dfa.successors(state)) {
+            if (!dfa.is_dead(successor.target) && tree.visit(successor.target, state, successor.symbol)) {
+                worklist.push_back(successor.target);
+            }
+        }
+    }
+    return true;
+}
+
+bool Mata::Nfa::is_universal(LazyDfa& dfa, const Alphabet& alphabet, Run* cex) {
+    const Util::OrdVector<Symbol> symbols{ alphabet.get_alphabet_symbols() };
+    const State initial{ dfa.initial() };
+    ExplorationTree tree{ initial };
+    std::deque<State> worklist{ initial };
+    while (!worklist.empty()) {
+        const State state{ worklist.front() };
+        worklist.pop_front();
+        if (!dfa.is_final(state)) {
+            set_cex(cex, tree.run_to(state));
+            return false;
+        }
+
+        // Symbols of the alphabet without a successor lead to the dead state, which is not final.
+        const LazyDfa::SuccessorRange successors{ dfa.successors(state) };
+        const LazyDfa::Successor* successor{ successors.begin() };
+        for (const Symbol symbol: symbols) {
+            while (successor != successors.end() && successor->symbol < symbol) { ++successor; }
+            if (successor == successors.end() || successor->symbol != symbol) {
+                if (cex != nullptr) {
+                    Run run{ tree.run_to(state) };
+                    run.word.push_back(symbol);
+                    run.path.push_back(dfa.successor(state, symbol));
+                    set_cex(cex, std::move(run));
+                }
+                return false;
+            }
+            if (tree.visit(successor->target, state, symbol)) { worklist.push_back(successor->target); }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,370 @@
+/* nfa-minimization.cc -- NFA minimization
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <algorithm>
+#include <numeric>
+
+// MATA headers
+#include <mata/nfa.hh>
+#include <mata/nfa-algorithms.hh>
+
+using namespace Mata::Nfa;
+using namespace Mata::Util;
+
+namespace {
+
+    /**
+     * Refinable partition of the set {0, ..., n-1} as described by Valmari and Lehtinen in
+     *  'Efficient minimization of DFAs with partial transition functions' (STACS 2008).
+     *
+     * Elements of each set are stored contiguously in @c elems on indices [first[set], past[set]). Elements of a set
+     *  are marked by moving them to the front of the set, a marked set is then split into its marked and unmarked
+     *  part, the smaller part getting a new set index.
+     */
+    class RefinablePartition {
+    public:
+        size_t num_of_sets{ 0 };
+        std::vector<size_t> elems; ///< Elements ordered by the sets they belong to.
+        std::vector<size_t> loc; ///< Index of each element in @c elems.
+        std::vector<size_t> set_of; ///< Set index of each element.
+        std::vector<size_t> first; ///< Index of the first element of each set in @c elems.
+        std::vector<size_t> past; ///< Index one past the last element of each set in @c elems.
+
+        /**
+         * Create partition of @p num_of_elems elements with all elements in a single set.
+         * @param[in] num_of_elems Number of partitioned elements.
+         * @param[in] marked Number of elements marked in each set, shared by all partitions.
+         * @param[in] touched Stack of sets with marked elements, shared by all partitions.
+         */
+        RefinablePartition(size_t num_of_elems, std::vector<size_t>& marked, std::vector<size_t>& touched)
+            : num_of_sets{ num_of_elems == 0 ? 0u : 1u }, elems(num_of_elems), loc(num_of_elems),
+              set_of(num_of_elems, 0), first(num_of_elems + 1, 0), past(num_of_elems + 1, 0), marked_(marked),
+              touched_(touched) {
+            std::iota(elems.begin(), elems.end(), 0);
+            std::iota(loc.begin(), loc.end(), 0);
+            if (num_of_elems > 0) { past[0] = num_of_elems; }
+        }
+
+        /**
+         * Create partition of @p num_of_elems elements with elements split into sets according to @p keys.
+         * Elements with the same key end up in the same set; sets are ordered by keys.
+         */
+        template<typename Key>
+        RefinablePartition(const std::vector<Key>& keys, std::vector<size_t>& marked, std::vector<size_t>& touched)
+            : RefinablePartition(keys.size(), marked, touched) {
+            if (elems.empty()) { return; }
+            std::stable_sort(elems.begin(), elems.end(), [&keys](size_t lhs, size_t rhs) {
+                return keys[lhs] < keys[rhs];
+            });
+            num_of_sets = 0;
+            first[0] = 0;
+            for (size_t i{ 0 }; i < elems.size(); ++i) {
+                const size_t elem{ elems[i] };
+                if (i > 0 && keys[elems[i - 1]] != keys[elem]) {
+                    past[num_of_sets] = i;
+                    ++num_of_sets;
+                    first[num_of_sets] = i;
+                }
+                set_of[elem] = num_of_sets;
+                loc[elem] = i;
+            }
+            past[num_of_sets] = elems.size();
+            ++num_of_sets;
+        }
+
+        /// Mark element @p elem by moving it to the marked prefix of its set.
+        void mark(size_t elem) {
+            const size_t set{ set_of[elem] };
+            const size_t i{ loc[elem] };
+            const size_t j{ first[set] + marked_[set] };
+            elems[i] = elems[j];
+            loc[elems[i]] = i;
+            elems[j] = elem;
+            loc[elem] = j;
+            if (marked_[set]++ == 0) { touched_.push_back(set); }
+        }
+
+        /// Split all touched sets into their marked and unmarked parts.
+        void split() {
+            while (!touched_.empty()) {
+                const size_t set{ touched_.back() };
+                touched_.pop_back();
+                const size_t j{ first[set] + marked_[set] };
+                if (j == past[set]) {
+                    marked_[set] = 0;
+                    continue;
+                }
+                // The smaller part becomes the new set.
+                if (marked_[set] <= past[set] - j) {
+                    first[num_of_sets] = first[set];
+                    past[num_of_sets] = first[set] = j;
+                } else {
+                    past[num_of_sets] = past[set];
+                    first[num_of_sets] = past[set] = j;
+                }
+                for (size_t i{ first[num_of_sets] }; i < past[num_of_sets]; ++i) {
+                    set_of[elems[i]] = num_of_sets;
+                }
+                marked_[set] = 0;
+                marked_[num_of_sets] = 0;
+                ++num_of_sets;
+            }
+        }
+
+    private:
+        std::vector<size_t>& marked_;
+        std::vector<size_t>& touched_;
+    }; // class RefinablePartition.
+
+    /**
+     * Trim deterministic automaton @p aut: keep only states reachable from the initial state from which a final state
+     *  is reachable.
+     * @param[in] aut Deterministic automaton to trim.
+     * @param[out] states Original states of the trimmed automaton (indexed by new states).
+     * @param[out] tails Sources of transitions of the trimmed automaton.
+     * @param[out] symbols Symbols of transitions of the trimmed automaton.
+     * @param[out] heads Targets of transitions of the trimmed automaton.
+     */
+    void trim_dfa(const Nfa& aut, std::vector<State>& states, std::vector<size_t>& tails,
+                  std::vector<Symbol>& symbols, std::vector<size_t>& heads) {
+        const size_t num_of_aut_states{ aut.delta.post_size() };
+        constexpr size_t NONE{ std::numeric_limits<size_t>::max() };
+        std::vector<size_t> renaming(num_of_aut_states, NONE);
+        const auto rename = [&](State state) {
+            if (state >= renaming.size()) { renaming.resize(state + 1, NONE); }
+            if (renaming[state] == NONE) {
+                renaming[state] = states.size();
+                states.push_back(state);
+            }
+            return renaming[state];
+        };
+
+        // Forward reachability from the initial state.
+        rename(*aut.initial.begin());
+        for (size_t i{ 0 }; i < states.size(); ++i) {
+            const State state{ states[i] };
+            if (state >= num_of_aut_states) { continue; }
+            for (const Move& move: aut.delta[state]) {
+                const size_t head{ rename(*move.targets.begin()) };
+                tails.push_back(i);
+                symbols.push_back(move.symbol);
+                heads.push_back(head);
+            }
+        }
+
+        // Backward reachability from the reachable final states.
+        const size_t num_of_reached{ states.size() };
+        std::vector<size_t> in_offsets(num_of_reached + 1, 0);
+        for (const size_t head: heads) { ++in_offsets[head + 1]; }
+        std::partial_sum(in_offsets.begin(), in_offsets.end(), in_offsets.begin());
+        std::vector<size_t> in_trans(heads.size());
+        std::vector<size_t> fill(in_offsets.begin(), in_offsets.end() - 1);
+        for (size_t trans{ 0 }; trans < heads.size(); ++trans) { in_trans[fill[heads[trans]]++] = trans; }
+
+        std::vector<bool> useful(num_of_reached, false);
+        std::vector<size_t> worklist{};
+        for (size_t state{ 0 }; state < num_of_reached; ++state) {
+            if (aut.final[states[state]]) {
+                useful[state] = true;
+                worklist.push_back(state);
+            }
+        }
+        while (!worklist.empty()) {
+            const size_t state{ worklist.back() };
+            worklist.pop_back();
+            for (size_t i{ in_offsets[state] }; i < in_offsets[state + 1]; ++i) {
+                const size_t tail{ tails[in_trans[i]] };
+                if (!useful[tail]) {
+                    useful[tail] = true;
+                    worklist.push_back(tail);
+                }
+            }
+        }
+
+        // Renumber useful states and drop transitions touching useless ones.
+        std::vector<size_t> compacted(num_of_reached, NONE);
+        std::vector<State> useful_states{};
+        for (size_t state{ 0 }; state < num_of_reached; ++state) {
+            if (useful[state]) {
+                compacted[state] = useful_states.size();
+                useful_states.push_back(states[state]);
+            }
+        }
+        size_t kept{ 0 };
+        for (size_t trans{ 0 }; trans < heads.size(); ++trans) {
+            if (useful[tails[trans]] && useful[heads[trans]]) {
+                tails[kept] = compacted[tails[trans]];
+                symbols[kept] = symbols[trans];
+                heads[kept] = compacted[heads[trans]];
+                ++kept;
+            }
+        }
+        tails.resize(kept);
+        symbols.resize(kept);
+        heads.resize(kept);
+        states = std::move(useful_states);
+    }
+
+    /// Make an automaton with a single non-final initial state accepting the empty language.
+    Nfa make_empty_minimal() {
+        Nfa result{ 1 };
+        result.initial.add(0);
+        return result;
+    }
+}
+
+/**
+ * Compute the coarsest partition of states of a trimmed deterministic automaton compatible with the transitions and
+ *  the initial partition given by @p state_labels.
+ */
+std::vector<size_t> Mata::Nfa::Algorithms::refine_dfa_partition(
+        const std::vector<size_t>& state_labels,
+        const std::vector<size_t>& tails,
+        const std::vector<Symbol>& symbols,
+        const std::vector<size_t>& heads)
+{ // {{{
+    const size_t num_of_states{ state_labels.size() };
+    const size_t num_of_trans{ symbols.size() };
+
+    std::vector<size_t> marked(std::max(num_of_states, num_of_trans) + 1, 0);
+    std::vector<size_t> touched{};
+    RefinablePartition blocks{ state_labels, marked, touched };
+    RefinablePartition cords{ symbols, marked, touched };
+
+    // Transitions incoming to each state.
+    std::vector<size_t> in_offsets(num_of_states + 1, 0);
+    for (const size_t head: heads) { ++in_offsets[head + 1]; }
+    std::partial_sum(in_offsets.begin(), in_offsets.end(), in_offsets.begin());
+    std::vector<size_t> in_trans(num_of_trans);
+    {
+        std::vector<size_t> fill(in_offsets.begin(), in_offsets.end() - 1);
+        for (size_t trans{ 0 }; trans < num_of_trans; ++trans) { in_trans[fill[heads[trans]]++] = trans; }
+    }
+
+    // Blocks created from the initial labelling are all splitters, except for the first one.
+    size_t block{ 1 };
+    size_t cord{ 0 };
+    while (cord < cords.num_of_sets) {
+        for (size_t i{ cords.first[cord] }; i < cords.past[cord]; ++i) { blocks.mark(tails[cords.elems[i]]); }
+        blocks.split();
+        ++cord;
+        while (block < blocks.num_of_sets) {
+            for (size_t i{ blocks.first[block] }; i < blocks.past[block]; ++i) {
+                const size_t state{ blocks.elems[i] };
+                for (size_t j{ in_offsets[state] }; j < in_offsets[state + 1]; ++j) { cords.mark(in_trans[j]); }
+            }
+            cords.split();
+            ++block;
+        }
+    }
+
+    return blocks.set_of;
+} // refine_dfa_partition }}}
+
+Nfa Mata::Nfa::Algorithms::minimize_brzozowski(const Nfa& aut) {
+    //compute the minimal deterministic automaton, Brzozovski algorithm
+    Nfa inverted = revert(aut);
+    Nfa tmp = determinize(inverted);
+    Nfa deter = revert(tmp);
+    return determinize(deter);
+}
+
+Nfa Mata::Nfa::Algorithms::minimize_hopcroft(const Nfa& aut) {
+    if (!is_deterministic(aut)) { return minimize_hopcroft(determinize(aut)); }
+    std::vector<size_t> result_labels{};
+    return minimize_hopcroft_labelled(aut, {}, result_labels);
+}
+
+Nfa Mata::Nfa::Algorithms::minimize_hopcroft_labelled(const Nfa& aut, const std::vector<size_t>& state_labels,
+                                                      std::vector<size_t>& result_labels) {
+    if (!is_deterministic(aut)) {
+        throw std::runtime_error(std::string(__func__) + ": the automaton is not deterministic");
+    }
+
+    std::vector<State> states{};
+    std::vector<size_t> tails{};
+    std::vector<Symbol> symbols{};
+    std::vector<size_t> heads{};
+    trim_dfa(aut, states, tails, symbols, heads);
+    if (states.empty()) {
+        result_labels.assign(1, 0);
+        return make_empty_minimal();
+    }
+
+    // States are kept apart by their finality and by their labels.
+    std::vector<size_t> initial_labels(states.size());
+    for (size_t state{ 0 }; state < states.size(); ++state) {
+        const size_t label{ states[state] < state_labels.size() ? state_labels[states[state]] : 0 };
+        initial_labels[state] = 2 * label + aut.final[states[state]];
+    }
+    const std::vector<size_t> block_of{ refine_dfa_partition(initial_labels, tails, symbols, heads) };
+
+    // Number the blocks in the breadth-first order from the initial block.
+    std::vector<size_t> out_offsets(states.size() + 1, 0);
+    for (const size_t tail: tails) { ++out_offsets[tail + 1]; }
+    std::partial_sum(out_offsets.begin(), out_offsets.end(), out_offsets.begin());
+    std::vector<size_t> out_trans(tails.size());
+    {
+        std::vector<size_t> fill(out_offsets.begin(), out_offsets.end() - 1);
+        for (size_t trans{ 0 }; trans < tails.size(); ++trans) { out_trans[fill[tails[trans]]++] = trans; }
+    }
+
+    constexpr State NONE{ std::numeric_limits<State>::max() };
+    const size_t num_of_blocks{ *std::max_element(block_of.begin(), block_of.end()) + 1 };
+    std::vector<State> block_state(num_of_blocks, NONE);
+    std::vector<size_t> representatives{ 0 };
+    block_state[block_of[0]] = 0;
+    Nfa result{ num_of_blocks };
+    result.initial.add(0);
+    result_labels.clear();
+    for (State res_state{ 0 }; res_state < representatives.size(); ++res_state) {
+        const size_t repr{ representatives[res_state] };
+        if (initial_labels[repr] % 2 != 0) { result.final.add(res_state); }
+        result_labels.push_back(initial_labels[repr] / 2);
+        for (size_t i{ out_offsets[repr] }; i < out_offsets[repr + 1]; ++i) {
+            const size_t trans{ out_trans[i] };
+            const size_t head_block{ block_of[heads[trans]] };
+            if (block_state[head_block] == NONE) {
+                block_state[head_block] = representatives.size();
+                representatives.push_back(heads[trans]);
+            }
+            result.delta.add(res_state, symbols[trans], block_state[head_block]);
+        }
+    }
+
+    return result;
+}
+
+Nfa Mata::Nfa::minimize(const Nfa& aut, const StringMap& params) {
+    // setting the default algorithm
+    decltype(Algorithms::minimize_brzozowski)* algo = Algorithms::minimize_brzozowski;
+    if (!haskey(params, "algo")) {
+        if (is_deterministic(aut)) { algo = Algorithms::minimize_hopcroft; }
+        return algo(aut);
+    }
+
+    const std::string& str_algo = params.at("algo");
+    if ("brzozowski" == str_algo) {  /* default */ }
+    else if ("hopcroft" == str_algo) {
+        algo = Algorithms::minimize_hopcroft;
+    } else {
+        throw std::runtime_error(std::to_string(__func__) +
+                                 " received an unknown value of the \"algo\" key: " + str_algo);
+    }
+
+    return algo(aut);
+}
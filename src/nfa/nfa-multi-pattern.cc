@@ -0,0 +1,148 @@
+/* nfa-multi-pattern.cc -- automata of many patterns with final states tagged by pattern ids
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+// MATA headers
+#include <mata/nfa-multi-pattern.hh>
+#include <mata/nfa-algorithms.hh>
+#include <mata/re2parser.hh>
+
+using namespace Mata::Nfa;
+
+namespace {
+    /// Number of states of @p aut including states which appear only as targets, initial or final states.
+    size_t num_of_states(const Nfa& aut) {
+        size_t num_of_states{ aut.delta.post_size() };
+        for (State state{ 0 }; state < aut.delta.post_size(); ++state) {
+            for (const Move& move: aut.delta[state]) {
+                if (!move.targets.empty()) {
+                    num_of_states = std::max(num_of_states, static_cast<size_t>(move.targets.back()) + 1);
+                }
+            }
+        }
+        for (const State state: aut.initial) {
+            num_of_states = std::max(num_of_states, static_cast<size_t>(state) + 1);
+        }
+        for (const State state: aut.final) {
+            num_of_states = std::max(num_of_states, static_cast<size_t>(state) + 1);
+        }
+        return num_of_states;
+    }
+
+    /// Union of tags of the states [@p first, @p last) of @p aut.
+    template<class Iterator>
+    PatternSet union_of_tags(const TaggedNfa& aut, Iterator first, Iterator last) {
+        std::vector<PatternId> ids{};
+        for (; first != last; ++first) {
+            const PatternSet& tags{ aut.get_tags(*first) };
+            ids.insert(ids.end(), tags.begin(), tags.end());
+        }
+        return PatternSet{ ids };
+    }
+}
+
+const PatternSet& TaggedNfa::get_tags(const State state) const {
+    static const PatternSet NO_TAGS{};
+    return state < tags.size() ? tags[state] : NO_TAGS;
+}
+
+TaggedNfa Mata::Nfa::tagged_union(const std::vector<Nfa>& patterns) {
+    std::vector<size_t> offsets{ 0 };
+    for (const Nfa& pattern: patterns) { offsets.push_back(offsets.back() + num_of_states(pattern)); }
+
+    TaggedNfa result{ Nfa{ offsets.back() }, std::vector<PatternSet>(offsets.back()), patterns.size() };
+    for (size_t id{ 0 }; id < patterns.size(); ++id) {
+        const Nfa& pattern{ patterns[id] };
+        const State offset{ static_cast<State>(offsets[id]) };
+        for (const State state: pattern.initial) { result.aut.initial.add(offset + state); }
+        for (const State state: pattern.final) {
+            result.aut.final.add(offset + state);
+            result.tags[offset + state] = PatternSet{ static_cast<PatternId>(id) };
+        }
+        for (State state{ 0 }; state < pattern.delta.post_size(); ++state) {
+            for (const Move& move: pattern.delta[state]) {
+                for (const State target: move.targets) {
+                    result.aut.delta.add(offset + state, move.symbol, offset + target);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+TaggedNfa Mata::Nfa::tagged_union_of_regexes(const std::vector<std::string>& regexes) {
+    std::vector<Nfa> patterns(regexes.size());
+    for (size_t id{ 0 }; id < regexes.size(); ++id) { Mata::RE2Parser::create_nfa(&patterns[id], regexes[id]); }
+    return tagged_union(patterns);
+}
+
+TaggedNfa Mata::Nfa::determinize(const TaggedNfa& aut) {
+    std::unordered_map<StateSet, State> subset_map{};
+    TaggedNfa result{ determinize(aut.aut, &subset_map), {}, aut.num_of_patterns };
+    result.tags.resize(num_of_states(result.aut));
+    for (const auto& [macrostate, state]: subset_map) {
+        result.tags[state] = union_of_tags(aut, macrostate.begin(), macrostate.end());
+    }
+    return result;
+}
+
+TaggedNfa Mata::Nfa::minimize(const TaggedNfa& aut) {
+    if (!is_deterministic(aut.aut)) { return minimize(determinize(aut)); }
+
+    // Each distinct set of tags is a label; the empty set is the label 0.
+    std::map<std::vector<PatternId>, size_t> label_of{ { {}, 0 } };
+    const PatternSet no_tags{};
+    std::vector<const PatternSet*> label_tags{ &no_tags };
+    std::vector<size_t> state_labels(aut.tags.size());
+    for (State state{ 0 }; state < aut.tags.size(); ++state) {
+        const auto [found, inserted]{ label_of.emplace(
+            std::vector<PatternId>(aut.tags[state].begin(), aut.tags[state].end()), label_tags.size()) };
+        if (inserted) { label_tags.push_back(&aut.tags[state]); }
+        state_labels[state] = found->second;
+    }
+
+    std::vector<size_t> result_labels{};
+    TaggedNfa result{ Algorithms::minimize_hopcroft_labelled(aut.aut, state_labels, result_labels), {},
+                      aut.num_of_patterns };
+    result.tags.reserve(result_labels.size());
+    for (const size_t label: result_labels) { result.tags.push_back(*label_tags[label]); }
+    return result;
+}
+
+PatternSet Mata::Nfa::get_matching_patterns(const TaggedNfa& aut, const Run& word) {
+    StateSet current{ aut.aut.initial };
+    for (const Symbol symbol: word.word) {
+        if (current.empty()) { return {}; }
+        current = aut.aut.post(current, symbol);
+    }
+    return union_of_tags(aut, current.begin(), current.end());
+}
+
+MultiPatternMatcher::MultiPatternMatcher(const TaggedNfa& aut, const ByteMap& byte_map)
+    : num_of_patterns_{ aut.num_of_patterns }, tags_{}, automaton_{ compile_minimal(aut, tags_), byte_map } {
+    // The sink state added to the DFA has no tags.
+    tags_.resize(automaton_.num_of_states());
+}
+
+Mata::Dfa::Dfa MultiPatternMatcher::compile_minimal(const TaggedNfa& aut, std::vector<PatternSet>& tags) {
+    TaggedNfa minimal{ minimize(aut) };
+    tags = std::move(minimal.tags);
+    return Dfa::Dfa{ minimal.aut };
+}
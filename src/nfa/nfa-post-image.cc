@@ -0,0 +1,213 @@
+/* nfa-post-image.cc -- computing post images of macrostates without allocations
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <algorithm>
+#include <limits>
+
+// MATA headers
+#include <mata/bits.hh>
+#include <mata/nfa-post-image.hh>
+
+using namespace Mata::Nfa;
+using Mata::Util::lowest_bit;
+
+namespace {
+    /// Index of the bitset word holding @p state.
+    size_t word_index(const State state) { return static_cast<size_t>(state) / 64; }
+    uint64_t bit_mask(const State state) { return uint64_t{ 1 } << (static_cast<size_t>(state) % 64); }
+}
+
+constexpr size_t PostImageEngine::LINEAR_SWEEP_LIMIT;
+
+void PostImageEngine::start(const Delta& delta, const State* first, const State* last) {
+    cursors_.clear();
+    heap_.clear();
+    image_first_ = image_last_ = nullptr;
+    const size_t num_of_posts{ delta.post_size() };
+    for (; first != last; ++first) {
+        if (*first >= num_of_posts) { continue; }
+        const std::vector<Move>& moves{ delta[*first].ToVector() };
+        if (!moves.empty()) { cursors_.push_back({ moves.data(), moves.data() + moves.size() }); }
+    }
+
+    if (cursors_.size() > LINEAR_SWEEP_LIMIT) {
+        for (size_t cursor{ 0 }; cursor < cursors_.size(); ++cursor) {
+            heap_.push_back({ cursors_[cursor].current->symbol, cursor });
+        }
+        for (size_t index{ heap_.size() / 2 }; index > 0; --index) { sift_down(index - 1); }
+    }
+}
+
+bool PostImageEngine::next() {
+    return heap_.empty() ? next_by_scan() : next_by_heap();
+}
+
+bool PostImageEngine::next_by_scan() {
+    if (cursors_.empty()) {
+        image_first_ = image_last_ = nullptr;
+        return false;
+    }
+
+    symbol_ = std::numeric_limits<Symbol>::max();
+    size_t num_of_moves{ 0 };
+    for (const Cursor& cursor: cursors_) {
+        if (cursor.current->symbol < symbol_) {
+            symbol_ = cursor.current->symbol;
+            num_of_moves = 1;
+        } else if (cursor.current->symbol == symbol_) {
+            ++num_of_moves;
+        }
+    }
+
+    buffer_.clear();
+    for (size_t i{ 0 }; i < cursors_.size();) {
+        Cursor& cursor{ cursors_[i] };
+        if (cursor.current->symbol == symbol_) {
+            const TargetSet& targets{ cursor.current->targets };
+            if (num_of_moves == 1) {
+                // The only move over the symbol: its targets are the image as they are.
+                image_first_ = targets.begin();
+                image_last_ = targets.end();
+            } else {
+                add_targets(targets.begin(), targets.end(), buffer_);
+            }
+            if (++cursor.current == cursor.last) {
+                cursor = cursors_.back();
+                cursors_.pop_back();
+                continue;
+            }
+        }
+        ++i;
+    }
+
+    if (num_of_moves > 1) {
+        finish_image(buffer_);
+        image_first_ = buffer_.data();
+        image_last_ = buffer_.data() + buffer_.size();
+    }
+    return true;
+}
+
+void PostImageEngine::post(const Delta& delta, const State* first, const State* last, const Symbol symbol,
+                           std::vector<State>& image) {
+    image.clear();
+    const size_t num_of_posts{ delta.post_size() };
+    for (; first != last; ++first) {
+        if (*first >= num_of_posts) { continue; }
+        const std::vector<Move>& moves{ delta[*first].ToVector() };
+        const auto move{ std::lower_bound(moves.begin(), moves.end(), symbol,
+                                          [](const Move& move, Symbol value) { return move.symbol < value; }) };
+        if (move != moves.end() && move->symbol == symbol) {
+            add_targets(move->targets.begin(), move->targets.end(), image);
+        }
+    }
+    finish_image(image);
+}
+
+bool PostImageEngine::next_by_heap() {
+    // Cursors of a heap sweep are never removed, exhausted ones only leave the heap.
+    symbol_ = heap_.front().symbol;
+    buffer_.clear();
+    size_t num_of_moves{ 0 };
+    const TargetSet* first_targets{ nullptr };
+    while (!heap_.empty() && heap_.front().symbol == symbol_) {
+        Cursor& cursor{ cursors_[heap_.front().cursor] };
+        const TargetSet& targets{ cursor.current->targets };
+        if (num_of_moves == 0) {
+            first_targets = &targets;
+        } else {
+            if (num_of_moves == 1) { add_targets(first_targets->begin(), first_targets->end(), buffer_); }
+            add_targets(targets.begin(), targets.end(), buffer_);
+        }
+        ++num_of_moves;
+
+        if (++cursor.current == cursor.last) {
+            heap_.front() = heap_.back();
+            heap_.pop_back();
+        } else {
+            heap_.front().symbol = cursor.current->symbol;
+        }
+        if (!heap_.empty()) { sift_down(0); }
+    }
+    // All cursors are exhausted: the next call of next() scans the empty set of cursors.
+    if (heap_.empty()) { cursors_.clear(); }
+
+    if (num_of_moves == 1) {
+        image_first_ = first_targets->begin();
+        image_last_ = first_targets->end();
+    } else {
+        finish_image(buffer_);
+        image_first_ = buffer_.data();
+        image_last_ = buffer_.data() + buffer_.size();
+    }
+    return true;
+}
+
+void PostImageEngine::sift_down(size_t index) {
+    const HeapEntry entry{ heap_[index] };
+    const size_t size{ heap_.size() };
+    for (size_t child{ 2 * index + 1 }; child < size; child = 2 * index + 1) {
+        if (child + 1 < size && heap_[child + 1].symbol < heap_[child].symbol) { ++child; }
+        if (!(heap_[child].symbol < entry.symbol)) { break; }
+        heap_[index] = heap_[child];
+        index = child;
+    }
+    heap_[index] = entry;
+}
+
+PostImageEngine& PostImageEngine::thread_local_engine() {
+    static thread_local PostImageEngine engine{};
+    return engine;
+}
+
+void PostImageEngine::add_targets(const State* first, const State* last, std::vector<State>& image) {
+    if (first == last) { return; }
+    // Targets are sorted, the last one is the largest.
+    if (word_index(*(last - 1)) >= seen_.size()) {
+        seen_.resize(std::max(seen_.size() * 2, word_index(*(last - 1)) + 1), 0);
+    }
+    for (; first != last; ++first) {
+        uint64_t& word{ seen_[word_index(*first)] };
+        const uint64_t mask{ bit_mask(*first) };
+        if ((word & mask) == 0) {
+            word |= mask;
+            image.push_back(*first);
+        }
+    }
+}
+
+void PostImageEngine::finish_image(std::vector<State>& image) {
+    if (image.empty()) { return; }
+    const auto [min, max]{ std::minmax_element(image.begin(), image.end()) };
+    const size_t first_word{ word_index(*min) };
+    const size_t last_word{ word_index(*max) };
+    if (last_word - first_word < 2 * image.size()) {
+        // Dense image: read it sorted from the bitset, clearing the bitset on the way.
+        image.clear();
+        for (size_t index{ first_word }; index <= last_word; ++index) {
+            uint64_t word{ seen_[index] };
+            seen_[index] = 0;
+            while (word != 0) {
+                image.push_back(static_cast<State>(index * 64 + lowest_bit(word)));
+                word &= word - 1;
+            }
+        }
+    } else {
+        std::sort(image.begin(), image.end());
+        for (const State state: image) { seen_[word_index(state)] = 0; }
+    }
+}
@@ -18,6 +18,9 @@
 // MATA headers
 #include <mata/nfa.hh>
 #include <mata/nfa-algorithms.hh>
+#include <mata/nfa-post-image.hh>
+#include <mata/nfa-lazy-dfa.hh>
+#include <mata/antichain.hh>
 
 using namespace Mata::Nfa;
 using namespace Mata::Util;
@@ -26,16 +29,15 @@ using namespace Mata::Util;
 // it is not something needed in practice, so some little overhead is ok
 
 
-/// naive universality check (complementation + emptiness)
+/// naive universality check (search for a non-final macrostate of the lazily determinized automaton)
 bool Mata::Nfa::Algorithms::is_universal_naive(
 	const Nfa&         aut,
 	const Alphabet&    alphabet,
 	Run*               cex,
 	const StringMap&  /* params*/)
 { // {{{
-	Nfa cmpl = complement(aut, alphabet);
-
-	return is_lang_empty(cmpl, cex);
+	LazyDfa dfa{ aut };
+	return is_universal(dfa, alphabet, cex);
 } // is_universal_naive }}}
 
 
@@ -48,16 +50,9 @@ bool Mata::Nfa::Algorithms::is_universal_antichains(
 { // {{{
 	(void)params;
 
-	using WorklistType = std::list<StateSet>;
-	using ProcessedType = std::list<StateSet>;
-
-	auto subsumes = [](const StateSet& lhs, const StateSet& rhs) {
-		if (lhs.size() > rhs.size()) { // bigger set cannot be subset
-			return false;
-		}
-
-		return std::includes(rhs.begin(), rhs.end(), lhs.begin(), lhs.end());
-	};
+	// The antichain is not indexed by any key; all macrostates share the same bucket.
+	using MacrostateAntichain = Antichain<bool, StateSet>;
+	using ElementId = MacrostateAntichain::ElementId;
 
 	// process parameters
 	// TODO: set correctly!!!!
@@ -70,34 +65,44 @@ bool Mata::Nfa::Algorithms::is_universal_antichains(
 	}
 
 	// initialize
-	WorklistType worklist = { StateSet(aut.initial) };
-	ProcessedType processed = { StateSet(aut.initial) };
+	// The worklist holds ids of macrostates in the antichain, ids of macrostates removed from the antichain in the
+	// meantime are skipped when popped.
+	MacrostateAntichain processed{};
+	const ElementId initial_id = processed.insert(false, StateSet(aut.initial));
+	std::deque<ElementId> worklist = { initial_id };
 	Mata::Util::OrdVector<Symbol> alph_symbols = alphabet.get_alphabet_symbols();
 
-	// 'paths[s] == t' denotes that state 's' was accessed from state 't',
-	// 'paths[s] == s' means that 's' is an initial state
-	std::map<StateSet, std::pair<StateSet, Symbol>> paths =
-		{ {StateSet(aut.initial), {StateSet(aut.initial), 0}} };
+	// 'paths[s] == t' denotes that the macrostate with the id 's' was accessed from the macrostate with the id 't',
+	// 'paths[s] == s' means that 's' is an initial macrostate
+	std::vector<std::pair<ElementId, Symbol>> paths = { {initial_id, 0} };
+	PostImageEngine post_image{};
 
 	while (!worklist.empty()) {
 		// get a next state
-		StateSet state;
+		ElementId state;
 		if (is_dfs) {
-			state = *worklist.rbegin();
+			state = worklist.back();
 			worklist.pop_back();
 		} else { // BFS
-			state = *worklist.begin();
+			state = worklist.front();
 			worklist.pop_front();
 		}
+		if (!processed.is_alive(state)) { continue; }
 
-		// process it
+		// process it; images of the macrostate under all symbols are computed in one sweep, symbols of the alphabet
+		// missing in the sweep have empty images
+		post_image.start(aut.delta, processed.set_begin(state), processed.set_end(state));
+		bool has_image = post_image.next();
 		for (Symbol symb : alph_symbols) {
-			StateSet succ = aut.post(state, symb);
-			if (are_disjoint(succ, aut.final)) {
+			while (has_image && post_image.symbol() < symb) { has_image = post_image.next(); }
+			const bool is_nonempty = has_image && post_image.symbol() == symb;
+			const State* const succ_begin = is_nonempty ? post_image.begin() : nullptr;
+			const State* const succ_end = is_nonempty ? post_image.end() : nullptr;
+			if (std::none_of(succ_begin, succ_end, [&aut](State q) { return aut.final[q]; })) {
 				if (nullptr != cex) {
 					cex->word.clear();
 					cex->word.push_back(symb);
-					StateSet trav = state;
+					ElementId trav = state;
 					while (paths[trav].first != trav)
 					{ // go back until initial state
 						cex->word.push_back(paths[trav].second);
@@ -110,41 +115,107 @@ bool Mata::Nfa::Algorithms::is_universal_antichains(
 				return false;
 			}
 
-			bool is_subsumed = false;
-			for (const auto& anti_state : processed) {
-				// trying to find a smaller state in processed
-				if (subsumes(anti_state, succ)) {
-					is_subsumed = true;
-					break;
-				}
-			}
+			// prune data structures and insert succ inside
+			const auto [succ_id, inserted] = processed.insert_if_not_subsumed(false, succ_begin, succ_end);
+			if (!inserted) { continue; }
 
-			if (is_subsumed) { continue; }
+			// TODO: set pushing strategy
+			worklist.push_back(succ_id);
 
-			// prune data structures and insert succ inside
-			for (std::list<StateSet>* ds : {&processed, &worklist}) {
-				auto it = ds->begin();
-				while (it != ds->end()) {
-					if (subsumes(succ, *it)) {
-						auto to_remove = it;
-						++it;
-						ds->erase(to_remove);
-					} else {
-						++it;
+			// also set that succ was accessed from state
+			paths.emplace_back(state, symb);
+		}
+	}
+
+	return true;
+} // }}}
+
+/// universality check using Antichains with simulation-based pruning and subsumption
+bool Mata::Nfa::Algorithms::is_universal_antichains_sim(
+	const Nfa&         aut,
+	const Alphabet&    alphabet,
+	Run*               cex,
+	const StringMap&  /* params*/)
+{ // {{{
+	const Simlib::Util::BinaryRelation sim = compute_relation(aut);
+
+	// 'is_simulated(p, q)' denotes that the state 'q' simulates the state 'p'
+	auto is_simulated = [&sim](State p, State q) {
+		return p == q || (p < sim.size() && q < sim.size() && sim.get(p, q));
+	};
+	// keep only simulation-maximal states (one representative of states simulating each other)
+	auto minimize_macrostate = [&](const StateSet& macrostate) {
+		std::vector<State> maximal;
+		for (const State p : macrostate) {
+			const bool is_dominated = std::any_of(macrostate.begin(), macrostate.end(), [&](State q) {
+				return p != q && is_simulated(p, q) && (!is_simulated(q, p) || q < p);
+			});
+			if (!is_dominated) { maximal.push_back(p); }
+		}
+		return StateSet(maximal);
+	};
+
+	// check the initial state
+	if (are_disjoint(aut.initial, aut.final)) {
+		if (nullptr != cex) { cex->word.clear(); }
+		return false;
+	}
+
+	// A processed macrostate R subsumes a macrostate P if every state of R is simulated by some state of P, hence
+	// L(R) <= L(P). The antichain is not indexed by any key; all macrostates share the same bucket.
+	using SimulationOrder = ForallExistsOrder<decltype(is_simulated)>;
+	using MacrostateAntichain = Antichain<bool, StateSet, SimulationOrder>;
+	using ElementId = MacrostateAntichain::ElementId;
+
+	// initialize
+	// The worklist holds ids of macrostates in the antichain, ids of macrostates removed from the antichain in the
+	// meantime are skipped when popped.
+	MacrostateAntichain processed{ SimulationOrder{ is_simulated } };
+	const ElementId initial_id = processed.insert(false, minimize_macrostate(StateSet(aut.initial)));
+	std::deque<ElementId> worklist = { initial_id };
+	Mata::Util::OrdVector<Symbol> alph_symbols = alphabet.get_alphabet_symbols();
+
+	// 'paths[s] == t' denotes that the macrostate with the id 's' was accessed from the macrostate with the id 't',
+	// 'paths[s] == s' means that 's' is an initial macrostate
+	std::vector<std::pair<ElementId, Symbol>> paths = { {initial_id, 0} };
+
+	// breadth-first search yields the shortest counterexample
+	while (!worklist.empty()) {
+		const ElementId state = worklist.front();
+		worklist.pop_front();
+		if (!processed.is_alive(state)) { continue; }
+
+		const StateSet macrostate = processed.get_set(state);
+		for (Symbol symb : alph_symbols) {
+			const StateSet succ = minimize_macrostate(aut.post(macrostate, symb));
+			if (are_disjoint(succ, aut.final)) {
+				if (nullptr != cex) {
+					cex->word.clear();
+					cex->word.push_back(symb);
+					ElementId trav = state;
+					while (paths[trav].first != trav)
+					{ // go back until initial state
+						cex->word.push_back(paths[trav].second);
+						trav = paths[trav].first;
 					}
+
+					std::reverse(cex->word.begin(), cex->word.end());
 				}
 
-				// TODO: set pushing strategy
-				ds->push_back(succ);
+				return false;
 			}
 
-			// also set that succ was accessed from state
-			paths[succ] = {state, symb};
+			// succ is dropped if a processed macrostate subsumes it, processed macrostates subsumed by succ are removed
+			const auto [succ_id, inserted] = processed.insert_if_not_subsumed(false, succ);
+			if (!inserted) { continue; }
+
+			worklist.push_back(succ_id);
+			paths.emplace_back(state, symb);
 		}
 	}
 
 	return true;
-} // }}}
+} // is_universal_antichains_sim }}}
 
 // The dispatching method that calls the correct one based on parameters
 bool Mata::Nfa::is_universal(
@@ -166,6 +237,8 @@ bool Mata::Nfa::is_universal(
 	if ("naive" == str_algo) { /* default */ }
 	else if ("antichains" == str_algo) {
 		algo = Algorithms::is_universal_antichains;
+	} else if ("antichains-sim" == str_algo) {
+		algo = Algorithms::is_universal_antichains_sim;
 	} else {
 		throw std::runtime_error(std::to_string(__func__) +
 			" received an unknown value of the \"algo\" key: " + str_algo);
@@ -18,10 +18,12 @@
 #include <algorithm>
 #include <list>
 #include <unordered_set>
+#include <tuple>
 
 // MATA headers
 #include <mata/nfa.hh>
 #include <mata/nfa-algorithms.hh>
+#include <mata/nfa-post-image.hh>
 #include <mata/simlib/explicit_lts.hh>
 
 using std::tie;
@@ -170,19 +172,22 @@ namespace {
     }
 
     /**
-     * Compute reachability of states considering only specified states.
+     * Compute backward reachability of final states considering only specified states.
      *
-     * @param[in] nfa NFA to compute reachability for.
-     * @param[in] states_to_consider State to consider as potentially reachable.
-     * @return Bool array for reachable states (from initial states): true for reachable, false for unreachable states.
+     * Predecessors are taken from the predecessor index of the transition relation, so that the automaton does not need
+     *  to be reverted.
+     *
+     * @param[in] nfa NFA to compute backward reachability for.
+     * @param[in] states_to_consider State to consider as potentially reaching final states.
+     * @return Bool array for states reaching final states: true for states reaching final states, false for others.
      */
-    StateBoolArray compute_reachability(const Nfa& nfa, const StateBoolArray& states_to_consider) {
+    StateBoolArray compute_coreachability(const Nfa& nfa, const StateBoolArray& states_to_consider) {
         std::vector<State> worklist{};
-        StateBoolArray reachable(nfa.delta.post_size(), false);
-        for (const State state: nfa.initial) {
-            if (states_to_consider[state]) {
+        StateBoolArray coreachable(states_to_consider.size(), false);
+        for (const State state: nfa.final) {
+            if (state < states_to_consider.size() && states_to_consider[state]) {
                 worklist.push_back(state);
-                reachable.at(state) = true;
+                coreachable[state] = true;
             }
         }
 
@@ -191,17 +196,15 @@ namespace {
             state = worklist.back();
             worklist.pop_back();
 
-            for (const auto& state_transitions: nfa.delta[state]) {
-                for (const State target_state: state_transitions.targets) {
-                    if (states_to_consider[target_state] && !reachable[target_state]) {
-                        worklist.push_back(target_state);
-                        reachable[target_state] = true;
-                    }
+            for (const Predecessor& predecessor: nfa.delta.get_predecessors(state)) {
+                if (states_to_consider[predecessor.source] && !coreachable[predecessor.source]) {
+                    worklist.push_back(predecessor.source);
+                    coreachable[predecessor.source] = true;
                 }
             }
         }
 
-        return reachable;
+        return coreachable;
     }
 
     /**
@@ -282,6 +285,115 @@ namespace {
             }
         }
     }
+
+    /**
+     * Compute strongly connected components of the subgraph of @p aut induced by @p epsilon transitions (iterative
+     *  Tarjan's algorithm).
+     * @param[in] aut Automaton to compute components for.
+     * @param[in] epsilon Symbol of epsilon transitions.
+     * @param[out] scc_of Component of each state.
+     * @return Number of components. Components are numbered in the reverse topological order, i.e., epsilon
+     *  transitions lead only to components with smaller or equal numbers.
+     */
+    size_t compute_eps_sccs(const Nfa& aut, const Symbol epsilon, std::vector<size_t>& scc_of) {
+        const size_t num_of_states{ aut.delta.post_size() };
+        constexpr size_t UNVISITED{ std::numeric_limits<size_t>::max() };
+        const TargetSet empty_targets{};
+        const auto eps_targets = [&](State state) -> const TargetSet& {
+            const Post& post{ aut.delta[state] };
+            const auto eps_move{ post.find(Move{ epsilon }) };
+            return eps_move == post.end() ? empty_targets : eps_move->targets;
+        };
+
+        std::vector<size_t> index(num_of_states, UNVISITED);
+        std::vector<size_t> lowlink(num_of_states, 0);
+        std::vector<bool> on_stack(num_of_states, false);
+        std::vector<State> scc_stack{};
+        // Call stack of the depth-first search: a state and the position of the next epsilon target to visit.
+        std::vector<std::pair<State, size_t>> call_stack{};
+        scc_of.assign(num_of_states, UNVISITED);
+        size_t next_index{ 0 };
+        size_t num_of_sccs{ 0 };
+
+        for (State root{ 0 }; root < num_of_states; ++root) {
+            if (index[root] != UNVISITED) { continue; }
+            call_stack.emplace_back(root, 0);
+            index[root] = lowlink[root] = next_index++;
+            scc_stack.push_back(root);
+            on_stack[root] = true;
+
+            while (!call_stack.empty()) {
+                auto& [state, position]{ call_stack.back() };
+                const TargetSet& targets{ eps_targets(state) };
+                if (position < targets.size()) {
+                    const State target{ targets.ToVector()[position++] };
+                    if (target >= num_of_states) { continue; }
+                    if (index[target] == UNVISITED) {
+                        index[target] = lowlink[target] = next_index++;
+                        scc_stack.push_back(target);
+                        on_stack[target] = true;
+                        call_stack.emplace_back(target, 0);
+                    } else if (on_stack[target]) {
+                        lowlink[state] = std::min(lowlink[state], index[target]);
+                    }
+                    continue;
+                }
+
+                const State finished{ state };
+                call_stack.pop_back();
+                if (!call_stack.empty()) {
+                    const State parent{ call_stack.back().first };
+                    lowlink[parent] = std::min(lowlink[parent], lowlink[finished]);
+                }
+                if (lowlink[finished] == index[finished]) {
+                    State member;
+                    do {
+                        member = scc_stack.back();
+                        scc_stack.pop_back();
+                        on_stack[member] = false;
+                        scc_of[member] = num_of_sccs;
+                    } while (member != finished);
+                    ++num_of_sccs;
+                }
+            }
+        }
+        return num_of_sccs;
+    }
+
+    bool trans_less(const Trans& lhs, const Trans& rhs) {
+        return std::tie(lhs.src, lhs.symb, lhs.tgt) < std::tie(rhs.src, rhs.symb, rhs.tgt);
+    }
+
+    /**
+     * Sort @p transitions by sources, symbols and targets.
+     *
+     * Sources are usually dense, so transitions are distributed to buckets of their sources first (stably, keeping the
+     *  order of symbols of transitions generated state by state) and only the buckets which are not sorted yet are
+     *  sorted then.
+     */
+    void sort_transitions(TransSequence& transitions) {
+        if (std::is_sorted(transitions.begin(), transitions.end(), trans_less)) { return; }
+
+        State max_src{ 0 };
+        for (const Trans& trans: transitions) { max_src = std::max(max_src, trans.src); }
+        if (max_src >= transitions.size()) {
+            std::sort(transitions.begin(), transitions.end(), trans_less);
+            return;
+        }
+
+        std::vector<size_t> bucket_begins(static_cast<size_t>(max_src) + 2, 0);
+        for (const Trans& trans: transitions) { ++bucket_begins[trans.src + 1]; }
+        for (size_t src{ 1 }; src < bucket_begins.size(); ++src) { bucket_begins[src] += bucket_begins[src - 1]; }
+        TransSequence bucketed(transitions.size());
+        std::vector<size_t> bucket_ends{ bucket_begins.begin(), bucket_begins.end() - 1 };
+        for (const Trans& trans: transitions) { bucketed[bucket_ends[trans.src]++] = trans; }
+        for (size_t src{ 0 }; src <= max_src; ++src) {
+            const auto bucket_begin{ bucketed.begin() + static_cast<std::ptrdiff_t>(bucket_begins[src]) };
+            const auto bucket_end{ bucketed.begin() + static_cast<std::ptrdiff_t>(bucket_ends[src]) };
+            if (!std::is_sorted(bucket_begin, bucket_end, trans_less)) { std::sort(bucket_begin, bucket_end, trans_less); }
+        }
+        transitions = std::move(bucketed);
+    }
 }
 
 std::ostream &std::operator<<(std::ostream &os, const Mata::Nfa::Trans &trans) { // {{{
@@ -342,6 +454,7 @@ size_t Delta::size() const
 
 void Delta::add(State state_from, Symbol symbol, State state_to)
 {
+    invalidate_predecessor_index();
     if (state_from >= post.size()) {
         post.resize(state_from+1);
     }
@@ -370,7 +483,69 @@ void Delta::add(State state_from, Symbol symbol, State state_to)
         max_state_ = state_to;
 }
 
+void Delta::add_bulk(TransSequence transitions)
+{
+    invalidate_predecessor_index();
+    if (transitions.empty()) { return; }
+
+    sort_transitions(transitions);
+    transitions.erase(std::unique(transitions.begin(), transitions.end()), transitions.end());
+
+    const State max_src{ transitions.back().src };
+    if (max_src >= post.size()) { post.resize(max_src + 1); }
+
+    const auto transitions_end{ transitions.end() };
+    for (auto src_begin{ transitions.begin() }; src_begin != transitions_end;) {
+        const State src{ src_begin->src };
+        auto src_end{ src_begin };
+        size_t num_of_moves{ 0 };
+        for (; src_end != transitions_end && src_end->src == src; ++src_end) {
+            if (src_end == src_begin || (src_end - 1)->symb != src_end->symb) { ++num_of_moves; }
+            max_state_ = std::max<size_t>(max_state_, src_end->tgt);
+        }
+        max_state_ = std::max<size_t>(max_state_, src);
+
+        // Build moves of 'src' in the order of symbols.
+        Post new_post{};
+        new_post.reserve(num_of_moves);
+        for (auto move_begin{ src_begin }; move_begin != src_end;) {
+            auto move_end{ move_begin };
+            while (move_end != src_end && move_end->symb == move_begin->symb) { ++move_end; }
+            Move move{ move_begin->symb };
+            move.targets.reserve(static_cast<size_t>(move_end - move_begin));
+            for (auto it{ move_begin }; it != move_end; ++it) { move.targets.push_back(it->tgt); }
+            new_post.push_back(std::move(move));
+            move_begin = move_end;
+        }
+
+        Post& state_post{ post[src] };
+        if (state_post.empty()) {
+            state_post = std::move(new_post);
+        } else {
+            // Merge with the existing moves of 'src'.
+            Post merged_post{};
+            merged_post.reserve(state_post.size() + new_post.size());
+            auto old_it{ state_post.cbegin() };
+            auto new_it{ new_post.begin() };
+            while (old_it != state_post.cend() || new_it != new_post.end()) {
+                if (new_it == new_post.end() || (old_it != state_post.cend() && old_it->symbol < new_it->symbol)) {
+                    merged_post.push_back(*old_it++);
+                } else if (old_it == state_post.cend() || new_it->symbol < old_it->symbol) {
+                    merged_post.push_back(std::move(*new_it++));
+                } else {
+                    merged_post.push_back(Move{ old_it->symbol, old_it->targets.Union(new_it->targets) });
+                    ++old_it;
+                    ++new_it;
+                }
+            }
+            state_post = std::move(merged_post);
+        }
+        src_begin = src_end;
+    }
+}
+
 void Delta::remove(State src, Symbol symb, State tgt) {
+    invalidate_predecessor_index();
     if (src >= post.size()) {
         return;
     }
@@ -420,6 +595,44 @@ bool Delta::contains(State src, Symbol symb, State tgt) const
     return symbol_transitions->targets.find(tgt) != symbol_transitions->targets.end();
 }
 
+void Delta::build_predecessor_index() const
+{
+    // Count in-degrees first, then place predecessors by a counting sort over targets. Targets may exceed the sources
+    //  stored in 'post'.
+    predecessor_offsets_.assign(post.size() + 1, 0);
+    for (const Post& state_post: post) {
+        for (const Move& move: state_post) {
+            for (const State target: move.targets) {
+                if (target + 1 >= predecessor_offsets_.size()) { predecessor_offsets_.resize(target + 2, 0); }
+                ++predecessor_offsets_[target + 1];
+            }
+        }
+    }
+    const size_t num_of_states{ predecessor_offsets_.size() - 1 };
+    for (size_t state{ 0 }; state < num_of_states; ++state) {
+        predecessor_offsets_[state + 1] += predecessor_offsets_[state];
+    }
+
+    predecessors_.resize(predecessor_offsets_[num_of_states]);
+    std::vector<size_t> positions(predecessor_offsets_.begin(), predecessor_offsets_.end() - 1);
+    const size_t num_of_sources{ post.size() };
+    for (State source{ 0 }; source < num_of_sources; ++source) {
+        for (const Move& move: post[source]) {
+            for (const State target: move.targets) {
+                predecessors_[positions[target]++] = { source, move.symbol };
+            }
+        }
+    }
+}
+
+PredecessorRange Delta::get_predecessors(const State target) const
+{
+    if (predecessor_offsets_.empty()) { build_predecessor_index(); }
+    if (target + 1 >= predecessor_offsets_.size()) { return { nullptr, nullptr }; }
+    const Predecessor* const predecessors{ predecessors_.data() };
+    return { predecessors + predecessor_offsets_[target], predecessors + predecessor_offsets_[target + 1] };
+}
+
 bool Delta::empty() const
 {
     return this->begin() == this->end();
@@ -427,6 +640,7 @@ bool Delta::empty() const
 
 std::vector<State> Delta::defragment()
 {
+    invalidate_predecessor_index();
     std::vector<State> renaming(this->post.size());
     std::vector<State> removed{};
 
@@ -459,7 +673,7 @@ std::vector<State> Delta::defragment()
     // rename states according to reindexing done above
     for (Post& p : this->post) {
         for (Move& m : p) {
-            StateSet new_targets{};
+            TargetSet new_targets{};
             const size_t renaming_size = renaming.size();
             for (State i = 0; i < renaming_size; ++i) {
                 if (m.count(i)) {
@@ -561,7 +775,19 @@ StateSet Nfa::get_reachable_states() const
 
 StateSet Nfa::get_terminating_states() const
 {
-    return revert(*this).get_reachable_states();
+    const size_t num_of_states{ std::max<size_t>(delta.post_size(), final.domain_size()) };
+    const StateBoolArray terminating_bool_array{ compute_coreachability(*this, StateBoolArray(num_of_states, true)) };
+
+    StateSet terminating_states{};
+    for (State original_state{ 0 }; original_state < num_of_states; ++original_state)
+    {
+        if (terminating_bool_array[original_state])
+        {
+            terminating_states.insert(original_state);
+        }
+    }
+
+    return terminating_states;
 }
 
 void Nfa::trim()
@@ -586,9 +812,8 @@ StateSet Nfa::get_useful_states() const
 {
     if (initial.empty() || final.empty()) { return StateSet{}; }
 
-    const Nfa digraph{get_one_letter_aut() }; // Compute reachability on directed graph.
     // Compute reachability from the initial states and use the reachable states to compute the reachability from the final states.
-    const StateBoolArray useful_states_bool_array{ compute_reachability(revert(digraph), compute_reachability(digraph)) };
+    const StateBoolArray useful_states_bool_array{ compute_coreachability(*this, compute_reachability(*this)) };
 
     const size_t num_of_states{delta.post_size() };
     StateSet useful_states{};
@@ -672,7 +897,7 @@ void Mata::Nfa::make_complete(
                 // TODO: Possibly fix insert.
                 used_symbols.insert(symb_stateset.symbol);
 
-                const StateSet &stateset = symb_stateset.targets;
+                const TargetSet &stateset = symb_stateset.targets;
                 for (const auto &tgt_state: stateset) {
                     bool inserted;
                     tie(std::ignore, inserted) = processed.insert(tgt_state);
@@ -691,76 +916,78 @@ void Mata::Nfa::make_complete(
 
 Nfa Mata::Nfa::remove_epsilon(const Nfa& aut, Symbol epsilon)
 {
-    Nfa result;
-
-    result.clear();
-    result.increase_size(aut.delta.post_size());
-
-    // cannot use multimap, because it can contain multiple occurrences of (a -> a), (a -> a)
-    std::unordered_map<State, StateSet> eps_closure;
-
-    // TODO: grossly inefficient
-    // first we compute the epsilon closure
-    const size_t num_of_states{aut.delta.post_size() };
-    for (size_t i{ 0 }; i < num_of_states; ++i)
-    {
-        for (const auto& trans: aut[i])
-        { // initialize
-            const auto it_ins_pair = eps_closure.insert({i, {i}});
-            if (trans.symbol == epsilon)
-            {
-                StateSet& closure = it_ins_pair.first->second;
-                // TODO: Fix possibly insert to OrdVector. Create list already ordered, then merge (do not need to resize each time);
-                closure.insert(trans.targets);
-            }
-        }
-    }
-
-    bool changed = true;
-    while (changed) { // compute the fixpoint
-        changed = false;
-        for (size_t i=0; i < num_of_states; ++i) {
-            const auto& state_transitions{ aut[i] };
-            const auto state_symbol_transitions{
-                state_transitions.find(Move{epsilon}) };
-            if (state_symbol_transitions != state_transitions.end()) {
-                StateSet &src_eps_cl = eps_closure[i];
-                for (const State tgt: state_symbol_transitions->targets) {
-                    const StateSet &tgt_eps_cl = eps_closure[tgt];
-                    for (const State st: tgt_eps_cl) {
-                        if (src_eps_cl.count(st) == 0) {
-                            changed = true;
-                            break;
-                        }
-                    }
-                    src_eps_cl.insert(tgt_eps_cl);
+    const size_t num_of_states{ aut.delta.post_size() };
+
+    // Epsilon closures are computed per strongly connected component of the epsilon subgraph: all states of
+    //  a component share the closure. Components are processed in the reverse topological order, so closures of
+    //  all components reachable over epsilon transitions are known when a component is processed.
+    std::vector<size_t> scc_of;
+    const size_t num_of_sccs{ compute_eps_sccs(aut, epsilon, scc_of) };
+    std::vector<std::vector<State>> scc_members(num_of_sccs);
+    for (State state{ 0 }; state < num_of_states; ++state) { scc_members[scc_of[state]].push_back(state); }
+
+    std::vector<std::vector<State>> scc_closure(num_of_sccs);
+    for (size_t scc{ 0 }; scc < num_of_sccs; ++scc) {
+        std::vector<State>& closure{ scc_closure[scc] };
+        closure = scc_members[scc];
+        for (const State state: scc_members[scc]) {
+            const Post& post{ aut.delta[state] };
+            const auto eps_move{ post.find(Move{ epsilon }) };
+            if (eps_move == post.end()) { continue; }
+            for (const State target: eps_move->targets) {
+                if (target >= num_of_states) {
+                    closure.push_back(target);
+                } else if (scc_of[target] != scc) {
+                    const std::vector<State>& target_closure{ scc_closure[scc_of[target]] };
+                    closure.insert(closure.end(), target_closure.begin(), target_closure.end());
                 }
             }
         }
+        std::sort(closure.begin(), closure.end());
+        closure.erase(std::unique(closure.begin(), closure.end()), closure.end());
     }
 
     // now we construct the automaton without epsilon transitions
+    Nfa result;
+    result.clear();
+    result.increase_size(num_of_states);
     result.initial.add(aut.initial.get_elements());
     result.final.add(aut.final.get_elements());
-    State max_state{};
-    for (const auto& state_closure_pair : eps_closure) { // for every state
-        State src_state = state_closure_pair.first;
-        for (State eps_cl_state : state_closure_pair.second) { // for every state in its eps cl
-            if (aut.final[eps_cl_state]) result.final.add(src_state);
-            for (const auto& symb_set : aut[eps_cl_state]) {
-                if (symb_set.symbol == epsilon) continue;
-
-                // TODO: this could be done more efficiently if we had a better add method
-                for (State tgt_state : symb_set.targets) {
-                    max_state = std::max(src_state, tgt_state);
-                    if (result.delta.post_size() < max_state) {
-                        result.increase_size_for_state(max_state);
-                    }
-                    result.delta.add(src_state, symb_set.symbol, tgt_state);
-                }
+
+    std::vector<std::pair<Symbol, State>> trans{};
+    State max_state{ num_of_states == 0 ? 0 : num_of_states - 1 };
+    for (size_t scc{ 0 }; scc < num_of_sccs; ++scc) {
+        // collect non-epsilon transitions of the closure and build the post of the component in bulk
+        trans.clear();
+        bool is_final{ false };
+        for (const State cl_state: scc_closure[scc]) {
+            if (aut.final[cl_state]) { is_final = true; }
+            if (cl_state >= num_of_states) { continue; }
+            for (const Move& move: aut.delta[cl_state]) {
+                if (move.symbol == epsilon) { continue; }
+                for (const State target: move.targets) { trans.emplace_back(move.symbol, target); }
+            }
+        }
+        std::sort(trans.begin(), trans.end());
+        trans.erase(std::unique(trans.begin(), trans.end()), trans.end());
+
+        Post post{};
+        for (auto it{ trans.begin() }; it != trans.end();) {
+            const Symbol symbol{ it->first };
+            std::vector<State> targets{};
+            for (; it != trans.end() && it->first == symbol; ++it) {
+                targets.push_back(it->second);
+                max_state = std::max(max_state, it->second);
             }
+            post.insert(Move{ symbol, TargetSet(targets) });
+        }
+
+        for (const State state: scc_members[scc]) {
+            if (is_final) { result.final.add(state); }
+            if (!post.empty()) { result.delta[state] = post; }
         }
     }
+    if (max_state >= result.delta.post_size()) { result.increase_size(max_state + 1); }
 
     return result;
 }
@@ -983,14 +1210,6 @@ bool Mata::Nfa::is_lang_empty(const Nfa& aut, Run* cex)
     return true;
 } // is_lang_empty }}}
 
-Nfa Mata::Nfa::minimize(const Nfa& aut) {
-    //compute the minimal deterministic automaton, Brzozovski algorithm
-    Nfa inverted = revert(aut);
-    Nfa tmp = determinize(inverted);
-    Nfa deter = revert(tmp);
-    return determinize(deter);
-}
-
 void Nfa::print_to_DOT(std::ostream &outputStream) const {
     outputStream << "digraph finiteAutomaton {" << std::endl
                  << "node [shape=circle];" << std::endl;
@@ -1076,32 +1295,22 @@ void Nfa::get_one_letter_aut(Nfa& result) const {
 
 TransSequence Nfa::get_transitions_to(State state_to) const {
     TransSequence transitions_to_state{};
-    const size_t num_of_states{delta.post_size() };
-    for (State state_from{ 0 }; state_from < num_of_states; ++state_from) {
-        for (const auto& symbol_transitions: delta[state_from]) {
-            const auto& symbol_states_to{ symbol_transitions.targets };
-            const auto target_state{ symbol_states_to.find(state_to) };
-            if (target_state != symbol_states_to.end()) {
-                transitions_to_state.push_back({ state_from, symbol_transitions.symbol, state_to });
-            }
-        }
+    const PredecessorRange predecessors{ delta.get_predecessors(state_to) };
+    transitions_to_state.reserve(predecessors.size());
+    for (const Predecessor& predecessor: predecessors) {
+        transitions_to_state.emplace_back(predecessor.source, predecessor.symbol, state_to);
     }
     return transitions_to_state;
 }
 
 StateSet Nfa::post(const StateSet& states, const Symbol& symbol) const {
-    StateSet res{};
-    if (delta.empty()) {
-        return res;
-    }
-
-    for (const auto state : states) {
-        const auto& state_transitions{delta[state] };
-        const auto state_symbol_transitions{ state_transitions.find(Move{symbol }) };
-        if (state_symbol_transitions != state_transitions.end()) {
-            res.insert(state_symbol_transitions->targets);
-        }
-    }
+    // The image is computed in buffers of the calling thread, only the result is allocated.
+    static thread_local std::vector<State> image{};
+    const std::vector<State>& state_vector{ states.ToVector() };
+    PostImageEngine::thread_local_engine().post(delta, state_vector.data(), state_vector.data() + state_vector.size(),
+                                                symbol, image);
+    StateSet res{ StateSet::with_reserved(image.size()) };
+    for (const State state: image) { res.push_back(state); }
     return res;
 }
 
@@ -1210,17 +1419,19 @@ Nfa Mata::Nfa::determinize(
         const Nfa&  aut,
         std::unordered_map<StateSet, State> *subset_map)
 {
+    Algorithms::SubsetMap flat_subset_map{};
+    Nfa result{ Algorithms::determinize_classical(aut, flat_subset_map) };
+    if (subset_map != nullptr) { flat_subset_map.move_to(*subset_map); }
+    return result;
+}
 
+Nfa Mata::Nfa::Algorithms::determinize_classical(const Nfa& aut, SubsetMap& subset_map)
+{
     Nfa result;
     //assuming all sets targets are non-empty
-    std::vector<std::pair<State, StateSet>> worklist;
-    bool deallocate_subset_map = false;
-    if (subset_map == nullptr) {
-        subset_map = new std::unordered_map<StateSet,State>();
-        deallocate_subset_map = true;
-    }
-
-    result.clear();
+    // Ids of macrostates in the subset map, which are also their states in the result.
+    std::vector<State> worklist;
+    subset_map.clear();
 
     const StateSet S0 =  StateSet(aut.initial);
     const State S0id = result.add_state();
@@ -1229,59 +1440,99 @@ Nfa Mata::Nfa::determinize(
     if (!are_disjoint(S0, aut.final)) {
         result.final.add(S0id);
     }
-    worklist.emplace_back(std::make_pair(S0id, S0));
-
-    (*subset_map)[Mata::Util::OrdVector<State>(S0)] = S0id;
+    subset_map.emplace(S0, S0id);
+    worklist.push_back(S0id);
 
     if (aut.delta.empty())
         return result;
 
-    using Iterator = Mata::Util::OrdVector<Move>::const_iterator;
-    Mata::Util::SynchronizedExistentialIterator<Iterator> synchronized_iterator;
+    PostImageEngine post_image{};
 
     while (!worklist.empty()) {
-        const auto Spair = worklist.back();
+        const State Sid = worklist.back();
         worklist.pop_back();
-        const StateSet S = Spair.second;
-        const State Sid = Spair.first;
-        if (S.empty()) {
+        if (subset_map.key_begin(Sid) == subset_map.key_end(Sid)) {
             break;//this should not happen assuming all sets targets are non empty
         }
 
-        // add moves of S to the sync ex iterator
-        // TODO: shouldn't we also reset first?
-        for (State q: S) {
-            Mata::Util::push_back(synchronized_iterator, aut.delta[q]);
-        }
-
-        while (synchronized_iterator.advance()) {
-
-            // extract post from the sychronized_iterator iterator
-            std::vector<Iterator> moves = synchronized_iterator.get_current();
-            Symbol currentSymbol = (*moves.begin())->symbol;
-            StateSet T;
-            for (auto m: moves){
-                T = T.Union(m->targets);
-            }
-
-            const auto existingTitr = subset_map->find(T);
-            State Tid;
-            if (existingTitr != subset_map->end()) {
-                Tid = existingTitr->second;
-            } else {
-                Tid = result.add_state();
-                (*subset_map)[Mata::Util::OrdVector<State>(T)] = Tid;
-                if (!are_disjoint(T, aut.final)) {
+        // sweep over images of S under all symbols
+        post_image.start(aut.delta, subset_map.key_begin(Sid), subset_map.key_end(Sid));
+        while (post_image.next()) {
+            const Symbol currentSymbol = post_image.symbol();
+            const State* const T_begin = post_image.begin();
+            const State* const T_end = post_image.end();
+
+            // Macrostates are numbered as the states of the result.
+            const auto [Tid, inserted] = subset_map.emplace(T_begin, T_end, result.delta.post_size());
+            if (inserted) {
+                result.add_state();
+                if (std::any_of(T_begin, T_end, [&aut](State q) { return aut.final[q]; })) {
                     result.final.add(Tid);
                 }
-                worklist.emplace_back(std::make_pair(Tid, T));
+                worklist.push_back(Tid);
             }
             result.delta[Sid].insert(Move(currentSymbol, Tid));
         }
     }
 
-    if (deallocate_subset_map) { delete subset_map; }
+    return result;
+}
 
+Algorithms::SymbolClasses Mata::Nfa::Algorithms::compute_symbol_classes(const Nfa& aut) {
+    SymbolClasses result{};
+    std::vector<Symbol>& symbols{ result.symbols };
+    for (State state{ 0 }; state < aut.delta.post_size(); ++state) {
+        for (const Move& move: aut.delta[state]) { symbols.push_back(move.symbol); }
+    }
+    std::sort(symbols.begin(), symbols.end());
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+
+    // List 's' of moves over the symbol symbols[s] is stored in moves[list_begins[s], list_begins[s + 1]).
+    std::vector<size_t> list_begins(symbols.size() + 1, 0);
+    const auto for_each_move = [&](State state, const auto& visit) {
+        const Symbol* symbol{ symbols.data() };
+        const Symbol* const symbols_end{ symbols.data() + symbols.size() };
+        for (const Move& move: aut.delta[state]) {
+            symbol = std::lower_bound(symbol, symbols_end, move.symbol);
+            if (!move.targets.empty()) { visit(static_cast<size_t>(symbol - symbols.data()), move); }
+        }
+    };
+    for (State state{ 0 }; state < aut.delta.post_size(); ++state) {
+        for_each_move(state, [&](size_t index, const Move&) { ++list_begins[index + 1]; });
+    }
+    for (size_t i{ 0 }; i < symbols.size(); ++i) { list_begins[i + 1] += list_begins[i]; }
+    std::vector<std::pair<State, const TargetSet*>> moves(list_begins.back());
+    std::vector<size_t> list_ends(list_begins.begin(), list_begins.end() - 1);
+    for (State state{ 0 }; state < aut.delta.post_size(); ++state) {
+        for_each_move(state, [&](size_t index, const Move& move) {
+            moves[list_ends[index]++] = { state, &move.targets };
+        });
+    }
+
+    const auto list_less = [&](size_t lhs, size_t rhs) {
+        return std::lexicographical_compare(
+            moves.begin() + list_begins[lhs], moves.begin() + list_begins[lhs + 1],
+            moves.begin() + list_begins[rhs], moves.begin() + list_begins[rhs + 1],
+            [](const auto& lhs_move, const auto& rhs_move) {
+                if (lhs_move.first != rhs_move.first) { return lhs_move.first < rhs_move.first; }
+                return *lhs_move.second < *rhs_move.second;
+            });
+    };
+    std::vector<size_t> order(symbols.size());
+    for (size_t i{ 0 }; i < order.size(); ++i) { order[i] = i; }
+    std::stable_sort(order.begin(), order.end(), list_less);
+    std::vector<size_t> first_of_group(symbols.size());
+    for (size_t i{ 0 }; i < order.size(); ++i) {
+        const bool starts_group{ i == 0 || list_less(order[i - 1], order[i]) };
+        first_of_group[order[i]] = starts_group ? order[i] : first_of_group[order[i - 1]];
+    }
+    result.symbol_classes.resize(symbols.size());
+    result.is_first_of_class.resize(symbols.size());
+    for (size_t i{ 0 }; i < symbols.size(); ++i) {
+        result.is_first_of_class[i] = first_of_group[i] == i;
+        result.symbol_classes[i] = result.is_first_of_class[i] ? static_cast<uint32_t>(result.num_of_classes++)
+                                                               : result.symbol_classes[first_of_group[i]];
+    }
     return result;
 }
 
@@ -1342,6 +1593,8 @@ Nfa Mata::Nfa::construct(
         }
     }
 
+    TransSequence transitions{};
+    transitions.reserve(parsec.body.size());
     for (const auto& body_line : parsec.body)
     {
         if (body_line.size() != 3)
@@ -1365,8 +1618,9 @@ Nfa Mata::Nfa::construct(
         Symbol symbol = alphabet->translate_symb(body_line[1]);
         State tgt_state = get_state_name(body_line[2]);
 
-        aut.delta.add(src_state, symbol, tgt_state);
+        transitions.emplace_back(src_state, symbol, tgt_state);
     }
+    aut.delta.add_bulk(std::move(transitions));
 
     // do the dishes and take out garbage
     clean_up();
@@ -1423,6 +1677,8 @@ Nfa Mata::Nfa::construct(
         aut.final.add(state);
     }
 
+    TransSequence transitions{};
+    transitions.reserve(inter_aut.transitions.size());
     for (const auto& trans : inter_aut.transitions)
     {
         if (trans.second.children.size() != 2)
@@ -1444,8 +1700,9 @@ Nfa Mata::Nfa::construct(
         Symbol symbol = alphabet->translate_symb(trans.second.children[0].node.name);
         State tgt_state = get_state_name(trans.second.children[1].node.name);
 
-        aut.delta.add(src_state, symbol, tgt_state);
+        transitions.emplace_back(src_state, symbol, tgt_state);
     }
+    aut.delta.add_bulk(std::move(transitions));
 
     // do the dishes and take out garbage
     clean_up();
@@ -1453,6 +1710,20 @@ Nfa Mata::Nfa::construct(
     return aut;
 } // construct }}}
 
+Nfa Nfa::from_transitions(TransSequence transitions, const StateSet& initial_states, const StateSet& final_states)
+{
+    size_t num_of_states{ 0 };
+    for (const Trans& transition: transitions) {
+        num_of_states = std::max<size_t>(num_of_states, std::max(transition.src, transition.tgt) + 1);
+    }
+    if (!initial_states.empty()) { num_of_states = std::max<size_t>(num_of_states, initial_states.back() + 1); }
+    if (!final_states.empty()) { num_of_states = std::max<size_t>(num_of_states, final_states.back() + 1); }
+
+    Nfa result{ num_of_states, initial_states, final_states };
+    result.delta.add_bulk(std::move(transitions));
+    return result;
+}
+
 Nfa::const_iterator Nfa::const_iterator::for_begin(const Nfa* nfa)
 { // {{{
     assert(nullptr != nfa);
@@ -1488,7 +1759,7 @@ Nfa::const_iterator& Nfa::const_iterator::operator++()
     assert(nullptr != nfa);
 
     ++(this->ssIt);
-    const StateSet& state_set = this->tlIt->targets;
+    const TargetSet& state_set = this->tlIt->targets;
     assert(!state_set.empty());
     if (this->ssIt != state_set.end())
     {
@@ -1522,7 +1793,7 @@ Nfa::const_iterator& Nfa::const_iterator::operator++()
     {
         this->tlIt = this->nfa->get_moves_from(this->trIt).begin();
         assert(!this->nfa->get_moves_from(this->trIt).empty());
-        const StateSet& new_state_set = this->tlIt->targets;
+        const TargetSet& new_state_set = this->tlIt->targets;
         assert(!new_state_set.empty());
         this->ssIt = new_state_set.begin();
 
@@ -1577,12 +1848,16 @@ Mata::Util::OrdVector<Symbol> Nfa::get_used_symbols() const {
 void Nfa::unify_final() {
     if (final.empty() || final.size() == 1) { return; }
     const State new_final_state{add_state() };
+    // Collect the transitions first, adding a transition drops the predecessor index.
+    TransSequence transitions_to_final{};
     for (const auto& orig_final_state: final) {
-        for (const auto& transitions: get_transitions_to(orig_final_state)) {
-            delta.add(transitions.src, transitions.symb, new_final_state);
-        }
+        const TransSequence transitions_to_state{ get_transitions_to(orig_final_state) };
+        transitions_to_final.insert(transitions_to_final.end(), transitions_to_state.begin(), transitions_to_state.end());
         if (initial[orig_final_state]) { initial.add(new_final_state); }
     }
+    for (const Trans& transition: transitions_to_final) {
+        delta.add(transition.src, transition.symb, new_final_state);
+    }
     final.clear();
     final.add(new_final_state);
 }
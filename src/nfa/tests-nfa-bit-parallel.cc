@@ -0,0 +1,153 @@
+/* tests-nfa-bit-parallel.cc -- Tests for the bit-parallel simulation of small NFAs
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <random>
+
+#include "../3rdparty/catch.hpp"
+
+#include <mata/nfa.hh>
+#include <mata/nfa-bit-parallel.hh>
+
+#include "../tests-utils.hh"
+
+using namespace Mata::Nfa;
+using Mata::Tests::random_aut;
+using Mata::Tests::random_word;
+
+namespace {
+    /// Automaton of words containing @p pattern, entering every state over a single symbol but the initial state.
+    Nfa containing(const std::string& pattern) {
+        Nfa aut{ pattern.size() + 1 };
+        aut.initial = { 0 };
+        aut.final = { static_cast<State>(pattern.size()) };
+        for (Symbol symbol{ 0 }; symbol < 256; ++symbol) { aut.delta.add(0, symbol, 0); }
+        for (State state{ 0 }; state < pattern.size(); ++state) {
+            aut.delta.add(state, static_cast<unsigned char>(pattern[state]), state + 1);
+        }
+        return aut;
+    }
+} // namespace.
+
+TEST_CASE("Mata::Nfa::BitParallelMatcher")
+{
+    SECTION("Shift-And simulation")
+    {
+        Nfa aut{ 4 };
+        aut.initial = { 0 };
+        aut.final = { 3 };
+        aut.delta.add(0, 'a', 1);
+        aut.delta.add(1, 'b', 2);
+        aut.delta.add(2, 'b', 2);
+        aut.delta.add(2, 'c', 3);
+        const BitParallelMatcher matcher{ aut };
+        CHECK(matcher.is_shift_and());
+        CHECK(matcher.num_of_states() == 4);
+        CHECK(matcher.num_of_symbol_classes() == 4);
+
+        CHECK(matcher.is_in_lang("abc"));
+        CHECK(matcher.is_in_lang("abbbc"));
+        CHECK(!matcher.is_in_lang("abcx"));
+        CHECK(!matcher.is_in_lang("ac"));
+        CHECK(!matcher.is_in_lang(""));
+        CHECK(matcher.is_prfx_in_lang("abcx"));
+        CHECK(!matcher.is_prfx_in_lang("abx"));
+        CHECK(matcher.is_in_lang(Run{ { 'a', 'b', 'c' }, {} }));
+        CHECK(matcher.is_prfx_in_lang(Run{ { 'a', 'b', 'c', 'z' }, {} }));
+
+        const BitParallelMatcher searcher{ containing("needle") };
+        CHECK(searcher.is_shift_and());
+        CHECK(searcher.is_prfx_in_lang("a haystack with a needle in it"));
+        CHECK(!searcher.is_prfx_in_lang("a haystack with a needl"));
+        CHECK(searcher.is_in_lang("needle"));
+    }
+
+    SECTION("General simulation")
+    {
+        // The state 1 is entered over both 'a' and 'b', but 'b' does not lead from 0 to 1.
+        Nfa aut{ 3 };
+        aut.initial = { 0 };
+        aut.final = { 1 };
+        aut.delta.add(0, 'a', 1);
+        aut.delta.add(0, 'b', 2);
+        aut.delta.add(2, 'b', 1);
+        const BitParallelMatcher matcher{ aut };
+        CHECK(!matcher.is_shift_and());
+        CHECK(matcher.is_in_lang("a"));
+        CHECK(matcher.is_in_lang("bb"));
+        CHECK(!matcher.is_in_lang("b"));
+        CHECK(matcher.is_prfx_in_lang("bba"));
+    }
+
+    SECTION("Byte maps and large symbols")
+    {
+        Nfa aut{ 2 };
+        aut.initial = { 0 };
+        aut.final = { 1 };
+        aut.delta.add(0, 1000000, 1);
+        ByteMap byte_map{ identity_byte_map() };
+        byte_map['x'] = 1000000;
+        const BitParallelMatcher matcher{ aut, byte_map };
+        CHECK(matcher.is_in_lang("x"));
+        CHECK(!matcher.is_in_lang("y"));
+        CHECK(matcher.is_in_lang(Run{ { 1000000 }, {} }));
+        CHECK(!matcher.is_in_lang(Run{ { 1000001 }, {} }));
+    }
+
+    SECTION("Too many states")
+    {
+        CHECK_NOTHROW(BitParallelMatcher{ Nfa{ BitParallelMatcher::MAX_STATES } });
+        CHECK_THROWS_AS(BitParallelMatcher{ Nfa{ BitParallelMatcher::MAX_STATES + 1 } }, std::length_error);
+    }
+
+    SECTION("Random automata")
+    {
+        std::mt19937 generator{ 42 };
+        const std::vector<Symbol> symbols{ 0, 1, 2, 100000 };
+        // Words also contain the symbol 7, which is not in any automaton.
+        const std::vector<Symbol> word_symbols{ 0, 1, 2, 100000, 7 };
+        for (const State num_of_states: { 1, 5, 20, 64, 65, 130, 500 }) {
+            for (size_t round{ 0 }; round < 5; ++round) {
+                const Nfa aut{ random_aut(generator, num_of_states, symbols, 2, 2, 2) };
+                const BitParallelMatcher matcher{ aut };
+                for (size_t i{ 0 }; i < 50; ++i) {
+                    const Run word{ random_word(generator, word_symbols, 9) };
+                    CHECK(matcher.is_in_lang(word) == is_in_lang(aut, word));
+                    CHECK(matcher.is_prfx_in_lang(word) == is_prfx_in_lang(aut, word));
+                }
+            }
+        }
+
+        // Automata of patterns over a small alphabet, simulated as in Shift-And.
+        for (size_t round{ 0 }; round < 20; ++round) {
+            std::string pattern{};
+            for (size_t length{ 1 + generator() % 40 }; length > 0; --length) {
+                pattern.push_back(static_cast<char>('a' + generator() % 3));
+            }
+            const Nfa aut{ containing(pattern) };
+            const BitParallelMatcher matcher{ aut };
+            CHECK(matcher.is_shift_and());
+            for (size_t i{ 0 }; i < 50; ++i) {
+                std::string text{};
+                for (size_t length{ generator() % 100 }; length > 0; --length) {
+                    text.push_back(static_cast<char>('a' + generator() % 3));
+                }
+                CHECK(matcher.is_prfx_in_lang(text) == (text.find(pattern) != std::string::npos));
+                CHECK(matcher.is_in_lang(text) == is_in_lang(aut, Run{ { text.begin(), text.end() }, {} }));
+            }
+        }
+    }
+}
@@ -0,0 +1,291 @@
+/* tests-nfa-frozen.cc -- Tests for frozen (CSR) NFAs
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <random>
+
+#include "../3rdparty/catch.hpp"
+
+#include <mata/nfa.hh>
+#include <mata/nfa-frozen.hh>
+
+using namespace Mata::Nfa;
+using namespace Mata::Util;
+
+// Some common automata {{{
+
+// Automaton A
+#define FILL_WITH_AUT_A(x) \
+    x.initial = {1, 3}; \
+    x.final = {5}; \
+    x.delta.add(1, 'a', 3); \
+    x.delta.add(1, 'a', 10); \
+    x.delta.add(1, 'b', 7); \
+    x.delta.add(3, 'a', 7); \
+    x.delta.add(3, 'b', 9); \
+    x.delta.add(9, 'a', 9); \
+    x.delta.add(7, 'b', 1); \
+    x.delta.add(7, 'a', 3); \
+    x.delta.add(7, 'c', 3); \
+    x.delta.add(10, 'a', 7); \
+    x.delta.add(10, 'b', 7); \
+    x.delta.add(10, 'c', 7); \
+    x.delta.add(7, 'a', 5); \
+    x.delta.add(5, 'a', 5); \
+    x.delta.add(5, 'c', 9); \
+
+
+// Automaton B
+#define FILL_WITH_AUT_B(x) \
+    x.initial = {4}; \
+    x.final = {2, 12}; \
+    x.delta.add(4, 'c', 8); \
+    x.delta.add(4, 'a', 8); \
+    x.delta.add(8, 'b', 4); \
+    x.delta.add(4, 'a', 6); \
+    x.delta.add(4, 'b', 6); \
+    x.delta.add(6, 'a', 2); \
+    x.delta.add(2, 'b', 2); \
+    x.delta.add(2, 'a', 0); \
+    x.delta.add(0, 'a', 2); \
+    x.delta.add(2, 'c', 12); \
+    x.delta.add(12, 'a', 14); \
+    x.delta.add(14, 'b', 12); \
+
+// }}}
+
+TEST_CASE("Mata::Nfa::FrozenDelta")
+{
+    Nfa aut{ 15 };
+    FILL_WITH_AUT_A(aut);
+    const FrozenNfa frozen{ aut };
+
+    CHECK(frozen.num_of_states() == 15);
+    CHECK(frozen.get_num_of_trans() == aut.get_num_of_trans());
+
+    for (State state{ 0 }; state < aut.delta.post_size(); ++state) {
+        const Post& post{ aut.delta[state] };
+        CHECK(frozen.delta.moves_end(state) - frozen.delta.moves_begin(state) == post.size());
+        size_t move{ frozen.delta.moves_begin(state) };
+        for (const Move& orig_move: post) {
+            CHECK(frozen.delta.symbol(move) == orig_move.symbol);
+            const StateRange targets{ frozen.delta.targets_of(move) };
+            CHECK(StateSet(std::vector<State>(targets.begin(), targets.end())) == orig_move.targets);
+            ++move;
+        }
+    }
+
+    CHECK(frozen.delta.find_move(7, 'b') != FrozenDelta::npos);
+    CHECK(frozen.delta.find_move(7, 'd') == FrozenDelta::npos);
+    CHECK(frozen.delta.post(1, 'a').size() == 2);
+    CHECK(frozen.delta.post(2, 'a').empty());
+    CHECK(frozen.delta.post(100, 'a').empty());
+    CHECK(frozen.post(StateSet{ 1, 7 }, 'a') == StateSet{ 3, 5, 10 });
+
+    SECTION("Targets beyond the size of the original transition relation")
+    {
+        Nfa sparse{};
+        sparse.delta.add(0, 'a', 42);
+        const FrozenNfa frozen_sparse{ sparse };
+        CHECK(frozen_sparse.num_of_states() >= 43);
+        CHECK(frozen_sparse.delta.post(42, 'a').empty());
+    }
+
+    SECTION("Moves without targets")
+    {
+        Nfa with_empty_move{ 2 };
+        with_empty_move.delta.add(0, 'a', 1);
+        with_empty_move.delta[1].insert(Move{ 'b' });
+        const FrozenNfa frozen_with_empty_move{ with_empty_move };
+        CHECK(frozen_with_empty_move.num_of_states() == 2);
+        CHECK(frozen_with_empty_move.delta.find_move(1, 'b') != FrozenDelta::npos);
+        CHECK(frozen_with_empty_move.delta.post(1, 'b').empty());
+        CHECK(frozen_with_empty_move.get_num_of_trans() == 1);
+    }
+}
+
+TEST_CASE("Mata::Nfa::is_lang_empty() for frozen NFAs")
+{
+    Nfa aut{ 14 };
+    Run cex;
+
+    SECTION("An empty automaton has an empty language")
+    {
+        CHECK(is_lang_empty(FrozenNfa{ aut }));
+    }
+
+    SECTION("An automaton with a state that is both initial and final has a non-empty language")
+    {
+        aut.initial = {1, 2};
+        aut.final = {2, 3};
+        CHECK(!is_lang_empty(FrozenNfa{ aut }, &cex));
+        CHECK(cex.path == std::vector<State>{ 2 });
+        CHECK(cex.word.empty());
+    }
+
+    SECTION("Counterexample of an automaton with non-empty language")
+    {
+        aut.initial = {1, 2};
+        aut.final = {8, 9};
+        aut.delta.add(1, 'c', 2);
+        aut.delta.add(2, 'a', 4);
+        aut.delta.add(2, 'c', 1);
+        aut.delta.add(2, 'c', 3);
+        aut.delta.add(3, 'e', 5);
+        aut.delta.add(4, 'c', 8);
+
+        CHECK(!is_lang_empty(FrozenNfa{ aut }, &cex));
+        CHECK(cex.path == std::vector<State>{ 2, 4, 8 });
+        CHECK(cex.word == std::vector<Symbol>{ 'a', 'c' });
+        CHECK(is_in_lang(aut, Run{ cex.word, {} }));
+    }
+
+    SECTION("Unreachable final states")
+    {
+        FILL_WITH_AUT_B(aut);
+        aut.final = {14};
+        aut.initial = {2};
+        CHECK(!is_lang_empty(FrozenNfa{ aut }, &cex));
+        CHECK(is_in_lang(aut, Run{ cex.word, {} }));
+
+        aut.initial = {6};
+        aut.final = {4};
+        CHECK(is_lang_empty(FrozenNfa{ aut }));
+        CHECK(is_lang_empty(aut));
+    }
+}
+
+TEST_CASE("Mata::Nfa::intersection() for frozen NFAs")
+{
+    Nfa a{ 15 };
+    Nfa b{ 15 };
+    FILL_WITH_AUT_A(a);
+    FILL_WITH_AUT_B(b);
+
+    std::unordered_map<std::pair<State, State>, State> prod_map;
+    std::unordered_map<std::pair<State, State>, State> frozen_prod_map;
+    const Nfa expected{ intersection(a, b, false, &prod_map) };
+    const Nfa result{ intersection(FrozenNfa{ a }, FrozenNfa{ b }, &frozen_prod_map) };
+
+    CHECK(result.get_num_of_trans() == expected.get_num_of_trans());
+    CHECK(prod_map.size() == frozen_prod_map.size());
+    CHECK(are_equivalent(result, expected));
+    for (const auto& [pair, state]: frozen_prod_map) {
+        CHECK(prod_map.count(pair) == 1);
+        CHECK(result.final[state] == (a.final[pair.first] && b.final[pair.second]));
+    }
+
+    SECTION("Intersection with an automaton without initial states")
+    {
+        Nfa empty{ 3 };
+        empty.delta.add(0, 'a', 1);
+        CHECK(is_lang_empty(intersection(FrozenNfa{ a }, FrozenNfa{ empty })));
+    }
+}
+
+TEST_CASE("Mata::Nfa::determinize() for frozen NFAs")
+{
+    Nfa aut{ 15 };
+    FILL_WITH_AUT_A(aut);
+
+    std::unordered_map<StateSet, State> subset_map;
+    std::unordered_map<StateSet, State> frozen_subset_map;
+    const Nfa expected{ determinize(aut, &subset_map) };
+    const Nfa result{ determinize(FrozenNfa{ aut }, &frozen_subset_map) };
+
+    CHECK(result.delta.post_size() == expected.delta.post_size());
+    CHECK(result.get_num_of_trans() == expected.get_num_of_trans());
+    CHECK(subset_map == frozen_subset_map);
+    CHECK(is_deterministic(result));
+    CHECK(are_equivalent(result, aut));
+}
+
+TEST_CASE("Mata::Nfa::is_included() for frozen NFAs")
+{
+    Run cex;
+
+    SECTION("Automaton included in its union with another automaton")
+    {
+        Nfa a{ 15 };
+        Nfa b{ 15 };
+        FILL_WITH_AUT_A(a);
+        FILL_WITH_AUT_B(b);
+        const Nfa united{ uni(a, b) };
+
+        CHECK(is_included(FrozenNfa{ a }, FrozenNfa{ united }));
+        CHECK(is_included(FrozenNfa{ b }, FrozenNfa{ united }));
+        CHECK(!is_included(FrozenNfa{ united }, FrozenNfa{ a }, &cex));
+        CHECK(is_in_lang(united, cex));
+        CHECK(!is_in_lang(a, cex));
+        CHECK(is_included(a, united) == is_included(FrozenNfa{ a }, FrozenNfa{ united }));
+    }
+
+    SECTION("{epsilon} <= {epsilon} and {epsilon} !<= {}")
+    {
+        Nfa smaller{ 2 };
+        Nfa bigger{ 2 };
+        smaller.initial = {1};
+        smaller.final = {1};
+        bigger.initial = {0};
+        bigger.final = {0};
+        CHECK(is_included(FrozenNfa{ smaller }, FrozenNfa{ bigger }));
+
+        bigger.final = {};
+        CHECK(!is_included(FrozenNfa{ smaller }, FrozenNfa{ bigger }, &cex));
+        CHECK(cex.word.empty());
+    }
+
+    SECTION("Non-inclusion found deeper in the automata")
+    {
+        Nfa smaller{ 3 };
+        Nfa bigger{ 3 };
+        smaller.initial = {0};
+        smaller.final = {2};
+        smaller.delta.add(0, 'a', 1);
+        smaller.delta.add(1, 'b', 2);
+        smaller.delta.add(1, 'a', 1);
+        bigger.initial = {0};
+        bigger.final = {2};
+        bigger.delta.add(0, 'a', 1);
+        bigger.delta.add(1, 'b', 2);
+
+        CHECK(!is_included(FrozenNfa{ smaller }, FrozenNfa{ bigger }, &cex));
+        CHECK(is_in_lang(smaller, cex));
+        CHECK(!is_in_lang(bigger, cex));
+        CHECK(is_included(FrozenNfa{ bigger }, FrozenNfa{ smaller }));
+    }
+}
+
+TEST_CASE("Mata::Nfa::FrozenNfa for profiling", "[.profiling],[frozen]")
+{
+    const size_t num_of_states{ 200000 };
+    const size_t num_of_trans{ 1000000 };
+    std::mt19937 gen{ 42 };
+    std::uniform_int_distribution<State> state_dist{ 0, num_of_states - 1 };
+    std::uniform_int_distribution<Symbol> symbol_dist{ 0, 15 };
+
+    Nfa aut{ num_of_states };
+    aut.initial.add(0);
+    aut.final.add(num_of_states - 1);
+    for (size_t i{ 0 }; i < num_of_trans; ++i) {
+        aut.delta.add(state_dist(gen), symbol_dist(gen), state_dist(gen));
+    }
+
+    const FrozenNfa frozen{ aut };
+    for (size_t i{ 0 }; i < 10; ++i) {
+        CHECK(!is_lang_empty(frozen));
+    }
+}
@@ -16,15 +16,19 @@
  */
 
 
+#include <random>
 #include <unordered_set>
 
 #include "../3rdparty/catch.hpp"
 
 #include <mata/nfa.hh>
 
+#include "../tests-utils.hh"
+
 using namespace Mata::Nfa;
 using namespace Mata::util;
 using namespace Mata::Parser;
+using Mata::Tests::random_aut;
 
 // Some common automata {{{
 
@@ -318,3 +322,213 @@ TEST_CASE("Mata::Nfa::intersection() for profiling", "[.profiling],[intersection
         Nfa result{intersection(a, b, true) };
     }
 }
+
+TEST_CASE("Mata::Nfa::is_intersection_empty()")
+{
+    Nfa a{15};
+    Nfa b{15};
+    Run cex;
+
+    SECTION("No automata")
+    {
+        CHECK(!is_intersection_empty({}, &cex));
+        CHECK(cex.word.empty());
+    }
+
+    SECTION("Automata A and B")
+    {
+        FILL_WITH_AUT_A(a);
+        FILL_WITH_AUT_B(b);
+
+        CHECK(!is_intersection_empty({ a, b }, &cex));
+        CHECK(is_in_lang(a, cex));
+        CHECK(is_in_lang(b, cex));
+        Run shortest;
+        REQUIRE(!is_lang_empty(intersection(a, b), &shortest));
+        CHECK(cex.word.size() == shortest.word.size());
+        CHECK(!is_intersection_empty({ a }, &cex));
+        CHECK(is_in_lang(a, cex));
+    }
+
+    SECTION("Initial product state is final")
+    {
+        a.initial = { 0 };
+        a.final = { 0 };
+        b.initial = { 1, 2 };
+        b.final = { 2 };
+        CHECK(!is_intersection_empty({ a, b }, &cex));
+        CHECK(cex.word.empty());
+    }
+
+    SECTION("Three automata with an empty intersection")
+    {
+        // a+, b+ and (a|b)+ share no word.
+        a.initial = { 0 };
+        a.final = { 1 };
+        a.delta.add(0, 'a', 1);
+        a.delta.add(1, 'a', 1);
+        b.initial = { 0 };
+        b.final = { 1 };
+        b.delta.add(0, 'b', 1);
+        b.delta.add(1, 'b', 1);
+        Nfa c{2};
+        c.initial = { 0 };
+        c.final = { 1 };
+        c.delta.add(0, 'a', 1);
+        c.delta.add(0, 'b', 1);
+        c.delta.add(1, 'a', 1);
+        c.delta.add(1, 'b', 1);
+
+        CHECK(is_intersection_empty({ a, b, c }, &cex));
+        CHECK(!is_intersection_empty({ a, c }, &cex));
+        CHECK(cex.word == std::vector<Symbol>{ 'a' });
+        CHECK(!is_intersection_empty({ c, b, c }, &cex));
+        CHECK(cex.word == std::vector<Symbol>{ 'b' });
+    }
+
+    SECTION("Random automata agree with the constructed intersection")
+    {
+        for (unsigned seed{ 0 }; seed < 100; ++seed) {
+            std::mt19937 generator{ seed };
+            const Nfa first{ random_aut(generator, 6, { 0, 1 }, 1) };
+            const Nfa second{ random_aut(generator, 6, { 0, 1 }, 1) };
+            const Nfa third{ random_aut(generator, 6, { 0, 1 }, 1) };
+            const bool expected{ is_lang_empty(intersection(intersection(first, second), third)) };
+            CHECK(is_intersection_empty({ first, second, third }, &cex) == expected);
+            if (!expected) {
+                CHECK(is_in_lang(first, cex));
+                CHECK(is_in_lang(second, cex));
+                CHECK(is_in_lang(third, cex));
+            }
+        }
+    }
+}
+
+TEST_CASE("Mata::Nfa::is_intersection_empty() for profiling", "[.profiling],[intersection]")
+{
+    // Products of cycles of coprime lengths have all combinations of states reachable.
+    Nfa a{ 211 };
+    Nfa b{ 223 };
+    for (Nfa* aut: { &a, &b }) {
+        const size_t num_of_states{ aut->delta.post_size() };
+        aut->initial.add(0);
+        aut->final.add(num_of_states - 1);
+        for (State state{ 0 }; state < num_of_states; ++state) {
+            aut->delta.add(state, 'a', (state + 1) % num_of_states);
+            aut->delta.add(state, 'b', (state + 1) % num_of_states);
+            aut->delta.add(state, 'b', state);
+        }
+    }
+
+    Run cex;
+    for (size_t i{ 0 }; i < 10; ++i) {
+        CHECK(!is_intersection_empty({ a, b }, &cex));
+    }
+    CHECK(cex.word.size() == 222);
+}
+
+TEST_CASE("Mata::Nfa::intersection() of a sequence of automata")
+{
+    Nfa a{15};
+    Nfa b{15};
+    FILL_WITH_AUT_A(a);
+    FILL_WITH_AUT_B(b);
+
+    // Check that the n-ary product of two automata is the binary product up to renaming of states.
+    const auto check_same_as_binary = [](const Nfa& lhs, const Nfa& rhs, bool preserve_epsilon) {
+        std::unordered_map<std::pair<State, State>, State> binary_map;
+        const Nfa binary{ intersection(lhs, rhs, preserve_epsilon, &binary_map) };
+        std::unordered_map<std::vector<State>, State> nary_map;
+        const Nfa nary{ intersection({ lhs, rhs }, preserve_epsilon, &nary_map) };
+
+        REQUIRE(nary_map.size() == binary_map.size());
+        CHECK(nary.delta.post_size() == binary.delta.post_size());
+        CHECK(nary.get_num_of_trans() == binary.get_num_of_trans());
+        std::vector<State> renaming(binary.delta.post_size());
+        for (const auto& [pair, state]: binary_map) {
+            REQUIRE(nary_map.count({ pair.first, pair.second }) == 1);
+            renaming[state] = nary_map.at({ pair.first, pair.second });
+            CHECK(binary.initial[state] == nary.initial[renaming[state]]);
+            CHECK(binary.final[state] == nary.final[renaming[state]]);
+        }
+        for (State state{ 0 }; state < binary.delta.post_size(); ++state) {
+            for (const Move& move: binary.delta[state]) {
+                for (const State target: move.targets) {
+                    CHECK(nary.delta.contains(renaming[state], move.symbol, renaming[target]));
+                }
+            }
+        }
+    };
+
+    SECTION("Two automata")
+    {
+        check_same_as_binary(a, b, false);
+        check_same_as_binary(b, a, false);
+    }
+
+    SECTION("Two automata with epsilon transitions")
+    {
+        a.delta.add(1, EPSILON, 9);
+        a.delta.add(9, EPSILON, 5);
+        b.delta.add(4, EPSILON, 2);
+        b.delta.add(8, EPSILON, 12);
+        b.delta.add(2, EPSILON, 14);
+        check_same_as_binary(a, b, true);
+        check_same_as_binary(a, b, false);
+    }
+
+    SECTION("Three automata")
+    {
+        Nfa c{3};
+        c.initial = { 0 };
+        c.final = { 2 };
+        c.delta.add(0, 'a', 1);
+        c.delta.add(1, 'a', 1);
+        c.delta.add(1, 'b', 2);
+        c.delta.add(2, 'a', 2);
+        c.delta.add(2, 'b', 2);
+
+        std::unordered_map<std::vector<State>, State> prod_map;
+        const Nfa result{ intersection({ a, b, c }, false, &prod_map) };
+        const Nfa expected{ intersection(intersection(a, b), c) };
+        CHECK(result.delta.post_size() == prod_map.size());
+        CHECK(result.initial.size() == 2);
+        CHECK(are_equivalent(result, expected));
+        for (const auto& [tuple, state]: prod_map) {
+            CHECK(result.final[state] == (a.final[tuple[0]] && b.final[tuple[1]] && c.final[tuple[2]]));
+        }
+    }
+
+    SECTION("Single automaton")
+    {
+        const Nfa result{ intersection({ a }) };
+        CHECK(are_equivalent(result, a));
+    }
+
+    SECTION("No automata")
+    {
+        CHECK_THROWS(intersection(ConstAutRefSequence{}));
+    }
+}
+
+TEST_CASE("Mata::Nfa::intersection() of a sequence of automata for profiling", "[.profiling],[intersection]")
+{
+    // Cycles of coprime lengths, each over 'a' with a self-loop over 'b'.
+    AutSequence automata{};
+    for (const size_t num_of_states: { 5, 7, 11, 13 }) {
+        Nfa aut{ num_of_states };
+        aut.initial.add(0);
+        aut.final.add(num_of_states - 1);
+        for (State state{ 0 }; state < num_of_states; ++state) {
+            aut.delta.add(state, 'a', (state + 1) % num_of_states);
+            aut.delta.add(state, 'b', (state + 1) % num_of_states);
+            aut.delta.add(state, 'b', state);
+        }
+        automata.push_back(aut);
+    }
+
+    for (size_t i{ 0 }; i < 10; ++i) {
+        const Nfa result{ intersection({ automata[0], automata[1], automata[2], automata[3] }) };
+        CHECK(result.delta.post_size() == 5 * 7 * 11 * 13);
+    }
+}
@@ -0,0 +1,156 @@
+/* tests-nfa-lazy-dfa-matcher.cc -- Tests for matching byte strings with a lazily built DFA cache
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <random>
+
+#include "../3rdparty/catch.hpp"
+
+#include <mata/nfa.hh>
+#include <mata/nfa-lazy-dfa-matcher.hh>
+
+#include "../tests-utils.hh"
+
+using namespace Mata::Nfa;
+using Mata::Tests::random_aut;
+
+namespace {
+    /// Random text over 'a', 'b', 'c' and 'd', which has no transitions in random automata.
+    std::string random_text(std::mt19937& generator, const size_t max_length) {
+        std::string text{};
+        for (size_t length{ generator() % (max_length + 1) }; length > 0; --length) {
+            text.push_back(static_cast<char>(generator() % 20 == 0 ? 'd' : 'a' + generator() % 3));
+        }
+        return text;
+    }
+
+    Run to_run(const std::string_view text) { return Run{ { text.begin(), text.end() }, {} }; }
+
+    size_t longest_match(const Nfa& aut, const std::string_view text) {
+        for (size_t length{ text.size() + 1 }; length > 0; --length) {
+            if (is_in_lang(aut, to_run(text.substr(0, length - 1)))) { return length - 1; }
+        }
+        return LazyDfaMatcher::NO_MATCH;
+    }
+
+    /// Automaton of words whose n-th symbol from the end is 'a', with a DFA of 2^(n+1) states.
+    Nfa nth_from_end(const State n) {
+        Nfa aut{ n + 1 };
+        aut.initial = { 0 };
+        aut.final = { n };
+        aut.delta.add(0, 'a', 0);
+        aut.delta.add(0, 'b', 0);
+        aut.delta.add(0, 'a', 1);
+        for (State state{ 1 }; state < n; ++state) {
+            aut.delta.add(state, 'a', state + 1);
+            aut.delta.add(state, 'b', state + 1);
+        }
+        return aut;
+    }
+} // namespace.
+
+TEST_CASE("Mata::Nfa::LazyDfaMatcher")
+{
+    SECTION("Full, prefix and longest matches")
+    {
+        // Accepts a(b)*, the prefix "a" and all longer ones.
+        Nfa aut{ 2 };
+        aut.initial = { 0 };
+        aut.final = { 1 };
+        aut.delta.add(0, 'a', 1);
+        aut.delta.add(1, 'b', 1);
+        LazyDfaMatcher matcher{ aut };
+
+        CHECK(matcher.is_in_lang("abb"));
+        CHECK(!matcher.is_in_lang("abbc"));
+        CHECK(!matcher.is_in_lang(""));
+        CHECK(matcher.is_prfx_in_lang("abbc"));
+        CHECK(!matcher.is_prfx_in_lang("ba"));
+        CHECK(matcher.longest_match("abbcb") == 3);
+        CHECK(matcher.longest_match("a") == 1);
+        CHECK(matcher.longest_match("ba") == LazyDfaMatcher::NO_MATCH);
+        CHECK(matcher.num_of_flushes() == 0);
+        CHECK(matcher.num_of_fallbacks() == 0);
+
+        aut.initial.add(1);
+        LazyDfaMatcher epsilon_matcher{ aut };
+        CHECK(epsilon_matcher.is_in_lang(""));
+        CHECK(epsilon_matcher.longest_match("c") == 0);
+    }
+
+    SECTION("Byte maps")
+    {
+        Nfa aut{ 2 };
+        aut.initial = { 0 };
+        aut.final = { 1 };
+        aut.delta.add(0, 1000000, 1);
+        ByteMap byte_map{ identity_byte_map() };
+        byte_map['x'] = 1000000;
+        byte_map['y'] = 1000000;
+        LazyDfaMatcher matcher{ aut, LazyDfaMatcher::DEFAULT_CACHE_BUDGET, byte_map };
+        CHECK(matcher.is_in_lang("x"));
+        CHECK(matcher.is_in_lang("y"));
+        CHECK(!matcher.is_in_lang("z"));
+    }
+
+    SECTION("Flushes and fallback to the NFA simulation")
+    {
+        const Nfa aut{ nth_from_end(12) };
+        const auto longest_accepted_prefix = [](const std::string& text) {
+            for (size_t length{ text.size() }; length >= 12; --length) {
+                if (text[length - 12] == 'a') { return length; }
+            }
+            return LazyDfaMatcher::NO_MATCH;
+        };
+        std::mt19937 generator{ 7 };
+        std::string text{};
+        for (size_t i{ 0 }; i < 3000; ++i) { text.push_back(static_cast<char>('a' + generator() % 2)); }
+
+        // New states are built at almost every byte of a random text, so a small budget makes the cache thrash.
+        LazyDfaMatcher thrashing_matcher{ aut, 4096 };
+        CHECK(thrashing_matcher.is_in_lang(text) == (text[text.size() - 12] == 'a'));
+        CHECK(thrashing_matcher.longest_match(text) == longest_accepted_prefix(text));
+        CHECK(thrashing_matcher.num_of_flushes() > 0);
+        CHECK(thrashing_matcher.num_of_fallbacks() > 0);
+        CHECK(thrashing_matcher.cache_usage() <= thrashing_matcher.cache_budget());
+
+        // A periodic text visits only a few states, the cache is flushed once in the random suffix and not thrashing.
+        std::string periodic_text{};
+        for (size_t i{ 0 }; i < 1000; ++i) { periodic_text += "ab"; }
+        periodic_text += text.substr(0, 40);
+        LazyDfaMatcher periodic_matcher{ aut, 8192 };
+        CHECK(periodic_matcher.longest_match(periodic_text) == longest_accepted_prefix(periodic_text));
+        CHECK(periodic_matcher.num_of_flushes() > 0);
+        CHECK(periodic_matcher.num_of_fallbacks() == 0);
+    }
+
+    SECTION("Random automata")
+    {
+        std::mt19937 generator{ 42 };
+        for (const size_t cache_budget: { size_t{ 256 }, size_t{ 2048 }, LazyDfaMatcher::DEFAULT_CACHE_BUDGET }) {
+            for (size_t round{ 0 }; round < 10; ++round) {
+                const Nfa aut{ random_aut(generator, static_cast<State>(3 + generator() % 30), { 'a', 'b', 'c' }, 2, 2, 2) };
+                LazyDfaMatcher matcher{ aut, cache_budget };
+                for (size_t i{ 0 }; i < 30; ++i) {
+                    const std::string text{ random_text(generator, 40) };
+                    CHECK(matcher.is_in_lang(text) == is_in_lang(aut, to_run(text)));
+                    CHECK(matcher.is_prfx_in_lang(text) == is_prfx_in_lang(aut, to_run(text)));
+                    CHECK(matcher.longest_match(text) == longest_match(aut, text));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/* tests-nfa-lazy-dfa.cc -- Tests for the lazily determinized automaton
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <random>
+
+#include "../3rdparty/catch.hpp"
+
+#include <mata/nfa.hh>
+#include <mata/nfa-lazy-dfa.hh>
+
+#include "../tests-utils.hh"
+
+using namespace Mata::Nfa;
+using namespace Mata::Util;
+
+using Mata::Tests::random_aut;
+
+TEST_CASE("Mata::Nfa::LazyDfa")
+{
+    Nfa aut{ 5 };
+    aut.initial = { 0, 1 };
+    aut.final = { 3 };
+    aut.delta.add(0, 'a', 2);
+    aut.delta.add(1, 'a', 3);
+    aut.delta.add(1, 'b', 4);
+    aut.delta.add(2, 'b', 3);
+    aut.delta.add(3, 'a', 3);
+
+    SECTION("States are built on demand")
+    {
+        LazyDfa dfa{ aut };
+        CHECK(dfa.num_of_states() == 0);
+        const State initial{ dfa.initial() };
+        CHECK(dfa.get_macrostate(initial) == StateSet{ 0, 1 });
+        CHECK(!dfa.is_final(initial));
+        CHECK(dfa.num_of_states() == 1);
+
+        const State after_a{ dfa.successor(initial, 'a') };
+        CHECK(dfa.get_macrostate(after_a) == StateSet{ 2, 3 });
+        CHECK(dfa.is_final(after_a));
+        CHECK(dfa.num_of_states() == 3); // Successors of the initial state over 'a' and 'b' are interned.
+        CHECK(dfa.successor(initial, 'a') == after_a);
+
+        const State dead{ dfa.successor(initial, 'c') };
+        CHECK(dfa.is_dead(dead));
+        CHECK(!dfa.is_final(dead));
+        CHECK(dfa.successors(dead).empty());
+        CHECK(dfa.successor(dead, 'a') == dead);
+
+        const LazyDfa::SuccessorRange successors{ dfa.successors(after_a) };
+        REQUIRE(successors.size() == 2);
+        CHECK(successors.begin()->symbol == 'a');
+        CHECK(dfa.get_macrostate(successors.begin()->target) == StateSet{ 3 });
+        CHECK(dfa.num_of_flushes() == 0);
+    }
+
+    SECTION("Matching, emptiness and universality")
+    {
+        LazyDfa dfa{ aut };
+        CHECK(is_in_lang(dfa, Run{ { 'a' }, {} }));
+        CHECK(is_in_lang(dfa, Run{ { 'a', 'b', 'a' }, {} }));
+        CHECK(!is_in_lang(dfa, Run{ { 'b' }, {} }));
+        CHECK(!is_in_lang(dfa, Run{ {}, {} }));
+
+        Run cex{};
+        CHECK(!is_lang_empty(dfa, &cex));
+        CHECK(cex.word == std::vector<Symbol>{ 'a' });
+        CHECK(cex.path == std::vector<State>{ dfa.initial(), dfa.successor(dfa.initial(), 'a') });
+
+        OnTheFlyAlphabet alphabet{ StringToSymbolMap{ { "a", 'a' }, { "b", 'b' } } };
+        CHECK(!is_universal(dfa, alphabet, &cex));
+        CHECK(cex.word.empty());
+        CHECK(cex.path == std::vector<State>{ dfa.initial() });
+
+        Nfa empty_aut{ aut };
+        empty_aut.final = { 4 };
+        empty_aut.initial = { 0 };
+        LazyDfa empty_dfa{ empty_aut };
+        CHECK(is_lang_empty(empty_dfa));
+
+        Nfa universal_aut{ 1 };
+        universal_aut.initial = { 0 };
+        universal_aut.final = { 0 };
+        universal_aut.delta.add(0, 'a', 0);
+        universal_aut.delta.add(0, 'b', 0);
+        LazyDfa universal_dfa{ universal_aut };
+        CHECK(is_universal(universal_dfa, alphabet));
+        universal_aut.delta.add(0, 'c', 0);
+        OnTheFlyAlphabet larger_alphabet{ StringToSymbolMap{ { "a", 'a' }, { "b", 'b' }, { "d", 'd' } } };
+        LazyDfa incomplete_dfa{ universal_aut };
+        CHECK(!is_universal(incomplete_dfa, larger_alphabet, &cex));
+        CHECK(cex.word == std::vector<Symbol>{ 'd' });
+        REQUIRE(cex.path.size() == 2);
+        CHECK(cex.path[0] == incomplete_dfa.initial());
+        CHECK(incomplete_dfa.is_dead(cex.path[1]));
+    }
+
+    SECTION("Random automata")
+    {
+        std::mt19937 generator{ 42 };
+        OnTheFlyAlphabet alphabet{ StringToSymbolMap{ { "0", 0 }, { "1", 1 }, { "2", 2 } } };
+        std::uniform_int_distribution<Symbol> symbol_distribution{ 0, 2 };
+        for (size_t round{ 0 }; round < 50; ++round) {
+            const Nfa random{ random_aut(generator, 4 + round % 10, { 0, 1, 2 }, 2, 1, 2) };
+            LazyDfa dfa{ random };
+            Run cex{};
+            const bool empty{ is_lang_empty(random) };
+            CHECK(is_lang_empty(dfa, &cex) == empty);
+            if (!empty) { CHECK(is_in_lang(random, cex)); }
+            const bool universal{ is_universal(random, alphabet, nullptr, {{ "algo", "antichains" }}) };
+            CHECK(is_universal(dfa, alphabet, &cex) == universal);
+            if (!universal) { CHECK(!is_in_lang(random, cex)); }
+
+            // A tiny budget flushes the cache all the time, matching must not be affected.
+            LazyDfa flushing_dfa{ random, 64 };
+            for (size_t i{ 0 }; i < 20; ++i) {
+                Run word{};
+                for (size_t length{ 0 }; length < i % 8; ++length) {
+                    word.word.push_back(symbol_distribution(generator));
+                }
+                CHECK(is_in_lang(flushing_dfa, word) == is_in_lang(random, word));
+                CHECK(is_in_lang(dfa, word) == is_in_lang(random, word));
+            }
+            CHECK(flushing_dfa.num_of_flushes() > 0);
+            CHECK(flushing_dfa.num_of_states() <= 16);
+        }
+    }
+}
@@ -0,0 +1,143 @@
+/* tests-nfa-multi-pattern.cc -- Tests for automata of many patterns tagged by pattern ids
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <random>
+
+#include "../3rdparty/catch.hpp"
+
+#include <mata/nfa.hh>
+#include <mata/nfa-multi-pattern.hh>
+
+#include "../tests-utils.hh"
+
+using namespace Mata::Nfa;
+using Mata::Tests::random_aut;
+
+namespace {
+    /// Automaton of the single word @p word.
+    Nfa word_aut(const std::string& word) {
+        Nfa aut{ word.size() + 1 };
+        aut.initial = { 0 };
+        aut.final = { static_cast<State>(word.size()) };
+        for (State state{ 0 }; state < word.size(); ++state) {
+            aut.delta.add(state, static_cast<unsigned char>(word[state]), state + 1);
+        }
+        return aut;
+    }
+
+    Run to_run(const std::string& text) { return Run{ { text.begin(), text.end() }, {} }; }
+} // namespace.
+
+TEST_CASE("Mata::Nfa::TaggedNfa")
+{
+    SECTION("Tagged union")
+    {
+        const TaggedNfa aut{ tagged_union({ word_aut("ab"), word_aut("ab"), word_aut("b") }) };
+        CHECK(aut.num_of_patterns == 3);
+        CHECK(aut.aut.initial.size() == 3);
+        CHECK(get_matching_patterns(aut, to_run("ab")) == PatternSet{ 0, 1 });
+        CHECK(get_matching_patterns(aut, to_run("b")) == PatternSet{ 2 });
+        CHECK(get_matching_patterns(aut, to_run("a")).empty());
+        CHECK(aut.get_tags(1000).empty());
+    }
+
+    SECTION("Determinization and minimization keep tags")
+    {
+        const TaggedNfa aut{ tagged_union({ word_aut("a"), word_aut("b"), word_aut("ab"), word_aut("ab") }) };
+        const TaggedNfa deterministic{ determinize(aut) };
+        CHECK(is_deterministic(deterministic.aut));
+        const TaggedNfa minimal{ minimize(aut) };
+        CHECK(is_deterministic(minimal.aut));
+        // The initial state, the state after 'a' (tagged {0}), after 'b' ({1}) and after "ab" ({2, 3}). Without tags,
+        //  the states after 'b' and after "ab" would be merged.
+        CHECK(minimal.aut.delta.post_size() == 4);
+        for (const std::string word: { "", "a", "b", "ab", "ba", "abb" }) {
+            CHECK(get_matching_patterns(deterministic, to_run(word)) == get_matching_patterns(aut, to_run(word)));
+            CHECK(get_matching_patterns(minimal, to_run(word)) == get_matching_patterns(aut, to_run(word)));
+        }
+        CHECK(get_matching_patterns(minimal, to_run("ab")) == PatternSet{ 2, 3 });
+    }
+
+    SECTION("Regular expressions")
+    {
+        const TaggedNfa aut{ tagged_union_of_regexes({ "abc", "a.*", "b+", "(ab)*" }) };
+        CHECK(aut.num_of_patterns == 4);
+        CHECK(get_matching_patterns(aut, to_run("abc")) == PatternSet{ 0, 1 });
+        CHECK(get_matching_patterns(aut, to_run("bb")) == PatternSet{ 2 });
+        CHECK(get_matching_patterns(aut, to_run("abab")) == PatternSet{ 1, 3 });
+        CHECK(get_matching_patterns(aut, to_run("")) == PatternSet{ 3 });
+    }
+
+    SECTION("Random patterns")
+    {
+        std::mt19937 generator{ 42 };
+        for (size_t round{ 0 }; round < 20; ++round) {
+            std::vector<Nfa> patterns{};
+            for (size_t i{ 0 }; i < 1 + round % 6; ++i) {
+                patterns.push_back(random_aut(generator, static_cast<State>(2 + generator() % 6), { 'a', 'b' }));
+            }
+            const TaggedNfa aut{ tagged_union(patterns) };
+            const TaggedNfa minimal{ minimize(aut) };
+            const MultiPatternMatcher matcher{ aut };
+            for (size_t i{ 0 }; i < 40; ++i) {
+                std::string word{};
+                for (size_t length{ generator() % 8 }; length > 0; --length) {
+                    word.push_back(static_cast<char>('a' + generator() % 3));
+                }
+                PatternSet expected{};
+                for (PatternId id{ 0 }; id < patterns.size(); ++id) {
+                    if (is_in_lang(patterns[id], to_run(word))) { expected.insert(id); }
+                }
+                CHECK(get_matching_patterns(aut, to_run(word)) == expected);
+                CHECK(get_matching_patterns(minimal, to_run(word)) == expected);
+                CHECK(matcher.match(word) == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Mata::Nfa::MultiPatternMatcher")
+{
+    const TaggedNfa aut{ tagged_union_of_regexes({ "GET /[a-z]*", "GET /admin.*", "POST.*" }) };
+    const MultiPatternMatcher matcher{ aut };
+    CHECK(matcher.num_of_patterns() == 3);
+
+    SECTION("Matches of whole inputs")
+    {
+        CHECK(matcher.match("GET /admin") == PatternSet{ 0, 1 });
+        CHECK(matcher.match("GET /admin/users") == PatternSet{ 1 });
+        CHECK(matcher.match("POST /login") == PatternSet{ 2 });
+        CHECK(matcher.match("PUT /").empty());
+    }
+
+    SECTION("Matches of all prefixes in one pass")
+    {
+        std::vector<std::pair<PatternId, size_t>> matches{};
+        matcher.scan("GET /ad/", [&](PatternId id, size_t length) { matches.emplace_back(id, length); });
+        const std::vector<std::pair<PatternId, size_t>> expected{ { 0, 5 }, { 0, 6 }, { 0, 7 } };
+        CHECK(matches == expected);
+    }
+
+    SECTION("Streams")
+    {
+        Mata::Dfa::StreamState state{ matcher.start() };
+        state = matcher.feed(state, "GET /ad");
+        CHECK(matcher.get_matches(state) == PatternSet{ 0 });
+        state = matcher.feed(state, "min/");
+        CHECK(matcher.get_matches(state) == PatternSet{ 1 });
+    }
+}
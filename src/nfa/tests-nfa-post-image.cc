@@ -0,0 +1,123 @@
+/* tests-nfa-post-image.cc -- Tests for computing post images of macrostates
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <map>
+#include <random>
+
+#include "../3rdparty/catch.hpp"
+
+#include <mata/nfa.hh>
+#include <mata/nfa-post-image.hh>
+
+#include "../tests-utils.hh"
+
+using namespace Mata::Nfa;
+using namespace Mata::Util;
+
+namespace {
+    /// Images of @p macrostate under all symbols computed transition by transition.
+    std::map<Symbol, StateSet> naive_images(const Nfa& aut, const StateSet& macrostate) {
+        std::map<Symbol, StateSet> images{};
+        for (const State state: macrostate) {
+            if (state >= aut.delta.post_size()) { continue; }
+            for (const Move& move: aut.delta[state]) { images[move.symbol].insert(move.targets); }
+        }
+        return images;
+    }
+
+    std::map<Symbol, StateSet> sweep_images(PostImageEngine& post_image, const Nfa& aut, const StateSet& macrostate) {
+        std::map<Symbol, StateSet> images{};
+        post_image.start(aut.delta, macrostate);
+        while (post_image.next()) {
+            CHECK(images.count(post_image.symbol()) == 0);
+            const std::vector<State> image(post_image.begin(), post_image.end());
+            CHECK(std::is_sorted(image.begin(), image.end()));
+            images[post_image.symbol()] = StateSet(image);
+            CHECK(images[post_image.symbol()].size() == post_image.size());
+        }
+        return images;
+    }
+} // namespace.
+
+TEST_CASE("Mata::Nfa::PostImageEngine")
+{
+    Nfa aut{ 12 };
+    aut.delta.add(1, 'a', 3);
+    aut.delta.add(1, 'a', 10);
+    aut.delta.add(1, 'b', 7);
+    aut.delta.add(3, 'a', 7);
+    aut.delta.add(3, 'a', 10);
+    aut.delta.add(3, 'b', 9);
+    aut.delta.add(9, 'c', 9);
+    aut.delta.add(7, 'b', 1);
+    PostImageEngine post_image{};
+
+    SECTION("Sweep over all symbols")
+    {
+        post_image.start(aut.delta, StateSet{ 1, 3, 9, 11, 100 });
+        REQUIRE(post_image.next());
+        CHECK(post_image.symbol() == 'a');
+        CHECK(std::vector<State>(post_image.begin(), post_image.end()) == std::vector<State>{ 3, 7, 10 });
+        REQUIRE(post_image.next());
+        CHECK(post_image.symbol() == 'b');
+        CHECK(std::vector<State>(post_image.begin(), post_image.end()) == std::vector<State>{ 7, 9 });
+        REQUIRE(post_image.next());
+        CHECK(post_image.symbol() == 'c');
+        CHECK(std::vector<State>(post_image.begin(), post_image.end()) == std::vector<State>{ 9 });
+        CHECK(!post_image.next());
+        CHECK(post_image.size() == 0);
+
+        post_image.start(aut.delta, StateSet{ 0, 10 });
+        CHECK(!post_image.next());
+        post_image.start(aut.delta, StateSet{});
+        CHECK(!post_image.next());
+    }
+
+    SECTION("Image under a single symbol")
+    {
+        const StateSet macrostate{ 1, 3, 7 };
+        std::vector<State> image{ 42 };
+        post_image.post(aut.delta, macrostate.ToVector().data(),
+                        macrostate.ToVector().data() + macrostate.size(), 'b', image);
+        CHECK(image == std::vector<State>{ 1, 7, 9 });
+        post_image.post(aut.delta, macrostate.ToVector().data(),
+                        macrostate.ToVector().data() + macrostate.size(), 'c', image);
+        CHECK(image.empty());
+        CHECK(aut.post(macrostate, 'a') == StateSet{ 3, 7, 10 });
+        CHECK(aut.post(StateSet{ 200 }, 'a').empty());
+    }
+
+    SECTION("Random automata")
+    {
+        std::mt19937 generator{ 42 };
+        // A small universe exercises images read from the bitset, a large one images sorted in place.
+        for (const State num_of_states: { State{ 50 }, State{ 20000 } }) {
+            const Nfa random_aut{ Mata::Tests::random_aut(generator, num_of_states, { 0, 1, 2, 3, 4, 5 }, 3, 0, 0) };
+            std::uniform_int_distribution<State> state_distribution{ 0, num_of_states - 1 };
+            for (size_t round{ 0 }; round < 100; ++round) {
+                StateSet macrostate{};
+                for (size_t i{ 0 }; i < round % 20; ++i) { macrostate.insert(state_distribution(generator)); }
+                const std::map<Symbol, StateSet> images{ naive_images(random_aut, macrostate) };
+                CHECK(sweep_images(post_image, random_aut, macrostate) == images);
+                for (Symbol symbol{ 0 }; symbol <= 6; ++symbol) {
+                    const auto image{ images.find(symbol) };
+                    CHECK(random_aut.post(macrostate, symbol) == (image == images.end() ? StateSet{} : image->second));
+                }
+            }
+        }
+    }
+}
@@ -1,5 +1,6 @@
 // TODO: some header
 
+#include <random>
 #include <unordered_set>
 
 #include "../3rdparty/catch.hpp"
@@ -10,12 +11,15 @@
 #include <mata/nfa-algorithms.hh>
 #include <mata/re2parser.hh>
 
+#include "../tests-utils.hh"
+
 using namespace Mata::Nfa::Algorithms;
 using namespace Mata::Nfa;
 using namespace Mata::Strings;
 using namespace Mata::Nfa::Plumbing;
 using namespace Mata::Util;
 using namespace Mata::Parser;
+using Mata::Tests::random_aut;
 
 using Word = std::vector<Symbol>;
 
@@ -602,6 +606,189 @@ TEST_CASE("Mata::Nfa::determinize()")
 	}
 } // }}}
 
+TEST_CASE("Mata::Nfa::determinize() with params")
+{ // {{{
+	SECTION("Same subsets as the sequential determinization")
+	{
+		Nfa aut(20);
+		FILL_WITH_AUT_A(aut);
+		std::unordered_map<StateSet, State> expected_map;
+		const Nfa expected = determinize(aut, &expected_map);
+
+		for (const std::string threads: { "1", "2", "4" }) {
+			for (const std::string numbering: { "deterministic", "arbitrary" }) {
+				std::unordered_map<StateSet, State> subset_map;
+				const Nfa result = determinize(aut, {{"threads", threads}, {"numbering", numbering}}, &subset_map);
+				CHECK(result.delta.post_size() == expected.delta.post_size());
+				CHECK(result.get_num_of_trans() == expected.get_num_of_trans());
+				CHECK(is_deterministic(result));
+				CHECK(subset_map.size() == expected_map.size());
+				for (const auto& [macrostate, state]: subset_map) {
+					REQUIRE(haskey(expected_map, macrostate));
+					CHECK(result.final[state] == expected.final[expected_map.at(macrostate)]);
+				}
+				CHECK(are_equivalent(result, aut));
+			}
+		}
+	}
+
+	SECTION("Deterministic numbering does not depend on the number of threads")
+	{
+		std::mt19937 generator{ 7 };
+		const Nfa aut = random_aut(generator, 12, { 0, 1, 2 }, 2, 1, 4);
+		std::unordered_map<StateSet, State> single_map;
+		const Nfa single = determinize(aut, {{"threads", "1"}, {"numbering", "deterministic"}}, &single_map);
+		for (const size_t threads: { 2, 3, 8 }) {
+			std::unordered_map<StateSet, State> subset_map;
+			const Nfa result = Algorithms::determinize_parallel(aut, threads, true, &subset_map);
+			CHECK(subset_map == single_map);
+			CHECK(result.get_num_of_trans() == single.get_num_of_trans());
+			for (State state{ 0 }; state < single.delta.post_size(); ++state) {
+				for (const Move& move: single.get_moves_from(state)) {
+					CHECK(result.delta.contains(state, move.symbol, *move.targets.begin()));
+				}
+			}
+		}
+		std::unordered_map<StateSet, State> arbitrary_map;
+		const Nfa arbitrary = determinize(aut, {{"threads", "4"}, {"numbering", "arbitrary"}}, &arbitrary_map);
+		CHECK(arbitrary_map.size() == single_map.size());
+		CHECK(arbitrary.get_num_of_trans() == single.get_num_of_trans());
+	}
+
+	SECTION("Empty automaton")
+	{
+		Nfa aut(3);
+		const Nfa result = determinize(aut, {{"threads", "4"}});
+		CHECK(result.initial.size() == 1);
+		CHECK(result.final.size() == 0);
+		CHECK(result.get_num_of_trans() == 0);
+	}
+
+	SECTION("wrong parameters")
+	{
+		Nfa aut(3);
+		for (const std::string threads: { "many", "", "0", "-1", "2x", "99999999999999999999" }) {
+			CHECK_THROWS_WITH(determinize(aut, {{"threads", threads}}),
+				Catch::Contains("received an invalid value"));
+		}
+		CHECK(is_deterministic(determinize(aut, {{"threads", "100000"}})));
+		CHECK_THROWS_WITH(determinize(aut, {{"numbering", "foo"}}),
+			Catch::Contains("received an unknown value"));
+	}
+} // }}}
+
+TEST_CASE("Mata::Nfa::determinize() with threads for profiling", "[.profiling],[determinize]")
+{
+	std::mt19937 generator{ 42 };
+	const Nfa aut = random_aut(generator, 24, { 0, 1, 2, 3 });
+	const Nfa result = determinize(aut, {{"threads", "8"}});
+	CHECK(is_deterministic(result));
+}
+
+TEST_CASE("Mata::Nfa::minimize()")
+{ // {{{
+	const std::unordered_set<std::string> ALGORITHMS = {
+		"brzozowski",
+		"hopcroft",
+	};
+
+	SECTION("Deterministic automaton with equivalent states")
+	{
+		Nfa aut(6);
+		aut.initial = {0};
+		aut.final = {3, 4};
+		aut.delta.add(0, 'a', 1);
+		aut.delta.add(0, 'b', 2);
+		aut.delta.add(1, 'a', 3);
+		aut.delta.add(2, 'a', 4);
+		aut.delta.add(3, 'b', 3);
+		aut.delta.add(4, 'b', 4);
+		aut.delta.add(2, 'c', 5); // Useless state.
+
+		for (const auto& algo : ALGORITHMS) {
+			const Nfa result = minimize(aut, {{"algo", algo}});
+			CHECK(is_deterministic(result));
+			CHECK(result.delta.post_size() == 3);
+			CHECK(result.get_num_of_trans() == 4);
+			CHECK(are_equivalent(result, aut));
+		}
+
+		const Nfa result = minimize(aut);
+		CHECK(result.delta.post_size() == 3);
+		CHECK(are_equivalent(result, aut));
+	}
+
+	SECTION("Nondeterministic automaton")
+	{
+		Nfa aut(20);
+		FILL_WITH_AUT_A(aut);
+
+		const Nfa brzozowski = minimize(aut, {{"algo", "brzozowski"}});
+		const Nfa hopcroft = minimize(aut, {{"algo", "hopcroft"}});
+		CHECK(is_deterministic(hopcroft));
+		CHECK(hopcroft.delta.post_size() == brzozowski.delta.post_size());
+		CHECK(hopcroft.get_num_of_trans() == brzozowski.get_num_of_trans());
+		CHECK(are_equivalent(hopcroft, aut));
+		CHECK(are_equivalent(minimize(aut), aut));
+		CHECK(minimize(determinize(aut)).delta.post_size() == hopcroft.delta.post_size());
+	}
+
+	SECTION("Automaton with distinct states differing only in defined symbols")
+	{
+		Nfa aut(4);
+		aut.initial = {0};
+		aut.final = {1, 2, 3};
+		aut.delta.add(0, 'a', 1);
+		aut.delta.add(1, 'a', 2);
+		aut.delta.add(2, 'b', 3);
+		aut.delta.add(3, 'a', 2);
+
+		for (const auto& algo : ALGORITHMS) {
+			const Nfa result = minimize(aut, {{"algo", algo}});
+			CHECK(result.delta.post_size() == 3);
+			CHECK(are_equivalent(result, aut));
+		}
+	}
+
+	SECTION("Empty language")
+	{
+		Nfa aut(3);
+		aut.initial = {0};
+		aut.delta.add(0, 'a', 1);
+		aut.delta.add(1, 'a', 2);
+
+		for (const auto& algo : ALGORITHMS) {
+			const Nfa result = minimize(aut, {{"algo", algo}});
+			CHECK(result.initial.size() == 1);
+			CHECK(result.final.size() == 0);
+			CHECK(result.get_num_of_trans() == 0);
+		}
+	}
+
+	SECTION("wrong parameters")
+	{
+		Nfa aut(1);
+		aut.initial = {0};
+
+		CHECK_THROWS_WITH(minimize(aut, {{"algo", "foo"}}),
+			Catch::Contains("received an unknown value"));
+	}
+} // }}}
+
+TEST_CASE("Mata::Nfa::minimize() hopcroft for profiling", "[.profiling],[minimize]") {
+    const size_t num_of_states{ 200000 };
+    Nfa aut(num_of_states);
+    aut.initial.add(0);
+    // A counter modulo num_of_states with a final state every 1000 states; symbol 'b' resets the counter.
+    for (State state{ 0 }; state < num_of_states; ++state) {
+        aut.delta.add(state, 'a', (state + 1) % num_of_states);
+        aut.delta.add(state, 'b', 0);
+        if (state % 1000 == 999) { aut.final.add(state); }
+    }
+    const Nfa result = minimize(aut, {{"algo", "hopcroft"}});
+    CHECK(result.delta.post_size() == 1000);
+}
+
 TEST_CASE("Mata::Nfa::minimize() for profiling", "[.profiling],[minimize]") {
     Nfa aut(4);
     Nfa result;
@@ -1252,6 +1439,7 @@ TEST_CASE("Mata::Nfa::is_universal()")
 	const std::unordered_set<std::string> ALGORITHMS = {
 		"naive",
 		"antichains",
+		"antichains-sim",
 	};
 
 	SECTION("empty automaton, empty alphabet")
@@ -1377,6 +1565,9 @@ TEST_CASE("Mata::Nfa::is_universal()")
 			REQUIRE((cex.word[2] == alph["a"] || cex.word[2] == alph["b"]));
 			REQUIRE((cex.word[3] == alph["a"] || cex.word[3] == alph["b"]));
 			REQUIRE(cex.word[2] != cex.word[3]);
+			if (algo == "naive") { // The path goes through the states of the determinized automaton.
+				REQUIRE(cex.path.size() == cex.word.size() + 1);
+			}
 		}
 	}
 
@@ -1459,6 +1650,46 @@ TEST_CASE("Mata::Nfa::is_universal()")
 	}
 } // }}}
 
+TEST_CASE("Mata::Nfa::is_universal() and is_included() with antichains for profiling", "[.profiling],[antichains]")
+{
+    // Random automata in the Tabakov-Vardi model: transition density 2.0 per symbol, 20 final states drawn at random.
+    OnTheFlyAlphabet alph{ std::vector<std::string>{ "0", "1" } };
+    for (unsigned seed{ 0 }; seed < 50; ++seed) {
+        std::mt19937 generator{ seed };
+        const Nfa smaller{ random_aut(generator, 40, { 0, 1 }, 2, 1, 20) };
+        const Nfa bigger{ random_aut(generator, 40, { 0, 1 }, 2, 1, 20) };
+        for (const std::string algo: { "antichains", "antichains-sim" }) {
+            is_universal(bigger, alph, {{"algo", algo}});
+            is_included(smaller, bigger, nullptr, &alph, {{"algo", algo}});
+        }
+    }
+}
+
+TEST_CASE("Mata::Nfa::is_included() and is_universal() algorithms agree on random automata")
+{
+    OnTheFlyAlphabet alph{ std::vector<std::string>{ "0", "1" } };
+    for (unsigned seed{ 0 }; seed < 100; ++seed) {
+        std::mt19937 generator{ seed };
+        const Nfa smaller{ random_aut(generator, 6, { 0, 1 }, 2, 2, 3) };
+        const Nfa bigger{ random_aut(generator, 6, { 0, 1 }, 2, 2, 3) };
+        const bool expected_incl{ is_included(smaller, bigger, nullptr, &alph, {{"algo", "naive"}}) };
+        const bool expected_univ{ is_universal(bigger, alph, {{"algo", "naive"}}) };
+        for (const std::string algo: { "antichains", "antichains-sim", "hkc" }) {
+            Run cex;
+            CHECK(is_included(smaller, bigger, &cex, &alph, {{"algo", algo}}) == expected_incl);
+            if (!expected_incl) {
+                CHECK(is_in_lang(smaller, cex));
+                CHECK(!is_in_lang(bigger, cex));
+            }
+        }
+        for (const std::string algo: { "antichains", "antichains-sim" }) {
+            Run cex;
+            CHECK(is_universal(bigger, alph, &cex, {{"algo", algo}}) == expected_univ);
+            if (!expected_univ) { CHECK(!is_in_lang(bigger, cex)); }
+        }
+    }
+}
+
 TEST_CASE("Mata::Nfa::is_included()")
 { // {{{
 	Nfa smaller(10);
@@ -1469,6 +1700,8 @@ TEST_CASE("Mata::Nfa::is_included()")
 	const std::unordered_set<std::string> ALGORITHMS = {
 		"naive",
 		"antichains",
+		"antichains-sim",
+		"hkc",
 	};
 
 	SECTION("{} <= {}, empty alphabet")
@@ -1638,6 +1871,23 @@ TEST_CASE("Mata::Nfa::is_included()")
 		}
 	}
 
+	SECTION("Counterexample path of the naive algorithm goes through the smaller automaton")
+	{
+		OnTheFlyAlphabet alph{"a", "b"};
+		smaller.initial = {1};
+		smaller.final = {3};
+		smaller.delta.add(1, alph["a"], 2);
+		smaller.delta.add(2, alph["b"], 3);
+		bigger.initial = {11};
+		bigger.final = {12};
+		bigger.delta.add(11, alph["a"], 12);
+
+		params["algo"] = "naive";
+		CHECK(!is_included(smaller, bigger, &cex, &alph, params));
+		CHECK(cex.word == Word{ alph["a"], alph["b"] });
+		CHECK(cex.path == std::vector<State>{ 1, 2, 3 });
+	}
+
 	SECTION("wrong parameters 1")
 	{
         OnTheFlyAlphabet alph{};
@@ -1668,6 +1918,8 @@ TEST_CASE("Mata::Nfa::are_equivalent")
     const std::unordered_set<std::string> ALGORITHMS = {
             "naive",
             "antichains",
+            "antichains-sim",
+            "hkc",
     };
 
     SECTION("{} == {}, empty alphabet")
@@ -1824,6 +2076,91 @@ TEST_CASE("Mata::Nfa::are_equivalent")
     }
 }
 
+TEST_CASE("Mata::Nfa::Algorithms::are_equivalent_hkc()")
+{ // {{{
+    Run cex;
+
+    SECTION("Automata differing in the number of states")
+    {
+        // (a+b)* as a single state and as two states switching on each symbol.
+        Nfa lhs(1);
+        lhs.initial = {0};
+        lhs.final = {0};
+        lhs.delta.add(0, 'a', 0);
+        lhs.delta.add(0, 'b', 0);
+
+        Nfa rhs(2);
+        rhs.initial = {0, 1};
+        rhs.final = {0, 1};
+        rhs.delta.add(0, 'a', 1);
+        rhs.delta.add(0, 'b', 0);
+        rhs.delta.add(1, 'a', 0);
+        rhs.delta.add(1, 'b', 1);
+
+        CHECK(Algorithms::are_equivalent_hkc(lhs, rhs, &cex));
+        CHECK(Algorithms::are_equivalent_hkc(rhs, lhs));
+    }
+
+    SECTION("Shortest counterexample")
+    {
+        // Words of length at most 2 over {a} vs. words of length at most 3 over {a}.
+        Nfa lhs(3);
+        lhs.initial = {0};
+        lhs.final = {0, 1, 2};
+        lhs.delta.add(0, 'a', 1);
+        lhs.delta.add(1, 'a', 2);
+
+        Nfa rhs(4);
+        rhs.initial = {0};
+        rhs.final = {0, 1, 2, 3};
+        rhs.delta.add(0, 'a', 1);
+        rhs.delta.add(1, 'a', 2);
+        rhs.delta.add(2, 'a', 3);
+
+        CHECK(!Algorithms::are_equivalent_hkc(lhs, rhs, &cex));
+        CHECK(cex.word == Word{ 'a', 'a', 'a' });
+        CHECK(!Algorithms::are_equivalent_hkc(rhs, lhs, &cex));
+        CHECK(cex.word == Word{ 'a', 'a', 'a' });
+
+        CHECK(Algorithms::is_included_hkc(lhs, rhs, nullptr, &cex, {}));
+        CHECK(!Algorithms::is_included_hkc(rhs, lhs, nullptr, &cex, {}));
+        CHECK(cex.word == Word{ 'a', 'a', 'a' });
+    }
+
+    SECTION("Nondeterministic automata with the same language")
+    {
+        Nfa aut(20);
+        FILL_WITH_AUT_A(aut);
+        const Nfa minimal = minimize(aut);
+        CHECK(Algorithms::are_equivalent_hkc(aut, minimal));
+        CHECK(Algorithms::are_equivalent_hkc(aut, revert(revert(aut))));
+
+        Nfa other(20);
+        FILL_WITH_AUT_B(other);
+        CHECK(!Algorithms::are_equivalent_hkc(aut, other, &cex));
+        CHECK(is_in_lang(aut, cex) != is_in_lang(other, cex));
+    }
+
+    SECTION("Congruence closure")
+    {
+        const StateSet a{ 0 };
+        const StateSet b{ 1 };
+        const StateSet ab{ 0, 1 };
+        const StateSet abc{ 0, 1, 2 };
+        Algorithms::CongruenceClosure closure{};
+        closure.add(a, ab);
+        closure.add(b, StateSet{ 1, 2 });
+
+        // A ~ A+B rewrites A to A+B, B ~ B+C then rewrites A+B to A+B+C.
+        CHECK(closure.are_congruent(a, abc));
+        CHECK(closure.are_congruent(abc, a));
+        CHECK(closure.are_congruent(ab, abc));
+        CHECK(closure.are_congruent(StateSet{ 0, 3 }, StateSet{ 0, 1, 2, 3 }));
+        CHECK(!closure.are_congruent(a, b));
+        CHECK(!closure.are_congruent(StateSet{ 2 }, abc));
+    }
+} // }}}
+
 TEST_CASE("Mata::Nfa::revert()")
 { // {{{
 	Nfa aut(9);
@@ -2450,6 +2787,59 @@ TEST_CASE("Mata::Nfa::remove_epsilon()")
     REQUIRE(aut.delta.contains(5, 'a', 9));
 }
 
+TEST_CASE("Mata::Nfa::remove_epsilon() with epsilon cycles and chains")
+{
+    Nfa aut{10};
+    aut.initial = {0};
+    aut.final = {4};
+    // Epsilon cycle 0 -> 1 -> 2 -> 0 with an epsilon chain 2 -> 3 -> 4.
+    aut.delta.add(0, EPSILON, 1);
+    aut.delta.add(1, EPSILON, 2);
+    aut.delta.add(2, EPSILON, 0);
+    aut.delta.add(2, EPSILON, 3);
+    aut.delta.add(3, EPSILON, 4);
+    aut.delta.add(1, 'a', 5);
+    aut.delta.add(3, 'b', 6);
+    aut.delta.add(4, 'c', 7);
+    aut.delta.add(5, EPSILON, 3);
+    aut.delta.add(6, 'a', 6);
+
+    const Nfa result{ remove_epsilon(aut) };
+    for (const State state: { 0, 1, 2 }) {
+        CHECK(result.delta.contains(state, 'a', 5));
+        CHECK(result.delta.contains(state, 'b', 6));
+        CHECK(result.delta.contains(state, 'c', 7));
+        CHECK(result.final[state]);
+    }
+    CHECK(!result.delta.contains(3, 'a', 5));
+    CHECK(result.delta.contains(3, 'b', 6));
+    CHECK(result.delta.contains(3, 'c', 7));
+    CHECK(result.final[3]);
+    CHECK(result.delta.contains(5, 'b', 6));
+    CHECK(result.delta.contains(5, 'c', 7));
+    CHECK(result.final[5]);
+    CHECK(!result.final[6]);
+    CHECK(!result.final[7]);
+    CHECK(result.get_num_of_trans() == 3 * 3 + 2 + 2 + 1 + 1);
+    for (State state{ 0 }; state < result.delta.post_size(); ++state) {
+        CHECK(result.delta[state].find(Move{ EPSILON }) == result.delta[state].end());
+    }
+}
+
+TEST_CASE("Mata::Nfa::remove_epsilon() on regex-derived automata for profiling", "[.profiling],[remove_epsilon]")
+{
+    std::string pattern{};
+    for (size_t i{ 0 }; i < 100; ++i) { pattern += "(a|b|c*)"; }
+    // The parser takes the epsilon symbol as an int, so the default epsilon of the parser is used.
+    const Symbol epsilon{ 306 };
+    Nfa aut;
+    Mata::RE2Parser::create_nfa(&aut, pattern, true, epsilon, false);
+    for (size_t i{ 0 }; i < 10; ++i) {
+        const Nfa result{ remove_epsilon(aut, epsilon) };
+        CHECK(!is_lang_empty(result));
+    }
+}
+
 TEST_CASE("Profile Mata::Nfa::remove_epsilon()", "[.profiling]")
 {
     for (size_t n{}; n < 100000; ++n) {
@@ -2669,6 +3059,107 @@ TEST_CASE("Mata::Nfa::delta.operator[]")
     REQUIRE(aut1.delta[60].empty());
 }
 
+TEST_CASE("Mata::Nfa::Delta::get_predecessors()")
+{
+    const auto predecessors_of = [](const Delta& delta, State target) {
+        std::vector<std::pair<State, Symbol>> result{};
+        for (const Predecessor& predecessor: delta.get_predecessors(target)) {
+            result.emplace_back(predecessor.source, predecessor.symbol);
+        }
+        return result;
+    };
+    using Predecessors = std::vector<std::pair<State, Symbol>>;
+
+    Nfa aut{ 3 };
+    CHECK(aut.delta.get_predecessors(0).empty());
+    CHECK(aut.delta.get_predecessors(10).empty());
+
+    aut.delta.add(2, 'b', 1);
+    aut.delta.add(0, 'b', 1);
+    aut.delta.add(0, 'a', 1);
+    aut.delta.add(1, 'a', 0);
+    aut.delta.add(1, 'c', 5); // Target without its own post.
+    CHECK(predecessors_of(aut.delta, 1) == Predecessors{ { 0, 'a' }, { 0, 'b' }, { 2, 'b' } });
+    CHECK(predecessors_of(aut.delta, 0) == Predecessors{ { 1, 'a' } });
+    CHECK(predecessors_of(aut.delta, 5) == Predecessors{ { 1, 'c' } });
+    CHECK(aut.delta.get_predecessors(2).empty());
+
+    SECTION("Index is dropped by modifications")
+    {
+        aut.delta.add(2, 'a', 2);
+        CHECK(predecessors_of(aut.delta, 2) == Predecessors{ { 2, 'a' } });
+        aut.delta.remove(0, 'b', 1);
+        CHECK(predecessors_of(aut.delta, 1) == Predecessors{ { 0, 'a' }, { 2, 'b' } });
+        aut.delta[1].insert(Move{ 'd', 2 });
+        CHECK(predecessors_of(aut.delta, 2) == Predecessors{ { 1, 'd' }, { 2, 'a' } });
+        aut.add_state();
+        CHECK(aut.delta.get_predecessors(6).empty());
+        aut.delta.clear();
+        CHECK(aut.delta.get_predecessors(1).empty());
+    }
+
+    SECTION("Transitions to a state")
+    {
+        const TransSequence transitions{ aut.get_transitions_to(1) };
+        CHECK(transitions == TransSequence{ { 0, 'a', 1 }, { 0, 'b', 1 }, { 2, 'b', 1 } });
+        CHECK(aut.get_transitions_to(2).empty());
+    }
+}
+
+TEST_CASE("Mata::Nfa::Delta::add_bulk()")
+{
+    const TransSequence transitions{
+        { 3, 'b', 0 }, { 0, 'a', 2 }, { 0, 'a', 1 }, { 3, 'a', 4 }, { 0, 'a', 2 }, { 0, 'c', 0 }, { 3, 'b', 3 }
+    };
+    Nfa expected{};
+    for (const Trans& transition: transitions) { expected.delta.add(transition); }
+    const auto get_transitions = [](const Nfa& aut) {
+        TransSequence result{};
+        for (const Trans& transition: aut.delta) { result.push_back(transition); }
+        return result;
+    };
+
+    SECTION("Empty delta")
+    {
+        Nfa aut{};
+        aut.delta.add_bulk(transitions);
+        CHECK(aut.delta.post_size() == 4);
+        CHECK(aut.delta.max_state() == 4);
+        CHECK(aut.get_num_of_trans() == 6);
+        CHECK(get_transitions(aut) == get_transitions(expected));
+        CHECK(aut.delta[0].size() == 2);
+        CHECK(aut.delta[0].find(Move{ 'a' })->targets == StateSet{ 1, 2 });
+    }
+
+    SECTION("Merge with existing transitions")
+    {
+        Nfa aut{ 5 };
+        aut.delta.add(0, 'a', 3);
+        aut.delta.add(0, 'b', 0);
+        aut.delta.add(3, 'b', 0);
+        aut.delta.add(4, 'a', 4);
+        aut.delta.add_bulk(transitions);
+        expected.delta.add(0, 'a', 3);
+        expected.delta.add(0, 'b', 0);
+        expected.delta.add(4, 'a', 4);
+        CHECK(get_transitions(aut) == get_transitions(expected));
+        CHECK(aut.delta[0].find(Move{ 'a' })->targets == StateSet{ 1, 2, 3 });
+        CHECK(aut.delta.get_predecessors(0).size() == 3);
+    }
+
+    SECTION("Automaton from transitions")
+    {
+        const Nfa aut{ Nfa::from_transitions(transitions, { 0 }, { 4, 6 }) };
+        CHECK(aut.delta.post_size() == 7);
+        CHECK(aut.initial[0]);
+        CHECK(aut.final[4]);
+        CHECK(aut.final[6]);
+        CHECK(get_transitions(aut) == get_transitions(expected));
+        CHECK(is_in_lang(aut, Run{ { 'c', 'a' }, {} }) == false);
+        CHECK(Nfa::from_transitions({}).delta.empty());
+    }
+}
+
 TEST_CASE("Mata::Nfa::Nfa::unify_(initial/final)()") {
     Nfa nfa{10};
 
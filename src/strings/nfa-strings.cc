@@ -65,26 +65,26 @@ WordSet ShortestWordsMap::get_shortest_words_for(State state) const
     return get_shortest_words_for(StateSet{ state });
 }
 
-void ShortestWordsMap::insert_initial_lengths()
+void ShortestWordsMap::insert_initial_lengths(const Nfa::Nfa& aut)
 {
-    const auto initial_states{ reversed_automaton.initial };
-    if (!initial_states.empty())
+    const auto final_states{ aut.final };
+    if (!final_states.empty())
     {
-        for (const State state: initial_states)
+        for (const State state: final_states)
         {
             shortest_words_map.insert(std::make_pair(state, std::make_pair(0,
                                                                            WordSet{ std::vector<Symbol>{} })));
         }
 
-        const auto initial_states_begin{ initial_states.begin() };
-        const auto initial_states_end{ initial_states.end() };
-        processed.insert(initial_states_begin, initial_states_end);
-        fifo_queue.insert(fifo_queue.end(), initial_states_begin,
-                          initial_states_end);
+        const auto final_states_begin{ final_states.begin() };
+        const auto final_states_end{ final_states.end() };
+        processed.insert(final_states_begin, final_states_end);
+        fifo_queue.insert(fifo_queue.end(), final_states_begin,
+                          final_states_end);
     }
 }
 
-void ShortestWordsMap::compute()
+void ShortestWordsMap::compute(const Nfa::Nfa& aut)
 {
     State state{};
     while (!fifo_queue.empty())
@@ -93,45 +93,43 @@ void ShortestWordsMap::compute()
         fifo_queue.pop_front();
 
         // Compute the shortest words for the current state.
-        compute_for_state(state);
+        compute_for_state(aut, state);
     }
 }
 
-void ShortestWordsMap::compute_for_state(const State state)
+void ShortestWordsMap::compute_for_state(const Nfa::Nfa& aut, const State state)
 {
     const LengthWordsPair& dst{ map_default_shortest_words(state) };
     const WordLength dst_length_plus_one{ dst.first + 1 };
     LengthWordsPair act;
 
-    for (const Move& transition: reversed_automaton.get_moves_from(state))
+    for (const Predecessor& predecessor: aut.delta.get_predecessors(state))
     {
-        for (const State state_to: transition.targets)
-        {
-            const LengthWordsPair& orig{ map_default_shortest_words(state_to) };
-            act = orig;
+        const State state_to{ predecessor.source };
+        const LengthWordsPair& orig{ map_default_shortest_words(state_to) };
+        act = orig;
 
-            if ((act.first == -1) || (dst_length_plus_one < act.first))
-            {
-                // Found new shortest words after appending transition symbols.
-                act.second.clear();
-                update_current_words(act, dst, transition.symbol);
-            }
-            else if (dst_length_plus_one == act.first)
-            {
-                // Append transition symbol to increase length of the shortest words.
-                update_current_words(act, dst, transition.symbol);
-            }
+        if ((act.first == -1) || (dst_length_plus_one < act.first))
+        {
+            // Found new shortest words after appending transition symbols.
+            act.second.clear();
+            update_current_words(act, dst, predecessor.symbol);
+        }
+        else if (dst_length_plus_one == act.first)
+        {
+            // Append transition symbol to increase length of the shortest words.
+            update_current_words(act, dst, predecessor.symbol);
+        }
 
-            if (orig.second != act.second)
-            {
-                shortest_words_map[state_to] = act;
-            }
+        if (orig.second != act.second)
+        {
+            shortest_words_map[state_to] = act;
+        }
 
-            if (processed.find(state_to) == processed.end())
-            {
-                processed.insert(state_to);
-                fifo_queue.push_back(state_to);
-            }
+        if (processed.find(state_to) == processed.end())
+        {
+            processed.insert(state_to);
+            fifo_queue.push_back(state_to);
         }
     }
 }
@@ -0,0 +1,145 @@
+/* tests-antichain.cc -- Tests for the indexed antichain
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "../3rdparty/catch.hpp"
+
+#include <mata/nfa.hh>
+#include <mata/antichain.hh>
+
+using namespace Mata::Util;
+using namespace Mata::Nfa;
+
+TEST_CASE("Mata::Util::Antichain")
+{
+    Antichain<State, StateSet> antichain{};
+    CHECK(antichain.empty());
+
+    SECTION("Subsumption is checked only for the same keys")
+    {
+        antichain.insert(1, StateSet{ 1, 2 });
+        CHECK(antichain.is_subsumed(1, StateSet{ 1, 2 }));
+        CHECK(antichain.is_subsumed(1, StateSet{ 0, 1, 2, 3 }));
+        CHECK(!antichain.is_subsumed(1, StateSet{ 1 }));
+        CHECK(!antichain.is_subsumed(1, StateSet{ 1, 3 }));
+        CHECK(!antichain.is_subsumed(2, StateSet{ 1, 2 }));
+        CHECK(!antichain.is_subsumed(2, StateSet{ 0, 1, 2, 3 }));
+    }
+
+    SECTION("Empty set subsumes everything with the same key")
+    {
+        antichain.insert(0, StateSet{});
+        CHECK(antichain.is_subsumed(0, StateSet{}));
+        CHECK(antichain.is_subsumed(0, StateSet{ 100, 200 }));
+        CHECK(!antichain.is_subsumed(1, StateSet{}));
+    }
+
+    SECTION("Removing subsumed elements")
+    {
+        const auto id_a{ antichain.insert(1, StateSet{ 1, 2, 3 }) };
+        const auto id_b{ antichain.insert(1, StateSet{ 1, 4 }) };
+        const auto id_c{ antichain.insert(1, StateSet{ 2, 3, 5 }) };
+        const auto id_d{ antichain.insert(2, StateSet{ 1, 2, 3 }) };
+        CHECK(antichain.size() == 4);
+
+        CHECK(antichain.remove_subsumed(1, StateSet{ 2, 3 }) == 2);
+        CHECK(antichain.size() == 2);
+        CHECK(!antichain.is_alive(id_a));
+        CHECK(antichain.is_alive(id_b));
+        CHECK(!antichain.is_alive(id_c));
+        CHECK(antichain.is_alive(id_d));
+        // Removed elements stay accessible through their ids.
+        CHECK(antichain.get_key(id_a) == 1);
+        CHECK(antichain.get_set(id_a) == StateSet{ 1, 2, 3 });
+
+        CHECK(!antichain.is_subsumed(1, StateSet{ 1, 2, 3 }));
+        CHECK(antichain.is_subsumed(2, StateSet{ 1, 2, 3 }));
+    }
+
+    SECTION("Inserting only non-subsumed elements")
+    {
+        const auto [id_a, inserted_a]{ antichain.insert_if_not_subsumed(1, StateSet{ 1, 2, 3 }) };
+        CHECK(inserted_a);
+        CHECK(!antichain.insert_if_not_subsumed(1, StateSet{ 1, 2, 3, 4 }).second);
+        const auto [id_b, inserted_b]{ antichain.insert_if_not_subsumed(1, StateSet{ 2 }) };
+        CHECK(inserted_b);
+        CHECK(!antichain.is_alive(id_a));
+        CHECK(antichain.is_alive(id_b));
+        CHECK(antichain.size() == 1);
+
+        antichain.clear();
+        CHECK(antichain.empty());
+        CHECK(!antichain.is_subsumed(1, StateSet{ 2 }));
+    }
+
+    SECTION("Sets shared by elements with different keys")
+    {
+        const auto id_a{ antichain.insert(1, StateSet{ 3, 5, 7 }) };
+        const auto id_b{ antichain.insert(2, StateSet{ 3, 5, 7 }) };
+        CHECK(antichain.set_begin(id_a) == antichain.set_begin(id_b));
+        CHECK(antichain.set_end(id_b) - antichain.set_begin(id_b) == 3);
+        CHECK(antichain.get_set(id_b) == StateSet{ 3, 5, 7 });
+        CHECK(antichain.remove_subsumed(1, StateSet{ 5 }) == 1);
+        CHECK(antichain.is_subsumed(2, StateSet{ 3, 5, 7, 9 }));
+        CHECK(!antichain.is_subsumed(1, StateSet{ 3, 5, 7, 9 }));
+    }
+
+    SECTION("Large states hashing to the same signature bits")
+    {
+        antichain.insert(0, StateSet{ 64, 128 });
+        CHECK(!antichain.is_subsumed(0, StateSet{ 0, 64 }));
+        CHECK(antichain.is_subsumed(0, StateSet{ 0, 64, 128 }));
+        CHECK(antichain.remove_subsumed(0, StateSet{ 128 }) == 1);
+    }
+}
+
+TEST_CASE("Mata::Util::Antichain ordered up to a relation")
+{
+    // State 1 is simulated by 2, and 2 by 3.
+    const auto is_simulated = [](State p, State q) { return p == q || (p < q && q <= 3 && p >= 1); };
+    using SimulationOrder = ForallExistsOrder<decltype(is_simulated)>;
+    Antichain<State, StateSet, SimulationOrder> antichain{ SimulationOrder{ is_simulated } };
+
+    SECTION("Subsumption up to the relation")
+    {
+        antichain.insert(0, StateSet{ 1, 5 });
+        CHECK(antichain.is_subsumed(0, StateSet{ 1, 5 }));
+        // Sets which are not supersets, even with smaller cardinalities, can be subsumed.
+        CHECK(antichain.is_subsumed(0, StateSet{ 3, 5 }));
+        CHECK(antichain.is_subsumed(0, StateSet{ 2, 4, 5 }));
+        CHECK(!antichain.is_subsumed(0, StateSet{ 3 }));
+        CHECK(!antichain.is_subsumed(0, StateSet{ 0, 5 }));
+        CHECK(!antichain.is_subsumed(1, StateSet{ 3, 5 }));
+    }
+
+    SECTION("Removing subsumed elements up to the relation")
+    {
+        const auto id_a{ antichain.insert(0, StateSet{ 3 }) };
+        const auto id_b{ antichain.insert(0, StateSet{ 2, 4 }) };
+        const auto id_c{ antichain.insert(0, StateSet{ 0, 4 }) };
+        CHECK(antichain.remove_subsumed(0, StateSet{ 1 }) == 2);
+        CHECK(!antichain.is_alive(id_a));
+        CHECK(!antichain.is_alive(id_b));
+        CHECK(antichain.is_alive(id_c));
+
+        const auto [id_d, inserted]{ antichain.insert_if_not_subsumed(0, StateSet{ 0 }) };
+        CHECK(inserted);
+        CHECK(!antichain.is_alive(id_c));
+        CHECK(!antichain.insert_if_not_subsumed(0, StateSet{ 0, 2 }).second);
+        CHECK(antichain.size() == 1);
+        CHECK(antichain.is_alive(id_d));
+    }
+}
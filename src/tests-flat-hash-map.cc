@@ -0,0 +1,188 @@
+/* tests-flat-hash-map.cc -- Tests for open-addressing hash maps with flat storage
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "../3rdparty/catch.hpp"
+
+#include <mata/nfa.hh>
+#include <mata/flat-hash-map.hh>
+
+using namespace Mata::Util;
+using namespace Mata::Nfa;
+
+TEST_CASE("Mata::Util::FlatHashMap")
+{
+    FlatHashMap<std::pair<State, State>, State> map{};
+    CHECK(map.empty());
+    CHECK(map.find({ 0, 0 }) == map.end());
+
+    // Enough entries to rehash the table several times.
+    for (State lhs{ 0 }; lhs < 100; ++lhs) {
+        for (State rhs{ 0 }; rhs < 100; ++rhs) {
+            const auto [it, inserted]{ map.emplace({ lhs, rhs }, lhs * 100 + rhs) };
+            CHECK(inserted);
+            CHECK(it->second == lhs * 100 + rhs);
+        }
+    }
+    CHECK(map.size() == 10000);
+
+    const auto [it, inserted]{ map.emplace({ 42, 7 }, 0) };
+    CHECK(!inserted);
+    CHECK(it->second == 4207);
+    CHECK(map[{ 42, 7 }] == 4207);
+    map[{ 100, 100 }] = 1;
+    CHECK(map.size() == 10001);
+    CHECK(map.find({ 100, 101 }) == map.end());
+
+    // Entries are iterated in the order of insertion.
+    CHECK(map.begin()->first == std::make_pair(State{ 0 }, State{ 0 }));
+    CHECK((map.end() - 1)->first == std::make_pair(State{ 100 }, State{ 100 }));
+
+    std::unordered_map<std::pair<State, State>, State> std_map{ { { 1, 1 }, 1 } };
+    map.copy_to(std_map);
+    CHECK(std_map.size() == 10001);
+    CHECK(std_map.at({ 99, 3 }) == 9903);
+
+    SECTION("Moving entries to a standard map clears the map")
+    {
+        std_map.clear();
+        map.move_to(std_map);
+        CHECK(std_map.size() == 10001);
+        CHECK(std_map.at({ 99, 3 }) == 9903);
+        CHECK(map.empty());
+        CHECK(map.find({ 99, 3 }) == map.end());
+        CHECK(map.emplace({ 99, 3 }, 1).second);
+    }
+
+    map.clear();
+    CHECK(map.empty());
+    CHECK(map.find({ 42, 7 }) == map.end());
+    map.reserve(1000);
+    CHECK(map.emplace({ 42, 7 }, 1).second);
+}
+
+TEST_CASE("Mata::Util::MacrostateTable")
+{
+    MacrostateTable<State> table{};
+    CHECK(table.empty());
+    CHECK(table.find(StateSet{}) == MacrostateTable<State>::NONE);
+
+    CHECK(table.intern(StateSet{ 1, 2, 3 }) == std::make_pair(uint32_t{ 0 }, true));
+    CHECK(table.intern(StateSet{}) == std::make_pair(uint32_t{ 1 }, true));
+    CHECK(table.intern(StateSet{ 1, 2, 3 }) == std::make_pair(uint32_t{ 0 }, false));
+    const std::vector<State> buffer{ 1, 2 };
+    CHECK(table.intern(buffer.data(), buffer.data() + buffer.size()) == std::make_pair(uint32_t{ 2 }, true));
+    CHECK(table.size() == 3);
+
+    CHECK(table.find(StateSet{ 1, 2 }) == 2);
+    CHECK(table.find(StateSet{ 2, 3 }) == MacrostateTable<State>::NONE);
+    CHECK(table.get_set(0) == StateSet{ 1, 2, 3 });
+    CHECK(table.get_set(1).empty());
+    CHECK(table.set_size(0) == 3);
+    CHECK(table.end(2) - table.begin(2) == 2);
+    CHECK(table.hash(0) != table.hash(2));
+
+    // Enough sets to rehash the table several times.
+    for (State state{ 0 }; state < 1000; ++state) {
+        CHECK(table.intern(StateSet{ state, state + 2000 }).second);
+    }
+    CHECK(table.size() == 1003);
+    CHECK(table.find(StateSet{ 500, 2500 }) == 503);
+    CHECK(table.get_set(503) == StateSet{ 500, 2500 });
+    CHECK(table.find(StateSet{ 1, 2, 3 }) == 0);
+
+    SECTION("Draining the table")
+    {
+        // A set large enough to get a chunk of its own between sets in shared chunks.
+        std::vector<State> large(MacrostateTable<State>::MAX_CHUNK_SIZE);
+        for (State state{ 0 }; state < large.size(); ++state) { large[state] = state; }
+        CHECK(table.intern(large.data(), large.data() + large.size()) == std::make_pair(uint32_t{ 1003 }, true));
+        CHECK(table.intern(StateSet{ 7 }).second);
+
+        std::vector<StateSet> drained{};
+        table.drain([&](uint32_t id, const State* first, const State* last) {
+            CHECK(id == drained.size());
+            drained.emplace_back(std::vector<State>(first, last));
+        });
+        CHECK(drained.size() == 1005);
+        CHECK(drained[0] == StateSet{ 1, 2, 3 });
+        CHECK(drained[1].empty());
+        CHECK(drained[503] == StateSet{ 500, 2500 });
+        CHECK(drained[1003].size() == large.size());
+        CHECK(drained[1004] == StateSet{ 7 });
+        CHECK(table.empty());
+        CHECK(table.find(StateSet{ 7 }) == MacrostateTable<State>::NONE);
+        CHECK(table.intern(StateSet{ 7 }) == std::make_pair(uint32_t{ 0 }, true));
+    }
+
+    table.clear();
+    CHECK(table.empty());
+    CHECK(table.find(StateSet{ 1, 2, 3 }) == MacrostateTable<State>::NONE);
+    CHECK(table.intern(StateSet{ 4 }) == std::make_pair(uint32_t{ 0 }, true));
+}
+
+TEST_CASE("Mata::Util::FlatSetMap")
+{
+    FlatSetMap<State, State> map{};
+    CHECK(map.empty());
+    CHECK(map.find(StateSet{}) == nullptr);
+
+    CHECK(map.emplace(StateSet{ 1, 2, 3 }, 10) == std::make_pair(size_t{ 0 }, true));
+    CHECK(map.emplace(StateSet{}, 11) == std::make_pair(size_t{ 1 }, true));
+    CHECK(map.emplace(StateSet{ 1, 2 }, 12) == std::make_pair(size_t{ 2 }, true));
+    CHECK(map.emplace(StateSet{ 1, 2, 3 }, 13) == std::make_pair(size_t{ 0 }, false));
+    CHECK(map.size() == 3);
+
+    const std::vector<State> buffer{ 1, 2 };
+    REQUIRE(map.find(buffer.data(), buffer.data() + buffer.size()) != nullptr);
+    CHECK(*map.find(buffer.data(), buffer.data() + buffer.size()) == 12);
+    CHECK(*map.find(StateSet{}) == 11);
+    CHECK(map.find(StateSet{ 2, 3 }) == nullptr);
+    CHECK(map.get_key(0) == StateSet{ 1, 2, 3 });
+    CHECK(map.get_key(1).empty());
+    CHECK(map.key_end(2) - map.key_begin(2) == 2);
+    map.get_value(2) = 14;
+    CHECK(*map.find(StateSet{ 1, 2 }) == 14);
+
+    // Enough entries to rehash the table several times.
+    for (State state{ 0 }; state < 1000; ++state) {
+        CHECK(map.emplace(StateSet{ state, state + 2000 }, state).second);
+    }
+    CHECK(map.size() == 1003);
+    CHECK(*map.find(StateSet{ 500, 2500 }) == 500);
+
+    std::unordered_map<StateSet, State> std_map{};
+    map.copy_to(std_map);
+    CHECK(std_map.size() == 1003);
+    CHECK(std_map.at(StateSet{ 1, 2, 3 }) == 10);
+    CHECK(std_map.at(StateSet{}) == 11);
+
+    SECTION("Moving entries to a standard map clears the map")
+    {
+        std_map.clear();
+        map.move_to(std_map);
+        CHECK(std_map.size() == 1003);
+        CHECK(std_map.at(StateSet{ 1, 2, 3 }) == 10);
+        CHECK(std_map.at(StateSet{ 500, 2500 }) == 500);
+        CHECK(map.empty());
+        CHECK(map.find(StateSet{ 1, 2, 3 }) == nullptr);
+        CHECK(map.emplace(StateSet{ 4 }, 1) == std::make_pair(size_t{ 0 }, true));
+    }
+
+    map.clear();
+    CHECK(map.empty());
+    CHECK(map.find(StateSet{ 1, 2, 3 }) == nullptr);
+}
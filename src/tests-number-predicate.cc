@@ -84,3 +84,54 @@ TEST_CASE("Mata::Util::NumberPredicate") {
         }
     }
 }
+
+TEST_CASE("Mata::Util::NumberPredicate word operations") {
+    for (bool track: {true, false}) {
+        SECTION("union, intersection and difference "+std::to_string(track)) {
+            NumberPredicate<State> p({1, 63, 64, 200}, track);
+            NumberPredicate<State> q({2, 64, 130}, track);
+            CHECK(!p.are_disjoint(q));
+            CHECK(p.are_disjoint(NumberPredicate<State>({0, 65, 1000})));
+
+            NumberPredicate<State> intersection = p.intersection(q);
+            CHECK(intersection.size() == 1);
+            CHECK(intersection.get_elements() == std::vector<State>{64});
+
+            p.add_all(q);
+            CHECK(p.size() == 6);
+            CHECK(OrdVector<State>(p) == OrdVector<State>({1, 2, 63, 64, 130, 200}));
+            p.remove_all(q);
+            CHECK(p.size() == 3);
+            CHECK(OrdVector<State>(p) == OrdVector<State>({1, 63, 200}));
+            CHECK(p.are_disjoint(q));
+        }
+
+        SECTION("size and elements after removing and adding again "+std::to_string(track)) {
+            NumberPredicate<State> p({5, 70}, track);
+            p.remove(5);
+            p.add(5);
+            p.remove(6);
+            p.flip(70);
+            p.flip(71);
+            CHECK(p.size() == 2);
+            CHECK(p.get_elements().size() == 2);
+            CHECK(OrdVector<State>(p) == OrdVector<State>({5, 71}));
+            p.truncate_domain();
+            CHECK(p.domain_size() == 72);
+        }
+
+        SECTION("complement on word boundaries "+std::to_string(track)) {
+            NumberPredicate<State> p({0, 64}, track);
+            p.complement(128);
+            CHECK(p.size() == 126);
+            CHECK(!p[0]);
+            CHECK(!p[64]);
+            CHECK(p[127]);
+            p.complement(64);
+            CHECK(OrdVector<State>(p) == OrdVector<State>({0}));
+            CHECK(!p[100]);
+        }
+    }
+    CHECK(are_disjoint(StateSet{1, 3, 500}, NumberPredicate<State>{2, 4}));
+    CHECK(!are_disjoint(StateSet{1, 3, 500}, NumberPredicate<State>{3}));
+}
@@ -58,3 +58,20 @@ TEST_CASE("Mata::Util::OrdVector::intersection(}")
         REQUIRE(set1.intersection(set2).empty());
     }
 }
+
+TEST_CASE("Mata::Util::OrdVector::push_back()")
+{
+    using OrdVectorT = OrdVector<int>;
+    OrdVectorT set{};
+    set.reserve(3);
+    set.push_back(1);
+    set.push_back(4);
+    set.push_back(7);
+    REQUIRE(set == OrdVectorT{7, 4, 1});
+
+    OrdVectorT moved{std::move(set)};
+    REQUIRE(moved == OrdVectorT{1, 4, 7});
+    REQUIRE(set.empty());
+    set = std::move(moved);
+    REQUIRE(set == OrdVectorT{1, 4, 7});
+}
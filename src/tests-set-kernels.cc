@@ -0,0 +1,174 @@
+/* tests-set-kernels.cc -- Tests for the kernels of set operations over sorted arrays
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "../3rdparty/catch.hpp"
+
+#include <mata/nfa.hh>
+#include <mata/set-kernels.hh>
+#include <mata/util.hh>
+
+using namespace Mata::Util;
+using namespace Mata::Nfa;
+
+namespace {
+
+template<typename T>
+std::vector<T> random_set(std::mt19937& generator, const size_t size, const size_t universe) {
+    std::uniform_int_distribution<size_t> distribution{ 0, universe - 1 };
+    std::vector<T> set{};
+    for (size_t i{ 0 }; i < size; ++i) { set.push_back(static_cast<T>(distribution(generator))); }
+    std::sort(set.begin(), set.end());
+    set.erase(std::unique(set.begin(), set.end()), set.end());
+    return set;
+}
+
+template<typename T>
+void check_kernels(const std::vector<T>& lhs, const std::vector<T>& rhs) {
+    std::vector<T> expected{};
+    std::vector<T> result(lhs.size() + rhs.size());
+
+    std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+    result.resize(SetKernels::intersection(lhs.data(), lhs.size(), rhs.data(), rhs.size(), result.data()));
+    CHECK(result == expected);
+    CHECK(SetKernels::are_disjoint(lhs.data(), lhs.size(), rhs.data(), rhs.size()) == expected.empty());
+
+    expected.clear();
+    result.resize(lhs.size() + rhs.size());
+    std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+    result.resize(SetKernels::set_union(lhs.data(), lhs.size(), rhs.data(), rhs.size(), result.data()));
+    CHECK(result == expected);
+
+    expected.clear();
+    result.resize(lhs.size() + rhs.size());
+    std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+    result.resize(SetKernels::difference(lhs.data(), lhs.size(), rhs.data(), rhs.size(), result.data()));
+    CHECK(result == expected);
+
+    CHECK(SetKernels::is_subset(lhs.data(), lhs.size(), rhs.data(), rhs.size())
+          == std::includes(rhs.begin(), rhs.end(), lhs.begin(), lhs.end()));
+    CHECK(SetKernels::is_subset(rhs.data(), rhs.size(), lhs.data(), lhs.size())
+          == std::includes(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+}
+
+template<typename T>
+void check_kernels_on_random_sets() {
+    std::mt19937 generator{ 42 };
+    const std::vector<std::pair<size_t, size_t>> sizes{
+        { 0, 0 }, { 0, 5 }, { 1, 1 }, { 3, 7 }, { 4, 4 }, { 8, 9 }, { 17, 30 }, { 64, 64 }, { 100, 250 },
+        { 2, 500 }, { 10, 1000 }, { 1000, 3 },
+    };
+    for (const auto& size: sizes) {
+        for (const size_t universe: { size_t{ 8 }, size_t{ 64 }, size_t{ 4096 } }) {
+            for (size_t round{ 0 }; round < 20; ++round) {
+                const std::vector<T> lhs{ random_set<T>(generator, size.first, universe) };
+                const std::vector<T> rhs{ random_set<T>(generator, size.second, universe) };
+                check_kernels(lhs, rhs);
+                // Subsets and supersets.
+                std::vector<T> subset{};
+                for (size_t i{ 0 }; i < rhs.size(); ++i) {
+                    if (generator() % 8 != 0) { subset.push_back(rhs[i]); }
+                }
+                check_kernels(subset, rhs);
+                check_kernels(rhs, subset);
+                check_kernels(rhs, rhs);
+            }
+        }
+    }
+}
+
+} // namespace.
+
+TEST_CASE("Mata::Util::SetKernels::gallop()")
+{
+    const std::vector<int> data{ 1, 3, 5, 7, 9, 11, 13 };
+    CHECK(SetKernels::gallop(data.data(), 0, 5) == 0);
+    CHECK(SetKernels::gallop(data.data(), data.size(), 0) == 0);
+    CHECK(SetKernels::gallop(data.data(), data.size(), 1) == 0);
+    CHECK(SetKernels::gallop(data.data(), data.size(), 2) == 1);
+    CHECK(SetKernels::gallop(data.data(), data.size(), 7) == 3);
+    CHECK(SetKernels::gallop(data.data(), data.size(), 12) == 6);
+    CHECK(SetKernels::gallop(data.data(), data.size(), 13) == 6);
+    CHECK(SetKernels::gallop(data.data(), data.size(), 14) == 7);
+}
+
+TEST_CASE("Mata::Util::SetKernels on random sets")
+{
+    SECTION("32-bit elements") { check_kernels_on_random_sets<uint32_t>(); }
+    SECTION("64-bit elements") { check_kernels_on_random_sets<uint64_t>(); }
+    SECTION("Signed elements") { check_kernels_on_random_sets<int>(); }
+}
+
+TEST_CASE("Mata::Util::OrdVector with set kernels")
+{
+    const StateSet lhs{ 1, 2, 3, 4, 5, 6, 7, 8, 20 };
+    const StateSet rhs{ 2, 4, 6, 8, 10, 12, 14, 16, 18, 20 };
+    CHECK(lhs.intersection(rhs) == StateSet{ 2, 4, 6, 8, 20 });
+    CHECK(lhs.Union(rhs) == StateSet{ 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 18, 20 });
+    CHECK(lhs.difference(rhs) == StateSet{ 1, 3, 5, 7 });
+    CHECK(rhs.difference(lhs) == StateSet{ 10, 12, 14, 16, 18 });
+    CHECK(StateSet{ 2, 8, 20 }.IsSubsetOf(rhs));
+    CHECK(!lhs.IsSubsetOf(rhs));
+    CHECK(!are_disjoint(lhs, rhs));
+    CHECK(are_disjoint(StateSet{ 1, 3, 5 }, rhs));
+    CHECK(lhs.count(20) == 1);
+    CHECK(lhs.count(9) == 0);
+    CHECK(TargetSet{ 5, 10 }.difference(lhs) == StateSet{ 10 });
+    CHECK(are_disjoint(TargetSet{ 9, 11 }, lhs));
+
+    // Keys which are not trivially copyable use the generic algorithms.
+    const OrdVector<Move> moves{ Move{ 'a', 1 }, Move{ 'b', 2 } };
+    const OrdVector<Move> other_moves{ Move{ 'b', 3 }, Move{ 'c', 4 } };
+    CHECK(moves.intersection(other_moves).size() == 1);
+    CHECK(moves.Union(other_moves).size() == 3);
+    CHECK(moves.Union(other_moves).find(Move{ 'b' })->targets == StateSet{ 3 });
+    CHECK(moves.difference(other_moves).size() == 1);
+    CHECK(!moves.HaveEmptyIntersection(other_moves));
+}
+
+TEST_CASE("Mata::Util::SetKernels for profiling", "[.profiling][set_kernels]")
+{
+    // Sets of states as they appear in determinization and antichain algorithms: target sets of a few states, dense
+    //  macrostates over a small automaton, and small sets (e.g., final states of a successor) against large ones.
+    std::mt19937 generator{ 42 };
+    const struct { size_t lhs_size; size_t rhs_size; size_t universe; } distributions[]{
+        { 4, 4, 64 }, { 32, 32, 128 }, { 256, 256, 1024 }, { 8, 4096, 16384 },
+    };
+    size_t checksum{ 0 };
+    for (const auto& distribution: distributions) {
+        std::vector<StateSet> sets{};
+        for (size_t i{ 0 }; i < 256; ++i) {
+            const size_t size{ i % 2 == 0 ? distribution.lhs_size : distribution.rhs_size };
+            sets.emplace_back(random_set<State>(generator, size, distribution.universe));
+        }
+        for (size_t round{ 0 }; round < 20; ++round) {
+            for (size_t i{ 0 }; i + 1 < sets.size(); ++i) {
+                checksum += sets[i].intersection(sets[i + 1]).size();
+                checksum += sets[i].Union(sets[i + 1]).size();
+                checksum += sets[i].difference(sets[i + 1]).size();
+                checksum += sets[i].IsSubsetOf(sets[i + 1]);
+                checksum += are_disjoint(sets[i], sets[i + 1]);
+            }
+        }
+    }
+    CHECK(checksum > 0);
+}
@@ -0,0 +1,120 @@
+/* tests-small-vector.cc -- Tests for the vector with inline storage
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "../3rdparty/catch.hpp"
+
+#include <mata/nfa.hh>
+#include <mata/small-vector.hh>
+
+using namespace Mata::Util;
+using namespace Mata::Nfa;
+
+TEST_CASE("Mata::Util::SmallVector")
+{
+    using Vector = SmallVector<int, 2>;
+
+    SECTION("Inline storage spills to the heap")
+    {
+        Vector vec{};
+        CHECK(vec.empty());
+        vec.push_back(1);
+        vec.push_back(2);
+        CHECK(vec.is_inline());
+        vec.push_back(3);
+        CHECK(!vec.is_inline());
+        CHECK(vec.size() == 3);
+        CHECK(vec.capacity() >= 3);
+        CHECK(std::vector<int>(vec) == std::vector<int>{ 1, 2, 3 });
+        vec.clear();
+        CHECK(vec.empty());
+        vec.push_back(4);
+        CHECK(vec.back() == 4);
+    }
+
+    SECTION("Insert and erase")
+    {
+        Vector vec{ 1, 3 };
+        vec.insert(vec.begin() + 1, 2);
+        vec.insert(vec.begin(), 0);
+        vec.insert(vec.end(), 4);
+        CHECK(vec == Vector{ 0, 1, 2, 3, 4 });
+        vec.erase(vec.begin() + 1, vec.begin() + 3);
+        CHECK(vec == Vector{ 0, 3, 4 });
+        vec.erase(vec.begin());
+        CHECK(vec == Vector{ 3, 4 });
+        vec.resize(4, 7);
+        CHECK(vec == Vector{ 3, 4, 7, 7 });
+        vec.resize(1);
+        CHECK(vec == Vector{ 3 });
+        vec.push_back(vec.front());
+        CHECK(vec == Vector{ 3, 3 });
+        vec.push_back(vec[1]);
+        CHECK(vec == Vector{ 3, 3, 3 });
+    }
+
+    SECTION("Copy and move")
+    {
+        const Vector small{ 1 };
+        const Vector large{ 1, 2, 3, 4, 5 };
+        Vector copy{ small };
+        CHECK(copy == small);
+        copy = large;
+        CHECK(copy == large);
+        copy = small;
+        CHECK(copy == small);
+        CHECK(Vector{ small }.is_inline());
+
+        Vector moved{ std::move(copy) };
+        CHECK(moved == small);
+        CHECK(copy.empty());
+        Vector large_copy{ large };
+        moved = std::move(large_copy);
+        CHECK(moved == large);
+        CHECK(large_copy.empty());
+        CHECK(large_copy.is_inline());
+        CHECK(small < large);
+        CHECK(small != large);
+    }
+}
+
+TEST_CASE("Mata::Nfa::TargetSet")
+{
+    TargetSet targets{ 3, 1, 2, 1 };
+    CHECK(targets.size() == 3);
+    CHECK(targets.ToVector().is_inline());
+    targets.insert(0);
+    targets.insert(5);
+    targets.insert(4);
+    CHECK(!targets.ToVector().is_inline());
+    CHECK(targets == StateSet{ 0, 1, 2, 3, 4, 5 });
+
+    const StateSet state_set{ 1, 4, 7 };
+    CHECK(targets.intersection(state_set) == StateSet{ 1, 4 });
+    CHECK(state_set.Union(targets) == StateSet{ 0, 1, 2, 3, 4, 5, 7 });
+    CHECK(TargetSet{ 1, 4 }.IsSubsetOf(state_set));
+    CHECK(!TargetSet{ 1, 5 }.IsSubsetOf(state_set));
+    CHECK(TargetSet{ 0, 5 }.HaveEmptyIntersection(state_set));
+    CHECK(StateSet(targets) == StateSet{ 0, 1, 2, 3, 4, 5 });
+
+    Nfa aut{ 3 };
+    aut.delta.add(0, 'a', 1);
+    aut.delta.add(0, 'a', 2);
+    aut.delta.add(0, 'b', 2);
+    const Move& move{ *aut.delta[0].find(Move{ 'a' }) };
+    CHECK(move.targets == StateSet{ 1, 2 });
+    CHECK(move.targets.ToVector().is_inline());
+}
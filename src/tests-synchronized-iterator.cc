@@ -2,6 +2,10 @@
 // Created by Lukáš Holík on 29.10.2022.
 //
 
+#include <algorithm>
+#include <map>
+#include <random>
+
 #include "catch.hpp"
 
 #include <mata/util.hh>
@@ -60,6 +64,24 @@ TEST_CASE("Mata::Util::SynchronizedIterator")
         REQUIRE(*current[1] == 3);
         REQUIRE(*current[2] == 3);
         REQUIRE(!iu.advance());
+
+        iu.reset();
+
+        // Position[0] gets advanced while synchronizing a later position
+        v1 = {0, 1};
+        v2 = {0, 1};
+        v3 = {1};
+
+        push_back(iu,v1);
+        push_back(iu,v2);
+        push_back(iu,v3);
+
+        REQUIRE(iu.advance());
+        current = iu.get_current();
+        REQUIRE(*current[0] == 1);
+        REQUIRE(*current[1] == 1);
+        REQUIRE(*current[2] == 1);
+        REQUIRE(!iu.advance());
     }
 
     SECTION("synchronized_universal_iterator, corner cases") {
@@ -204,4 +226,35 @@ TEST_CASE("Mata::Util::SynchronizedIterator")
         REQUIRE(*current[2]==2);
         REQUIRE(!ie.advance());
     }
+
+    SECTION("SynchronizedExistentialIterator, many positions")
+    {
+        std::mt19937 generator{ 42 };
+        std::uniform_int_distribution<int> value_distribution{ 0, 40 };
+        SynchronizedExistentialIterator<OrdVector<int>::const_iterator> ie;
+        // Both below and above LINEAR_ADVANCE_LIMIT (8), reusing the iterator after reset.
+        for (const size_t num_of_vectors: { size_t{ 3 }, size_t{ 9 }, size_t{ 100 }, size_t{ 5 }, size_t{ 60 } }) {
+            std::vector<OrdVector<int>> vectors(num_of_vectors);
+            std::map<int, size_t> occurrences{};
+            for (OrdVector<int>& vector: vectors) {
+                for (size_t i{ 0 }; i < num_of_vectors % 7 * 3; ++i) { vector.insert(value_distribution(generator)); }
+                for (const int value: vector) { ++occurrences[value]; }
+            }
+
+            ie.reset();
+            for (const OrdVector<int>& vector: vectors) { push_back(ie, vector); }
+            for (const auto& value_occurrences: occurrences) {
+                REQUIRE(ie.advance());
+                REQUIRE(ie.is_synchronized());
+                const std::vector<OrdVector<int>::const_iterator>& current{ ie.get_current() };
+                CHECK(current.size() == value_occurrences.second);
+                CHECK(std::all_of(current.begin(), current.end(), [&](OrdVector<int>::const_iterator position) {
+                    return *position == value_occurrences.first;
+                }));
+                CHECK(*ie.get_current_minimum() == value_occurrences.first);
+            }
+            CHECK(!ie.advance());
+            CHECK(ie.get_current().empty());
+        }
+    }
 }
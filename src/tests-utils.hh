@@ -0,0 +1,64 @@
+/* tests-utils.hh -- Random automata and words shared by tests
+ *
+ * Copyright (c) 2022
+ *
+ * This file is a part of libmata.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef MATA_TESTS_UTILS_HH_
+#define MATA_TESTS_UTILS_HH_
+
+#include <random>
+#include <vector>
+
+#include <mata/nfa.hh>
+
+namespace Mata {
+namespace Tests {
+
+/**
+ * Random automaton in the Tabakov-Vardi model: @p density * @p num_of_states transitions over every symbol of
+ *  @p symbols between uniformly chosen states.
+ * @param num_of_initial Number of uniformly chosen initial states (they may repeat).
+ * @param num_of_final Number of uniformly chosen final states (they may repeat).
+ */
+inline Mata::Nfa::Nfa random_aut(std::mt19937& generator, const Mata::Nfa::State num_of_states,
+                                 const std::vector<Mata::Nfa::Symbol>& symbols, const size_t density = 2,
+                                 const size_t num_of_initial = 1, const size_t num_of_final = 1) {
+    Mata::Nfa::Nfa aut{ num_of_states };
+    std::uniform_int_distribution<Mata::Nfa::State> state_distribution{ 0, num_of_states - 1 };
+    for (size_t i{ 0 }; i < num_of_initial; ++i) { aut.initial.add(state_distribution(generator)); }
+    for (size_t i{ 0 }; i < num_of_final; ++i) { aut.final.add(state_distribution(generator)); }
+    for (const Mata::Nfa::Symbol symbol: symbols) {
+        for (size_t i{ 0 }; i < density * num_of_states; ++i) {
+            aut.delta.add(state_distribution(generator), symbol, state_distribution(generator));
+        }
+    }
+    return aut;
+}
+
+/// Random word of at most @p max_length symbols chosen uniformly from @p symbols.
+inline Mata::Nfa::Run random_word(std::mt19937& generator, const std::vector<Mata::Nfa::Symbol>& symbols,
+                                  const size_t max_length) {
+    std::uniform_int_distribution<size_t> symbol_distribution{ 0, symbols.size() - 1 };
+    Mata::Nfa::Run word{};
+    for (size_t length{ generator() % (max_length + 1) }; length > 0; --length) {
+        word.word.push_back(symbols[symbol_distribution(generator)]);
+    }
+    return word;
+}
+
+} // namespace Tests.
+} // namespace Mata.
+
+#endif // MATA_TESTS_UTILS_HH_